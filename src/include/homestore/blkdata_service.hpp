@@ -37,6 +37,8 @@ class VirtualDev;
 struct vdev_info;
 struct stream_info_t;
 class BlkReadTracker;
+class BlkDataCache;
+class BlkDataCompressor;
 struct blk_alloc_hints;
 class ChunkSelector;
 
@@ -86,6 +88,10 @@ public:
     /**
      * @brief Asynchronously allocates and writes data to a block device using the provided scatter-gather list.
      *
+     * If data compression is turned on (generic config data_compression) and the data compresses by at least a block,
+     * fewer blocks are allocated and the data is stored compressed. Such blocks have to be read as a whole, with the
+     * size of the sgs, and are decompressed transparently by async_read.
+     *
      * @param sgs The scatter-gather list containing the data to write.
      * @param hints Hints for allocating the block(s) to write to.
      * @param out_blkids The ID(s) of the block(s) that were allocated and written to.
@@ -133,6 +139,10 @@ public:
     /**
      * @brief Asynchronously reads data from the specified block ID into the provided buffer.
      *
+     * If size is larger than the blocks of the block ID, they were written compressed by async_alloc_write and are
+     * decompressed into the buffer. Reading a compressed extent with less than its original size fails with
+     * invalid_argument.
+     *
      * @param bid The ID of the block to read from.
      * @param buf The buffer to read data into.
      * @param size The number of bytes to read.
@@ -145,6 +155,10 @@ public:
     /**
      * @brief Asynchronously reads data from the specified block ID.
      *
+     * If size is larger than the blocks of the block ID, they were written compressed by async_alloc_write and are
+     * decompressed into the scatter-gather list. Reading a compressed extent with less than its original size fails
+     * with invalid_argument.
+     *
      * @param bid The block ID to read from.
      * @param sgs The scatter-gather list to store the read data.
      * @param size The size of the data to read.
@@ -295,9 +309,46 @@ private:
      */
     static void process_data_completion(std::error_condition ec, void* cookie);
 
+    /**
+     * @brief Drops all the blocks of the given block IDs from the data cache, if it is enabled.
+     *
+     * @param bids The block IDs being freed.
+     */
+    void drop_from_data_cache(MultiBlkId const& bids);
+
+    /**
+     * @brief Reads the blocks of the given block IDs as they are on the device, through the data cache.
+     *
+     * @param bids The block IDs to read.
+     * @param buf The buffer to read the data into.
+     * @param size The number of bytes to read.
+     * @param part_of_batch Whether this read is part of a batch.
+     */
+    folly::Future< std::error_code > async_read_raw(MultiBlkId const& bids, uint8_t* buf, uint32_t size,
+                                                    bool part_of_batch);
+
+    /**
+     * @brief Same as above, reading into the scatter-gather list.
+     */
+    folly::Future< std::error_code > async_read_raw(MultiBlkId const& bids, sisl::sg_list& sgs, uint32_t size,
+                                                    bool part_of_batch);
+
+    /**
+     * @brief Reads the compressed extent of the given block IDs and decompresses it into the iovs.
+     *
+     * @param bids The block IDs of the compressed extent.
+     * @param iovs The buffers to read the data into.
+     * @param size The original size of the data.
+     * @param part_of_batch Whether this read is part of a batch.
+     */
+    folly::Future< std::error_code > async_read_compressed(MultiBlkId const& bids, sisl::sg_iovs_t iovs, uint32_t size,
+                                                           bool part_of_batch);
+
 private:
     std::shared_ptr< VirtualDev > m_vdev;
     std::unique_ptr< BlkReadTracker > m_blk_read_tracker;
+    std::unique_ptr< BlkDataCache > m_data_cache; // nullptr if the data cache is disabled
+    std::unique_ptr< BlkDataCompressor > m_data_compressor;
     std::shared_ptr< ChunkSelector > m_custom_chunk_selector;
     uint32_t m_blk_size;
 
@@ -17,6 +17,8 @@
 
 #include <atomic>
 #include <array>
+#include <mutex>
+#include <set>
 
 #include <boost/intrusive_ptr.hpp>
 #include <folly/small_vector.h>
@@ -34,6 +36,9 @@ namespace homestore {
 using BtreeNodePtr = boost::intrusive_ptr< BtreeNode >;
 using BtreeNodeList = folly::small_vector< BtreeNodePtr, 3 >;
 
+template < typename K, typename V >
+class BtreeCursor;
+
 struct BtreeVisualizeVariables {
     uint64_t parent;
     uint64_t midPoint;
@@ -73,6 +78,8 @@ struct BTREE_FLIPS {
 
 template < typename K, typename V >
 class Btree {
+    friend class BtreeCursor< K, V >;
+
 protected:
     mutable iomgr::FiberManagerLib::shared_mutex m_btree_lock;
     BtreeLinkInfo m_root_node_info;
@@ -82,6 +89,7 @@ protected:
     std::atomic< uint64_t > m_total_leaf_nodes{0};
     std::atomic< uint64_t > m_total_interior_nodes{0};
     std::atomic< uint8_t > m_btree_depth{0};
+    mutable std::atomic< uint32_t > m_optimistic_readers{0}; // Lookups in do_optimistic_get right now
     uint32_t m_node_size{4096};
 #ifndef NDEBUG
     std::atomic< uint64_t > m_req_id{0};
@@ -102,6 +110,18 @@ protected:
 protected:
     BtreeConfig m_bt_cfg;
 
+    // Underfull nodes found by removes when merges are lazy, identified by their level and a key routing to them
+    struct MergeCandidate {
+        uint16_t level{0};
+        K key;
+
+        bool operator<(MergeCandidate const& other) const {
+            return (level != other.level) ? (level < other.level) : (key.compare(other.key) < 0);
+        }
+    };
+    mutable std::mutex m_merge_candidates_mtx;
+    std::set< MergeCandidate > m_merge_candidates;
+
 public:
     /////////////////////////////////////// All External APIs /////////////////////////////
     Btree(const BtreeConfig& cfg);
@@ -118,6 +138,24 @@ public:
 
     btree_status_t query(BtreeQueryRequest< K >& query_req, std::vector< std::pair< K, V > >& out_values) const;
 
+    // Cursor positioned on the first entry of the range, which streams the entries in place from the leaves instead of
+    // copying them out page by page. Check is_valid() on the returned cursor for an empty range.
+    BtreeCursor< K, V > cursor(BtreeKeyRange< K > range) const;
+
+    // Build an empty btree bottom-up from [begin, end), iterators over std::pair< K, V > in strictly ascending key
+    // order, packing each node up to fill_pct percent (0 means the configured ideal fill pct). The new tree replaces
+    // the empty root in one go with the given context at the end, or is dropped entirely leaving the btree empty on
+    // failure.
+    // Its nodes are handed over in transactions of at most bulk_load_txn_nodes new nodes.
+    static constexpr uint32_t bulk_load_txn_nodes{128};
+    template < typename IterT >
+    btree_status_t bulk_load(IterT begin, IterT end, uint8_t fill_pct, void* context);
+
+    // Merge the next underfull node recorded by removes, when m_lazy_merge is set. Returns not_found if there are no
+    // more of them and merge_not_required if the node does not need a merge anymore.
+    btree_status_t merge_next_candidate(void* context);
+    size_t num_merge_candidates() const;
+
     // bool verify_tree(bool update_debug_bm) const;
     virtual std::pair< btree_status_t, uint64_t > destroy_btree(void* context);
     nlohmann::json get_status(int log_level) const;
@@ -154,6 +192,12 @@ protected:
     virtual BtreeNodePtr alloc_node(bool is_leaf) = 0;
     virtual BtreeNode* init_node(uint8_t* node_buf, bnodeid_t id, bool init_buf, bool is_leaf) const;
     virtual btree_status_t read_node_impl(bnodeid_t id, BtreeNodePtr& node) const = 0;
+    // Get the node only if the store has it at hand, without any IO or cache insert, for lookups which do not hold the
+    // parent lock and so could be holding the id of a node freed meanwhile. Default is not_found, in which case the
+    // lookup takes the locked path.
+    virtual btree_status_t read_cached_node_impl(bnodeid_t id, BtreeNodePtr& node) const {
+        return btree_status_t::not_found;
+    }
     virtual btree_status_t write_node_impl(const BtreeNodePtr& node, void* context) = 0;
     virtual btree_status_t refresh_node(const BtreeNodePtr& node, bool for_read_modify_write, void* context) const = 0;
     virtual void free_node_impl(const BtreeNodePtr& node, void* context) = 0;
@@ -161,8 +205,17 @@ protected:
                                           const BtreeNodePtr& left_child_node, const BtreeNodePtr& parent_node,
                                           void* context) = 0;
     virtual btree_status_t on_root_changed(BtreeNodePtr const& root, void* context) = 0;
+
+    // Whether a range remove can unlink the subtrees it covers fully, see drop_subtrees. The sibling relinks below the
+    // parent and the frees of the dropped descendants are not journaled, so only stores which aren't recovered after
+    // a crash can do it.
+    virtual bool can_drop_subtrees() const { return false; }
     virtual std::string btree_store_type() const = 0;
 
+    // Hint that the given nodes are going to be read soon. Stores which read nodes from a device can start loading
+    // them asynchronously; it is a no-op for in-memory stores.
+    virtual void prefetch_nodes(std::vector< bnodeid_t > const& node_ids) const {}
+
     /////////////////////////// Methods the application use case is expected to handle ///////////////////////////
 
 protected:
@@ -203,8 +256,10 @@ protected:
     btree_status_t post_order_traversal(locktype_t acq_lock, const auto& cb);
     btree_status_t post_order_traversal(const BtreeNodePtr& node, locktype_t acq_lock, const auto& cb);
     void get_all_kvs(std::vector< std::pair< K, V > >& kvs) const;
+    void visit_keys(std::function< void(K const&) > const& cb);
     btree_status_t do_destroy(uint64_t& n_freed_nodes, void* context);
     void get_child_node_count(bnodeid_t bnodeid, uint64_t& interior_cnt, uint64_t& leaf_cnt) const;
+    void get_fill_stats(bnodeid_t bnodeid, std::array< uint64_t, 4 >& stats) const;
     void to_string(bnodeid_t bnodeid, std::string& buf) const;
     void to_custom_string_internal(bnodeid_t bnodeid, std::string& buf, to_string_cb_t< K, V > const& cb,
                                    int nindent = -1) const;
@@ -236,10 +291,23 @@ protected:
     template < typename ReqT >
     bool is_split_needed(const BtreeNodePtr& node, ReqT& req) const;
 
+    template < typename ReqT >
+    int8_t split_edge(const BtreeNodePtr& node, ReqT& req) const;
+
+    template < typename ReqT >
+    void record_edge_insert(const BtreeNodePtr& node, ReqT& req) const;
+
     btree_status_t split_node(const BtreeNodePtr& parent_node, const BtreeNodePtr& child_node, uint32_t parent_ind,
-                              K* out_split_key, void* context);
+                              K* out_split_key, void* context, int8_t insert_edge = 0);
     btree_status_t mutate_extents_in_leaf(const BtreeNodePtr& my_node, BtreeRangePutRequest< K >& rpreq);
 
+    ///////// Bulk Load Impl Methods
+    bool bulk_load_has_room(const BtreeNodePtr& node, uint32_t key_size, uint32_t value_size, uint8_t fill_pct) const;
+    btree_status_t bulk_load_append_node(std::vector< BtreeNodePtr >& spine, uint32_t level, const BtreeNodePtr& node,
+                                         uint8_t fill_pct, std::vector< BtreeNodePtr >& nodes);
+    btree_status_t bulk_load_install(const BtreeNodePtr& new_root, const std::vector< BtreeNodePtr >& nodes,
+                                     const BtreeNodePtr& old_root, void* context);
+
     ///////// Remove Impl Methods
     template < typename ReqT >
     btree_status_t check_collapse_root(ReqT& rreq);
@@ -250,8 +318,17 @@ protected:
     btree_status_t merge_nodes(const BtreeNodePtr& parent_node, const BtreeNodePtr& leftmost_node, uint32_t start_indx,
                                uint32_t end_indx, void* context);
     bool remove_extents_in_leaf(const BtreeNodePtr& node, BtreeRangeRemoveRequest< K >& rrreq);
+    void add_merge_candidate(const BtreeNodePtr& parent_node, uint32_t child_idx, const BtreeNodePtr& child_node);
+    btree_status_t merge_candidate(MergeCandidate const& candidate, void* context, bool& collapse_root);
+    uint32_t num_droppable_children(const BtreeNodePtr& node, uint32_t start_idx, uint32_t end_idx,
+                                    BtreeRangeRemoveRequest< K > const& rrreq) const;
+    btree_status_t drop_subtrees(const BtreeNodePtr& parent_node, uint32_t start_idx, uint32_t end_idx,
+                                 void* context);
+    void free_subtree_below(const BtreeNodePtr& node, void* context);
 
     ///////// Query Impl Methods
+    void read_ahead_children(const BtreeNodePtr& node, uint32_t start_idx, uint32_t end_idx,
+                             BtreeQueryRequest< K > const& qreq) const;
     btree_status_t do_sweep_query(BtreeNodePtr& my_node, BtreeQueryRequest< K >& qreq,
                                   std::vector< std::pair< K, V > >& out_values) const;
     btree_status_t do_traversal_query(const BtreeNodePtr& my_node, BtreeQueryRequest< K >& qreq,
@@ -267,5 +344,6 @@ protected:
     ///////// Get Impl Methods
     template < typename ReqT >
     btree_status_t do_get(const BtreeNodePtr& my_node, ReqT& greq) const;
+    btree_status_t do_optimistic_get(BtreeSingleGetRequest& greq) const;
 };
 } // namespace homestore
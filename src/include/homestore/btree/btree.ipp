@@ -26,12 +26,15 @@
 #include <sisl/fds/buffer.hpp>
 
 #include <homestore/btree/btree.hpp>
+#include <homestore/btree/btree_cursor.hpp>
 #include <homestore/btree/detail/btree_common.ipp>
 #include <homestore/btree/detail/btree_node_mgr.ipp>
 #include <homestore/btree/detail/btree_mutate_impl.ipp>
 #include <homestore/btree/detail/btree_query_impl.ipp>
 #include <homestore/btree/detail/btree_get_impl.ipp>
 #include <homestore/btree/detail/btree_remove_impl.ipp>
+#include <homestore/btree/detail/btree_bulk_load_impl.ipp>
+#include <homestore/btree/detail/btree_cursor_impl.ipp>
 #include <homestore/btree/detail/btree_node.hpp>
 
 namespace homestore {
@@ -82,7 +85,8 @@ std::pair< btree_status_t, uint64_t > Btree< K, V >::destroy_btree(void* context
 template < typename K, typename V >
 template < typename ReqT >
 btree_status_t Btree< K, V >::put(ReqT& put_req) {
-    static_assert(std::is_same_v< ReqT, BtreeSinglePutRequest > || std::is_same_v< ReqT, BtreeRangePutRequest< K > >,
+    static_assert(std::is_same_v< ReqT, BtreeSinglePutRequest > || std::is_same_v< ReqT, BtreeRangePutRequest< K > > ||
+                      std::is_same_v< ReqT, BtreeMultiPutRequest< K > >,
                   "put api is called with non put request type");
     COUNTER_INCREMENT(m_metrics, btree_write_ops_count, 1);
     auto acq_lock = locktype_t::READ;
@@ -99,6 +103,10 @@ retry:
     BT_LOG_ASSERT_EQ(bt_thread_vars()->wr_locked_nodes.size(), 0);
 
     BtreeNodePtr root;
+    if constexpr (std::is_same_v< ReqT, BtreeMultiPutRequest< K > >) {
+        if (put_req.is_done()) { goto out; }
+        put_req.reset_upper_bound();
+    }
     ret = read_and_lock_node(m_root_node_info.bnode_id(), root, acq_lock, acq_lock, put_req.m_op_context);
     if (ret != btree_status_t::success) { goto out; }
     is_leaf = root->is_leaf();
@@ -160,6 +168,15 @@ btree_status_t Btree< K, V >::get(ReqT& greq) const {
     m_btree_lock.lock_shared();
     BtreeNodePtr root;
 
+    if constexpr (std::is_same_v< BtreeSingleGetRequest, ReqT >) {
+        if (m_bt_cfg.m_optimistic_read) {
+            m_optimistic_readers.fetch_add(1);
+            ret = do_optimistic_get(greq);
+            m_optimistic_readers.fetch_sub(1);
+            if (ret != btree_status_t::retry) { goto out; }
+        }
+    }
+
     ret = read_and_lock_node(m_root_node_info.bnode_id(), root, locktype_t::READ, locktype_t::READ, greq.m_op_context);
     if (ret != btree_status_t::success) { goto out; }
 
@@ -178,7 +195,8 @@ template < typename ReqT >
 btree_status_t Btree< K, V >::remove(ReqT& req) {
     static_assert(std::is_same_v< ReqT, BtreeSingleRemoveRequest > ||
                       std::is_same_v< ReqT, BtreeRangeRemoveRequest< K > > ||
-                      std::is_same_v< ReqT, BtreeRemoveAnyRequest< K > >,
+                      std::is_same_v< ReqT, BtreeRemoveAnyRequest< K > > ||
+                      std::is_same_v< ReqT, BtreeMultiRemoveRequest< K > >,
                   "remove api is called with non remove request type");
     COUNTER_INCREMENT(m_metrics, btree_remove_ops_count, 1);
     locktype_t acq_lock = locktype_t::READ;
@@ -187,6 +205,13 @@ btree_status_t Btree< K, V >::remove(ReqT& req) {
 retry:
     btree_status_t ret = btree_status_t::success;
     BtreeNodePtr root;
+    if constexpr (std::is_same_v< ReqT, BtreeMultiRemoveRequest< K > >) {
+        if (req.is_done()) {
+            m_btree_lock.unlock_shared();
+            goto out;
+        }
+        req.reset_upper_bound();
+    }
     ret = read_and_lock_node(m_root_node_info.bnode_id(), root, acq_lock, acq_lock, req.m_op_context);
     if (ret != btree_status_t::success) { goto out; }
 
@@ -231,6 +256,10 @@ out:
 #ifndef NDEBUG
     check_lock_debug();
 #endif
+    if constexpr (std::is_same_v< ReqT, BtreeMultiRemoveRequest< K > >) {
+        // Keys which were not found are reported through the per key status
+        if (ret == btree_status_t::not_found) { ret = btree_status_t::success; }
+    }
     return ret;
 }
 
@@ -284,6 +313,14 @@ out:
     return ret;
 }
 
+template < typename K, typename V >
+BtreeCursor< K, V > Btree< K, V >::cursor(BtreeKeyRange< K > range) const {
+    COUNTER_INCREMENT(m_metrics, btree_query_ops_count, 1);
+    BtreeCursor< K, V > cur{this, std::move(range)};
+    cur.seek_to_first();
+    return cur;
+}
+
 #if 0
 /**
  * @brief : verify btree is consistent and no corruption;
@@ -306,13 +343,33 @@ bool Btree< K, V >::verify_tree(bool update_debug_bm) const {
 /**
  * @brief : get the status of this btree;
  *
- * @param log_level : verbosity level;
+ * @param log_level : verbosity level; from level 2 onwards it also reports how full the nodes are, which reads every
+ * node of the tree under its read lock, so it is as costly as a full scan
  *
  * @return : status in json form;
  */
 template < typename K, typename V >
 nlohmann::json Btree< K, V >::get_status(int log_level) const {
     nlohmann::json j;
+    j["name"] = m_bt_cfg.name();
+    j["depth"] = m_btree_depth.load();
+    j["leaf_nodes"] = m_total_leaf_nodes.load();
+    j["interior_nodes"] = m_total_interior_nodes.load();
+    j["split_policy"] = enum_name(m_bt_cfg.m_split_policy);
+
+    if (log_level >= 2) {
+        // Filled and total data size of leaf nodes, followed by the same for interior nodes
+        std::array< uint64_t, 4 > stats{0, 0, 0, 0};
+        m_btree_lock.lock_shared();
+        if (m_root_node_info.bnode_id() != empty_bnodeid) { get_fill_stats(m_root_node_info.bnode_id(), stats); }
+        m_btree_lock.unlock_shared();
+
+        auto const fill_pct = [](uint64_t filled, uint64_t total) -> double {
+            return total ? (filled * 100.0) / total : 0.0;
+        };
+        j["leaf_fill_factor_pct"] = fill_pct(stats[0], stats[1]);
+        j["interior_fill_factor_pct"] = fill_pct(stats[2], stats[3]);
+    }
     return j;
 }
 
@@ -0,0 +1,88 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <optional>
+
+#include <homestore/btree/btree.hpp>
+
+namespace homestore {
+
+/*
+ * Cursor over the entries of a key range in the btree. Unlike query, which copies the entries of a page into the
+ * output vector, the cursor reads the key and value in place from the leaf it is positioned on, so a consumer can
+ * stream through a large range without materializing it.
+ *
+ * A positioned cursor holds the read lock of its leaf: writers to that leaf wait until the cursor moves past it or is
+ * released. Hence the cursor is meant to be short lived and the owner should not modify the same btree from the same
+ * fiber while the cursor is positioned. Moving forward lock couples to the next leaf through the sibling chain, while
+ * moving backwards across a leaf boundary and seeking walk down from the root again.
+ */
+template < typename K, typename V >
+class BtreeCursor {
+public:
+    BtreeCursor(Btree< K, V > const* bt, BtreeKeyRange< K > range) : m_bt{bt}, m_range{std::move(range)} {}
+    BtreeCursor(BtreeCursor const&) = delete;
+    BtreeCursor& operator=(BtreeCursor const&) = delete;
+    BtreeCursor(BtreeCursor&& other) noexcept;
+    BtreeCursor& operator=(BtreeCursor&& other) noexcept;
+    ~BtreeCursor() { release(); }
+
+    /// @brief Position on the first entry of the range. Returns false if there is no entry in the range.
+    bool seek_to_first() { return seek(m_range.start_key(), m_range.is_start_inclusive()); }
+
+    /// @brief Position on the last entry of the range. Returns false if there is no entry in the range.
+    bool seek_to_last() { return seek_for_prev(m_range.end_key(), m_range.is_end_inclusive()); }
+
+    /// @brief Position on the first entry of the range which is >= seek_key (> seek_key if not inclusive)
+    bool seek(K const& seek_key, bool inclusive = true);
+
+    /// @brief Position on the last entry of the range which is <= seek_key (< seek_key if not inclusive)
+    bool seek_for_prev(K const& seek_key, bool inclusive = true);
+
+    /// @brief Move to the next/previous entry. Returns false and releases the cursor once it moves out of the range.
+    bool next();
+    bool prev();
+
+    bool is_valid() const { return (m_leaf != nullptr); }
+
+    /// @brief Key and value of the entry the cursor is positioned on. They are read from the node without copy, so
+    /// for keys/values which refer to the node buffer, they are valid only until the cursor is moved or released.
+    K key() const;
+    V value() const;
+
+    /// @brief Status of the last node read, which tells a cursor invalidated by a read failure from one which simply
+    /// reached the end of the range.
+    btree_status_t status() const { return m_status; }
+
+    /// @brief Unlock the leaf the cursor is positioned on. The cursor can be positioned again with any of the seeks.
+    void release();
+
+private:
+    BtreeNodePtr descend(K const& target, std::optional< K >* left_bound);
+    bool move_to_next_leaf();
+    bool settle_forward();
+    bool is_before_start(K const& k) const;
+    bool is_past_end(K const& k) const;
+
+private:
+    Btree< K, V > const* m_bt;
+    BtreeKeyRange< K > m_range;
+    BtreeNodePtr m_leaf;
+    uint32_t m_idx{0};
+    btree_status_t m_status{btree_status_t::success};
+};
+} // namespace homestore
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <fmt/format.h>
 #include <sisl/fds/buffer.hpp>
@@ -60,6 +61,35 @@ public:
     virtual bool is_interval_key() const { return false; }
 };
 
+// A fixed size key can opt into a faster, branchless search within fixed size nodes by declaring
+//      using integral_key_t = <integer type>;
+// Doing so, the key promises that its serialized form is exactly that integer in native byte order and that compare()
+// orders the keys the same way as the integers are ordered.
+template < typename K, typename = void >
+struct is_integral_btree_key : std::false_type {};
+
+template < typename K >
+struct is_integral_btree_key< K, std::void_t< typename K::integral_key_t > >
+        : std::bool_constant< std::is_integral_v< typename K::integral_key_t > > {};
+
+template < typename K >
+inline constexpr bool is_integral_btree_key_v = is_integral_btree_key< K >::value;
+
+// A variable size key can let the VAR_PREFIX interior nodes keep truncated separators by declaring
+//      using bytewise_key_t = std::true_type;
+// Doing so, the key promises that compare() orders the keys the same way as comparing their serialized forms byte by
+// byte does (a key being ordered before the keys it is a prefix of) and that it can deserialize any non empty prefix of
+// its serialized form.
+template < typename K, typename = void >
+struct is_bytewise_btree_key : std::false_type {};
+
+template < typename K >
+struct is_bytewise_btree_key< K, std::void_t< typename K::bytewise_key_t > >
+        : std::bool_constant< K::bytewise_key_t::value > {};
+
+template < typename K >
+inline constexpr bool is_bytewise_btree_key_v = is_bytewise_btree_key< K >::value;
+
 // An extension of BtreeKey where each key is part of an interval range. Keys are not neccessarily only needs to be
 // integers, but it needs to be able to get next or prev key from a given key in the key range
 class BtreeIntervalKey : public BtreeKey {
@@ -14,6 +14,8 @@
  *
  *********************************************************************************/
 #pragma once
+#include <algorithm>
+#include <optional>
 #include <sisl/fds/buffer.hpp>
 #include <homestore/btree/btree_kv.hpp>
 
@@ -79,6 +81,53 @@ private:
     uint32_t m_batch_size{1};
 };
 
+// Base class for operations on a batch of individual keys. Keys are processed in sorted order, so that all the keys
+// which belong to the same leaf node are handled with one walk down the tree and one write lock on that leaf. Outcome
+// of each key is available in status(), indexed by the position of the key in the batch as passed by the caller.
+template < typename K >
+struct BtreeMultiKeyRequest : public BtreeRequest {
+public:
+    uint32_t num_keys() const { return s_cast< uint32_t >(m_keys.size()); }
+    btree_status_t status(uint32_t i) const { return m_statuses[i]; }
+    std::vector< btree_status_t > const& statuses() const { return m_statuses; }
+    const K& nth_key(uint32_t i) const { return *m_keys[i]; }
+
+    ///////////// Internal methods used by the btree while processing the batch /////////////
+    bool is_done() const { return m_cursor == m_order.size(); }
+    uint32_t cur_index() const { return m_order[m_cursor]; }
+    const K& key() const { return *m_keys[cur_index()]; }
+
+    void complete_cur_key(btree_status_t status) {
+        m_statuses[cur_index()] = status;
+        ++m_cursor;
+    }
+
+    // Upper bound of keys the node being descended into covers, nullopt if it is unbounded (edge of the tree)
+    void reset_upper_bound() { m_upper_bound.reset(); }
+    void set_upper_bound(K&& key) { m_upper_bound = std::move(key); }
+    bool is_cur_key_within_bound() const { return !m_upper_bound || (key().compare(*m_upper_bound) <= 0); }
+
+protected:
+    BtreeMultiKeyRequest(std::vector< const K* > keys, btree_status_t initial_status, void* app_context) :
+            BtreeRequest{app_context, nullptr},
+            m_keys{std::move(keys)},
+            m_order(m_keys.size()),
+            m_statuses(m_keys.size(), initial_status) {
+        for (uint32_t i{0}; i < m_order.size(); ++i) {
+            m_order[i] = i;
+        }
+        std::stable_sort(m_order.begin(), m_order.end(),
+                         [this](uint32_t a, uint32_t b) { return m_keys[a]->compare(*m_keys[b]) < 0; });
+    }
+
+private:
+    std::vector< const K* > m_keys;
+    std::vector< uint32_t > m_order;
+    std::vector< btree_status_t > m_statuses;
+    uint32_t m_cursor{0};
+    std::optional< K > m_upper_bound;
+};
+
 /////////////////////////// 1: Put Operations /////////////////////////////////////
 ENUM(put_filter_decision, uint8_t, keep, replace, remove);
 using put_filter_cb_t = std::function< put_filter_decision(BtreeKey const&, BtreeValue const&, BtreeValue const&) >;
@@ -115,6 +164,25 @@ public:
     put_filter_cb_t m_filter_cb;
 };
 
+template < typename K >
+struct BtreeMultiPutRequest : public BtreeMultiKeyRequest< K > {
+public:
+    BtreeMultiPutRequest(std::vector< const K* > keys, std::vector< const BtreeValue* > values,
+                         btree_put_type put_type, put_filter_cb_t filter_cb = nullptr, void* app_context = nullptr) :
+            BtreeMultiKeyRequest< K >{std::move(keys), btree_status_t::retry /* not attempted */, app_context},
+            m_values{std::move(values)},
+            m_put_type{put_type},
+            m_filter_cb{std::move(filter_cb)} {
+        DEBUG_ASSERT_EQ(m_values.size(), this->num_keys(), "Number of keys and values in multi put do not match");
+    }
+
+    const BtreeValue& value() const { return *m_values[this->cur_index()]; }
+
+    std::vector< const BtreeValue* > m_values;
+    const btree_put_type m_put_type;
+    put_filter_cb_t m_filter_cb;
+};
+
 /////////////////////////// 2: Remove Operations /////////////////////////////////////
 struct BtreeSingleRemoveRequest : public BtreeRequest {
 public:
@@ -138,6 +206,21 @@ public:
     BtreeValue* m_outval;
 };
 
+// Removes a batch of keys, status of a key is not_found if it did not exist. If out_vals is provided (same size as
+// keys) the removed value of each key is copied to it.
+template < typename K >
+struct BtreeMultiRemoveRequest : public BtreeMultiKeyRequest< K > {
+public:
+    BtreeMultiRemoveRequest(std::vector< const K* > keys, std::vector< BtreeValue* > out_vals = {},
+                            void* app_context = nullptr) :
+            BtreeMultiKeyRequest< K >{std::move(keys), btree_status_t::not_found, app_context},
+            m_outvals{std::move(out_vals)} {}
+
+    BtreeValue* outval() const { return m_outvals.empty() ? nullptr : m_outvals[this->cur_index()]; }
+
+    std::vector< BtreeValue* > m_outvals;
+};
+
 using remove_filter_cb_t = std::function< bool(BtreeKey const&, BtreeValue const&) >;
 
 template < typename K >
@@ -216,9 +299,15 @@ public:
 
     get_filter_cb_t const& filter() const { return m_filter_cb; }
 
+    // Number of nodes ahead of the one being read, which the query asks the store to load in the background. 0 disables
+    // read ahead.
+    uint32_t read_ahead() const { return m_read_ahead; }
+    void set_read_ahead(uint32_t nnodes) { m_read_ahead = nnodes; }
+
 protected:
     const BtreeQueryType m_query_type; // Type of the query
     get_filter_cb_t m_filter_cb;
+    uint32_t m_read_ahead{8};
 };
 
 /* This class is a top level class to keep track of the locks that are held currently. It is
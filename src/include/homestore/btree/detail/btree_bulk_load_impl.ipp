@@ -0,0 +1,184 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+#include <homestore/btree/btree.hpp>
+
+namespace homestore {
+
+/*
+ * Bulk load builds the tree bottom-up instead of inserting one key at a time from the root. It keeps the right most
+ * node of every level (the spine) and only ever appends to it:
+ *
+ * 1. Keys are appended to the right most leaf until it is filled up to fill_pct. The leaf is then sealed and a new
+ *    leaf is chained to it through next_bnode.
+ * 2. A sealed node is added to its parent with its last key and the new node becomes the edge of the parent, which
+ *    is the same layout a split of the edge child produces. If the parent is full, it is sealed as well, dropping the
+ *    edge, and the sealed child moves along with the new node to a new parent appended to the level above. Sealing the
+ *    top of the spine adds a new level above it.
+ *
+ * The whole tree is built off to the side, out of new nodes only, while the existing (empty) root stays as it is. Once
+ * all of the input is in, the top of the spine is installed as the new root and the rest of the nodes are handed to the
+ * store below it, freeing the old root, all with the same context. So the store persists the loaded tree as a whole or
+ * not at all. On any failure, including an input which turns out to be unsorted in the middle, every node built so far
+ * is freed and the btree is left empty as it was, so the caller can retry the load.
+ *
+ * Bulk load is allowed only on an empty tree and holds the btree lock exclusively for its duration.
+ */
+template < typename K, typename V >
+template < typename IterT >
+btree_status_t Btree< K, V >::bulk_load(IterT begin, IterT end, uint8_t fill_pct, void* context) {
+    if ((fill_pct == 0) || (fill_pct > 100)) { fill_pct = m_bt_cfg.m_ideal_fill_pct; }
+
+    std::unique_lock lg(m_btree_lock);
+    BtreeNodePtr root;
+    auto ret = read_and_lock_node(m_root_node_info.bnode_id(), root, locktype_t::WRITE, locktype_t::WRITE, context);
+    if (ret != btree_status_t::success) { return ret; }
+
+    if (!root->is_leaf() || (root->total_entries() != 0)) {
+        BT_LOG(ERROR, "Bulk load is supported only on an empty btree, root node={}", root->to_string());
+        unlock_node(root, locktype_t::WRITE);
+        return btree_status_t::not_supported;
+    }
+
+    // All the nodes of the new tree in the order of their allocation and the right most node of every level of it,
+    // leaf first and root last
+    std::vector< BtreeNodePtr > nodes;
+    std::vector< BtreeNodePtr > spine;
+    uint64_t nkeys{0};
+    K prev_key;
+    for (auto it = begin; it != end; ++it) {
+        K const& key = it->first;
+        V const& value = it->second;
+        if ((nkeys != 0) && (key.compare(prev_key) <= 0)) {
+            BT_LOG(ERROR, "Bulk load input is not sorted or has duplicates, key={} after key={}", key.to_string(),
+                   prev_key.to_string());
+            ret = btree_status_t::not_supported;
+            break;
+        }
+
+        if (spine.empty() || !bulk_load_has_room(spine[0], key.serialized_size(), value.serialized_size(), fill_pct)) {
+            auto leaf = alloc_leaf_node();
+            if (leaf == nullptr) {
+                ret = btree_status_t::space_not_avail;
+                break;
+            }
+            leaf->set_level(0u);
+            nodes.push_back(leaf);
+            if (spine.empty()) {
+                spine.push_back(leaf);
+            } else {
+                ret = bulk_load_append_node(spine, 0u, leaf, fill_pct, nodes);
+                if (ret != btree_status_t::success) { break; }
+            }
+        }
+        spine[0]->insert(spine[0]->total_entries(), key, value);
+        prev_key = key;
+        ++nkeys;
+    }
+
+    if ((ret == btree_status_t::success) && !spine.empty()) {
+        ret = bulk_load_install(spine.back(), nodes, root, context);
+    }
+
+    BT_LOG(INFO, "Bulk load of {} keys into nodes={} depth={} fill_pct={} status={}", nkeys, nodes.size(),
+           m_btree_depth.load(), fill_pct, ret);
+    if ((ret != btree_status_t::success) || spine.empty()) {
+        // Nothing of the new tree was handed to the store, so it is dropped as a whole and the old root stays
+        for (auto const& node : nodes) {
+            free_node(node, locktype_t::NONE, context);
+        }
+        unlock_node(root, locktype_t::WRITE);
+    }
+    return ret;
+}
+
+template < typename K, typename V >
+bool Btree< K, V >::bulk_load_has_room(const BtreeNodePtr& node, uint32_t key_size, uint32_t value_size,
+                                       uint8_t fill_pct) const {
+    if (!node->has_room_for_put(btree_put_type::INSERT, key_size, value_size)) { return false; }
+    if (node->total_entries() == 0) { return true; }
+    uint32_t const filled = node->node_data_size() - node->available_size() + key_size + value_size;
+    return (filled * 100) <= (node->node_data_size() * fill_pct);
+}
+
+// Seal the spine node at the given level and append the new node to its right, which takes its place on the spine. The
+// parents allocated on the way are added to nodes, so that they are freed along with the rest if the load fails.
+template < typename K, typename V >
+btree_status_t Btree< K, V >::bulk_load_append_node(std::vector< BtreeNodePtr >& spine, uint32_t level,
+                                                    const BtreeNodePtr& node, uint8_t fill_pct,
+                                                    std::vector< BtreeNodePtr >& nodes) {
+    BtreeNodePtr const sealed = spine[level];
+    K const sealed_key = sealed->get_last_key< K >();
+    BtreeNodePtr parent;
+
+    if (level + 1 == spine.size()) {
+        // Sealing the top of the spine, grow the tree by a level the same way a root split does
+        parent = alloc_interior_node();
+        if (parent == nullptr) { return btree_status_t::space_not_avail; }
+        parent->set_level(level + 1);
+        nodes.push_back(parent);
+        spine.push_back(parent);
+    } else if (bulk_load_has_room(spine[level + 1], sealed_key.serialized_size(), BtreeLinkInfo::get_fixed_size(),
+                                  fill_pct)) {
+        parent = spine[level + 1];
+    } else {
+        // Parent is full as well. Its edge, the sealed node, moves to a new parent appended to the level above
+        parent = alloc_interior_node();
+        if (parent == nullptr) { return btree_status_t::space_not_avail; }
+        parent->set_level(level + 1);
+        nodes.push_back(parent);
+        spine[level + 1]->invalidate_edge();
+        auto const ret = bulk_load_append_node(spine, level + 1, parent, fill_pct, nodes);
+        if (ret != btree_status_t::success) { return ret; }
+    }
+
+    sealed->set_next_bnode(node->node_id());
+    parent->insert(parent->total_entries(), sealed_key, sealed->link_info());
+    parent->set_edge_value(node->link_info());
+    spine[level] = node;
+    return btree_status_t::success;
+}
+
+// Install the tree built by bulk load in place of the empty old root. The new root is installed first, so that the rest
+// of the nodes, handed to the store in transactions of at most bulk_load_txn_nodes new nodes each, are linked below it.
+// The last of them frees the old root, which unlocks it. Nothing is handed to the store if it fails.
+template < typename K, typename V >
+btree_status_t Btree< K, V >::bulk_load_install(const BtreeNodePtr& new_root,
+                                                const std::vector< BtreeNodePtr >& nodes, const BtreeNodePtr& old_root,
+                                                void* context) {
+    auto ret = write_node(new_root, context);
+    if (ret != btree_status_t::success) { return ret; }
+    ret = on_root_changed(new_root, context);
+    if (ret != btree_status_t::success) { return ret; }
+    m_root_node_info = new_root->link_info();
+    m_btree_depth = new_root->level();
+    COUNTER_INCREMENT(m_metrics, btree_depth, new_root->level());
+
+    BtreeNodeList batch;
+    for (auto const& node : nodes) {
+        if (node == new_root) { continue; }
+        batch.push_back(node);
+        if (batch.size() == bulk_load_txn_nodes) {
+            ret = transact_nodes(batch, {}, new_root, nullptr, context);
+            BT_REL_ASSERT_EQ(ret, btree_status_t::success, "Bulk load failed to transact nodes below the new root");
+            batch.clear();
+        }
+    }
+    ret = transact_nodes(batch, {old_root}, new_root, nullptr, context);
+    BT_REL_ASSERT_EQ(ret, btree_status_t::success, "Bulk load failed to transact nodes below the new root");
+    return ret;
+}
+} // namespace homestore
@@ -85,6 +85,18 @@ void Btree< K, V >::get_all_kvs(std::vector< std::pair< K, V > >& kvs) const {
     });
 }
 
+template < typename K, typename V >
+void Btree< K, V >::visit_keys(std::function< void(K const&) > const& cb) {
+    post_order_traversal(locktype_t::READ, [&cb](const auto& node, bool is_leaf) -> btree_status_t {
+        if (is_leaf) {
+            for (uint32_t i{0}; i < node->total_entries(); ++i) {
+                cb(node->template get_nth_key< K >(i, false /* copy */));
+            }
+        }
+        return btree_status_t::success;
+    });
+}
+
 template < typename K, typename V >
 btree_status_t Btree< K, V >::do_destroy(uint64_t& n_freed_nodes, void* context) {
     return post_order_traversal(locktype_t::WRITE,
@@ -148,6 +160,29 @@ void Btree< K, V >::get_child_node_count(bnodeid_t bnodeid, uint64_t& interior_c
     return ;
 }
 
+template < typename K, typename V >
+void Btree< K, V >::get_fill_stats(bnodeid_t bnodeid, std::array< uint64_t, 4 >& stats) const {
+    BtreeNodePtr node;
+    locktype_t acq_lock = locktype_t::READ;
+
+    if (read_and_lock_node(bnodeid, node, acq_lock, acq_lock, nullptr) != btree_status_t::success) { return; }
+    auto const filled = node->node_data_size() - node->available_size();
+    if (node->is_leaf()) {
+        stats[0] += filled;
+        stats[1] += node->node_data_size();
+    } else {
+        stats[2] += filled;
+        stats[3] += node->node_data_size();
+        for (uint32_t i{0}; i < node->total_entries(); ++i) {
+            BtreeLinkInfo p;
+            node->get_nth_value(i, &p, false);
+            get_fill_stats(p.bnode_id(), stats);
+        }
+        if (node->has_valid_edge()) { get_fill_stats(node->edge_id(), stats); }
+    }
+    unlock_node(node, acq_lock);
+}
+
 template < typename K, typename V >
 void Btree< K, V >::to_string(bnodeid_t bnodeid, std::string& buf) const {
     BtreeNodePtr node;
@@ -0,0 +1,224 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+#include <homestore/btree/btree.hpp>
+#include <homestore/btree/btree_cursor.hpp>
+
+namespace homestore {
+
+/*
+ * The leaf lock a cursor parks on is taken directly on the node instead of through lock_node(). The lock tracking
+ * behind lock_node() is per fiber and expects all locks to be released by the end of each btree call, whereas a
+ * cursor keeps its leaf locked across calls.
+ */
+template < typename K, typename V >
+BtreeCursor< K, V >::BtreeCursor(BtreeCursor&& other) noexcept :
+        m_bt{other.m_bt},
+        m_range{std::move(other.m_range)},
+        m_leaf{std::move(other.m_leaf)},
+        m_idx{other.m_idx},
+        m_status{other.m_status} {
+    other.m_leaf = nullptr;
+}
+
+template < typename K, typename V >
+BtreeCursor< K, V >& BtreeCursor< K, V >::operator=(BtreeCursor&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_bt = other.m_bt;
+        m_range = std::move(other.m_range);
+        m_leaf = std::move(other.m_leaf);
+        m_idx = other.m_idx;
+        m_status = other.m_status;
+        other.m_leaf = nullptr;
+    }
+    return *this;
+}
+
+template < typename K, typename V >
+void BtreeCursor< K, V >::release() {
+    if (m_leaf) {
+        m_leaf->unlock(locktype_t::READ);
+        m_leaf = nullptr;
+    }
+}
+
+template < typename K, typename V >
+K BtreeCursor< K, V >::key() const {
+    DEBUG_ASSERT(is_valid(), "Accessing key of an unpositioned btree cursor");
+    return m_leaf->template get_nth_key< K >(m_idx, false /* copy */);
+}
+
+template < typename K, typename V >
+V BtreeCursor< K, V >::value() const {
+    DEBUG_ASSERT(is_valid(), "Accessing value of an unpositioned btree cursor");
+    V val;
+    m_leaf->get_nth_value(m_idx, &val, false /* copy */);
+    return val;
+}
+
+template < typename K, typename V >
+bool BtreeCursor< K, V >::seek(K const& seek_key, bool inclusive) {
+    release();
+    K const* target = &seek_key;
+    if (is_before_start(seek_key)) {
+        target = &m_range.start_key();
+        inclusive = m_range.is_start_inclusive();
+    }
+
+    m_leaf = descend(*target, nullptr);
+    if (m_leaf == nullptr) { return false; }
+
+    auto const [found, idx] = m_leaf->find(*target, nullptr, false);
+    m_idx = (found && !inclusive) ? idx + 1 : idx;
+    return settle_forward();
+}
+
+template < typename K, typename V >
+bool BtreeCursor< K, V >::seek_for_prev(K const& seek_key, bool inclusive) {
+    release();
+    K target = seek_key;
+    bool target_incl = inclusive;
+    if (is_past_end(seek_key)) {
+        target = m_range.end_key();
+        target_incl = m_range.is_end_inclusive();
+    }
+
+    while (true) {
+        // The left bound is the key of the parent entry just before the subtree we descend into, so everything
+        // which is smaller than the keys of the leaf we land on is <= left bound.
+        std::optional< K > left_bound;
+        m_leaf = descend(target, &left_bound);
+        if (m_leaf == nullptr) { return false; }
+
+        auto const [found, idx] = m_leaf->find(target, nullptr, false);
+        if (found && target_incl) {
+            m_idx = idx;
+            break;
+        } else if (idx > 0) {
+            m_idx = idx - 1;
+            break;
+        }
+
+        // Nothing in this leaf is before the target, look in the subtree to its left
+        release();
+        if (!left_bound) { return false; }
+        target = std::move(*left_bound);
+        target_incl = true;
+    }
+
+    if (is_before_start(key())) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+template < typename K, typename V >
+bool BtreeCursor< K, V >::next() {
+    if (!is_valid()) { return false; }
+    ++m_idx;
+    return settle_forward();
+}
+
+template < typename K, typename V >
+bool BtreeCursor< K, V >::prev() {
+    if (!is_valid()) { return false; }
+    if (m_idx > 0) {
+        --m_idx;
+        if (!is_before_start(key())) { return true; }
+        release();
+        return false;
+    }
+
+    // Leaves are linked only in the forward direction, so find the previous entry from the root. The leaf lock is
+    // given up before walking down, since holding it while locking from the top could deadlock with a writer.
+    K const first_key = m_leaf->template get_nth_key< K >(0, true /* copy */);
+    return seek_for_prev(first_key, false /* inclusive */);
+}
+
+template < typename K, typename V >
+BtreeNodePtr BtreeCursor< K, V >::descend(K const& target, std::optional< K >* left_bound) {
+    std::shared_lock lg(m_bt->m_btree_lock);
+    BtreeNodePtr node;
+    m_status = m_bt->read_node_impl(m_bt->m_root_node_info.bnode_id(), node);
+    if (m_status != btree_status_t::success) { return nullptr; }
+    node->lock(locktype_t::READ);
+
+    while (!node->is_leaf()) {
+        BtreeLinkInfo child_info;
+        auto const [found, idx] = node->find(target, &child_info, false);
+        if (left_bound && (idx > 0)) { *left_bound = node->template get_nth_key< K >(idx - 1, true /* copy */); }
+
+        BtreeNodePtr child;
+        m_status = m_bt->read_node_impl(child_info.bnode_id(), child);
+        if (m_status != btree_status_t::success) {
+            node->unlock(locktype_t::READ);
+            return nullptr;
+        }
+        child->lock(locktype_t::READ);
+        node->unlock(locktype_t::READ);
+        node = std::move(child);
+    }
+    return node;
+}
+
+template < typename K, typename V >
+bool BtreeCursor< K, V >::move_to_next_leaf() {
+    auto const next_id = m_leaf->next_bnode();
+    if (next_id == empty_bnodeid) {
+        release();
+        return false;
+    }
+
+    BtreeNodePtr next_leaf;
+    m_status = m_bt->read_node_impl(next_id, next_leaf);
+    if (m_status != btree_status_t::success) {
+        release();
+        return false;
+    }
+    next_leaf->lock(locktype_t::READ);
+    m_leaf->unlock(locktype_t::READ);
+    m_leaf = std::move(next_leaf);
+    m_idx = 0;
+    return true;
+}
+
+template < typename K, typename V >
+bool BtreeCursor< K, V >::settle_forward() {
+    while (m_idx >= m_leaf->total_entries()) {
+        if (!move_to_next_leaf()) { return false; }
+    }
+
+    if (is_past_end(key())) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+template < typename K, typename V >
+bool BtreeCursor< K, V >::is_before_start(K const& k) const {
+    auto const x = k.compare(m_range.start_key());
+    return (x < 0) || ((x == 0) && !m_range.is_start_inclusive());
+}
+
+template < typename K, typename V >
+bool BtreeCursor< K, V >::is_past_end(K const& k) const {
+    auto const x = k.compare(m_range.end_key());
+    return (x > 0) || ((x == 0) && !m_range.is_end_inclusive());
+}
+} // namespace homestore
@@ -61,4 +61,74 @@ out:
     unlock_node(my_node, locktype_t::READ);
     return ret;
 }
+
+/*
+ * Lookup without taking any node locks (optimistic lock coupling). Each node is read after noting its lock version
+ * and the version is validated after the read; the child is moved to only after validating the parent once more after
+ * noting the child's version, which ensures the child was still linked to the parent (and hence not freed) at that
+ * point. If a node is being written or was written meanwhile, the lookup is restarted from the root.
+ *
+ * Nodes are only taken from the store's cache (read_cached_node_impl), since a node id read without the parent lock
+ * could be of a freed node. Returns retry if the lookup could not be done this way (node type does not support it,
+ * node not in cache, too many restarts etc), in which case the caller takes the regular locked path. Caller is
+ * expected to hold the btree lock in shared mode and to count itself in m_optimistic_readers.
+ */
+template < typename K, typename V >
+btree_status_t Btree< K, V >::do_optimistic_get(BtreeSingleGetRequest& greq) const {
+    static constexpr uint32_t max_attempts = 4;
+    size_t const trace_start = greq.route_tracing ? greq.route_tracing->size() : 0;
+
+    for (uint32_t attempt{0}; attempt < max_attempts; ++attempt) {
+        if (attempt != 0) {
+            COUNTER_INCREMENT(m_metrics, btree_optimistic_read_restarts, 1);
+            if (greq.route_tracing) { greq.route_tracing->resize(trace_start); }
+        }
+
+        BtreeNodePtr node;
+        if ((read_cached_node_impl(m_root_node_info.bnode_id(), node) != btree_status_t::success) ||
+            (node == nullptr)) {
+            goto fallback; // Not in cache, let the locked path read it
+        }
+
+        auto version = node->lock_version();
+        while (!BtreeNode::is_write_locked_version(version)) {
+            if (node->is_leaf()) {
+                auto const ret = node->find_unlocked(greq.key(), greq.m_outval);
+                if (!ret) { goto fallback; }
+                bool const deleted = node->is_node_deleted();
+                if (!node->validate_lock_version(version)) { break; }
+                if (deleted) { goto fallback; }
+
+                if (ret->first) { append_route_trace(greq, node, btree_event_t::READ, ret->second, ret->second); }
+                return ret->first ? btree_status_t::success : btree_status_t::not_found;
+            }
+
+            BtreeLinkInfo child_info;
+            auto const ret = node->find_unlocked(greq.key(), &child_info);
+            if (!ret) { goto fallback; }
+            bool const deleted = node->is_node_deleted();
+            if (!node->validate_lock_version(version)) { break; }
+            if (deleted || (child_info.bnode_id() == empty_bnodeid)) { goto fallback; }
+            append_route_trace(greq, node, btree_event_t::READ, ret->second, ret->second);
+
+            // The child could have been freed since the parent was read, so it is only looked up in the cache: reading
+            // it from the device would bring a freed (or reallocated) node into the cache.
+            BtreeNodePtr child_node;
+            if ((read_cached_node_impl(child_info.bnode_id(), child_node) != btree_status_t::success) ||
+                (child_node == nullptr)) {
+                goto fallback;
+            }
+            auto const child_version = child_node->lock_version();
+            if (!node->validate_lock_version(version)) { break; }
+
+            node = std::move(child_node);
+            version = child_version;
+        }
+    }
+
+fallback:
+    COUNTER_INCREMENT(m_metrics, btree_optimistic_read_fallbacks, 1);
+    if (greq.route_tracing) { greq.route_tracing->resize(trace_start); }
+    return btree_status_t::retry;
+}
 } // namespace homestore
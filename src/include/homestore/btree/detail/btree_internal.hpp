@@ -194,7 +194,16 @@ using bnodeid_t = uint64_t;
 static constexpr bnodeid_t empty_bnodeid = std::numeric_limits< bnodeid_t >::max();
 static constexpr uint16_t bt_init_crc_16 = 0x8005;
 
-VENUM(btree_node_type, uint32_t, FIXED = 0, VAR_VALUE = 1, VAR_KEY = 2, VAR_OBJECT = 3, PREFIX = 4, COMPACT = 5)
+VENUM(btree_node_type, uint32_t, FIXED = 0, VAR_VALUE = 1, VAR_KEY = 2, VAR_OBJECT = 3, PREFIX = 4, COMPACT = 5,
+      VAR_PREFIX = 6)
+
+// How a full node divides its entries with the new right sibling on split:
+// EVEN     - Moves m_split_pct of the node to the right sibling, irrespective of where the insert lands
+// EDGE     - If the insert lands past the last key of the node, only (100 - m_edge_split_pct) is moved out, so that the
+//            left node stays nearly full for append only keys (timestamps, lsns). Inverse for an insert before the
+//            first key. Otherwise same as EVEN.
+// ADAPTIVE - Same as EDGE, but only once the node has seen m_sequential_run_len inserts in a row on that edge
+VENUM(btree_split_policy, uint8_t, EVEN = 0, EDGE = 1, ADAPTIVE = 2)
 
 #ifdef USE_STORE_TYPE
 VENUM(btree_store_type, uint8_t, MEM = 0, SSD = 1)
@@ -242,6 +251,9 @@ struct BtreeConfig {
     uint8_t m_ideal_fill_pct{90};
     uint8_t m_suggested_min_pct{30};
     uint8_t m_split_pct{50};
+    btree_split_policy m_split_policy{btree_split_policy::EVEN};
+    uint8_t m_edge_split_pct{90};    // Pct of the node kept in it, when it splits on an insert at the edge
+    uint8_t m_sequential_run_len{8}; // Inserts on the same edge in a row, for adaptive policy to split at the edge
     uint32_t m_max_merge_nodes{3};
 #ifdef _PRERELEASE
     // These are for testing purpose only
@@ -255,6 +267,14 @@ struct BtreeConfig {
     std::string m_btree_name; // Unique name for the btree
     bool m_merge_turned_on{true};
     uint8_t m_max_merge_level{1};
+    // Unlink the subtrees a range remove covers fully, instead of removing their keys. Only honored by the stores which
+    // are not recovered after a crash (see Btree::can_drop_subtrees), others remove the keys one leaf at a time.
+    bool m_drop_subtrees{false};
+    bool m_lazy_merge{false};   // Removes only record the underfull nodes, merged later by merge_next_candidate()
+    uint32_t m_max_merge_candidates{4096}; // Underfull nodes beyond these many are left unmerged
+    bool m_optimistic_read{true}; // Lookups without node locks, on node types which support it (see find_unlocked)
+    uint32_t m_bloom_filter_size{0};        // Memory for the IndexTable filter of point lookups, 0 disables it
+    uint8_t m_bloom_filter_rebuild_pct{50}; // Rebuild the filter once removed keys are this pct of the keys in it
 
 private:
     uint32_t m_suggested_min_size; // Precomputed values
@@ -275,7 +295,17 @@ public:
         m_suggested_min_size = (uint32_t)(m_node_data_size * m_suggested_min_pct) / 100;
     }
 
-    uint32_t split_size(uint32_t filled_size) const { return uint32_cast(filled_size * m_split_pct) / 100; }
+    /// @brief Size to move out to the new right node on split. insert_edge is 1 if the insert causing the split lands
+    /// past the last key of the node, -1 if it lands before the first key and 0 otherwise.
+    uint32_t split_size(uint32_t filled_size, int8_t insert_edge = 0) const {
+        uint32_t pct = m_split_pct;
+        if (insert_edge > 0) {
+            pct = 100u - m_edge_split_pct;
+        } else if (insert_edge < 0) {
+            pct = m_edge_split_pct;
+        }
+        return uint32_cast(filled_size * pct) / 100;
+    }
     uint32_t ideal_fill_size() const { return m_ideal_fill_size; }
     uint32_t suggested_min_size() const { return m_suggested_min_size; }
     uint32_t node_data_size() const { return m_node_data_size; }
@@ -305,6 +335,8 @@ public:
                          {"node_type", "interior"}, _publish_as::publish_as_gauge);
         REGISTER_COUNTER(btree_split_count, "Total number of btree node splits");
         REGISTER_COUNTER(btree_merge_count, "Total number of btree node merges");
+        REGISTER_COUNTER(btree_subtree_drop_count, "Total number of subtrees dropped whole by range removes");
+        REGISTER_COUNTER(btree_merge_candidate_count, "Total number of underfull nodes recorded for lazy merge");
         REGISTER_COUNTER(btree_depth, "Depth of btree", _publish_as::publish_as_gauge);
 
         REGISTER_COUNTER(btree_int_node_writes, "Total number of btree interior node writes", "btree_node_writes",
@@ -323,6 +355,13 @@ public:
         REGISTER_COUNTER(btree_write_ops_count, "number of btree operations");
         REGISTER_COUNTER(btree_query_ops_count, "number of btree operations");
         REGISTER_COUNTER(btree_remove_ops_count, "number of btree operations");
+        REGISTER_COUNTER(btree_optimistic_read_restarts, "number of lock free lookups restarted on version change");
+        REGISTER_COUNTER(btree_optimistic_read_fallbacks, "number of lock free lookups which took the locked path");
+        REGISTER_COUNTER(btree_read_ahead_nodes, "number of nodes queries asked the store to read ahead");
+        REGISTER_COUNTER(btree_bloom_filter_negatives, "number of point lookups answered not found by bloom filter");
+        REGISTER_COUNTER(btree_bloom_filter_false_positives,
+                         "number of point lookups passed by bloom filter but not found");
+        REGISTER_COUNTER(btree_bloom_filter_rebuilds, "number of rebuilds of bloom filter");
         REGISTER_HISTOGRAM(btree_exclusive_time_in_int_node,
                            "Exclusive time spent (Write locked) on interior node (ns)", "btree_exclusive_time_in_node",
                            {"node_type", "interior"}, HistogramBucketsType(OpLatecyBuckets));
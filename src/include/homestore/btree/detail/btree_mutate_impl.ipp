@@ -59,7 +59,8 @@ retry:
             ret = btree_status_t::not_found;
             goto out;
         }
-    } else if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest >) {
+    } else if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest > ||
+                         std::is_same_v< ReqT, BtreeMultiPutRequest< K > >) {
         auto const [found, idx] = my_node->find(req.key(), nullptr, true);
         ASSERT_IS_VALID_INTERIOR_CHILD_INDX(found, idx, my_node);
         end_idx = start_idx = idx;
@@ -101,7 +102,8 @@ retry:
 
             K split_key;
             BT_NODE_LOG(TRACE, my_node, "Split node needed");
-            ret = split_node(my_node, child_node, curr_idx, &split_key, req.m_op_context);
+            ret = split_node(my_node, child_node, curr_idx, &split_key, req.m_op_context,
+                             split_edge(child_node, req));
             unlock_lambda(child_node, child_cur_lock);
             if (ret != btree_status_t::success) { goto out; }
 
@@ -127,6 +129,11 @@ retry:
             }
         }
 
+        if constexpr (std::is_same_v< ReqT, BtreeMultiPutRequest< K > >) {
+            // Narrow down the keys of the batch this child covers, the edge child inherits the bound of this node
+            if (curr_idx < my_node->total_entries()) { req.set_upper_bound(my_node->get_nth_key< K >(curr_idx, true)); }
+        }
+
 #ifndef NDEBUG
         K ckey, pkey;
         if (curr_idx != my_node->total_entries()) { // not edge
@@ -172,6 +179,7 @@ template < typename K, typename V >
 template < typename ReqT >
 btree_status_t Btree< K, V >::mutate_write_leaf_node(const BtreeNodePtr& my_node, ReqT& req) {
     btree_status_t ret = btree_status_t::success;
+    record_edge_insert(my_node, req);
     if constexpr (std::is_same_v< ReqT, BtreeRangePutRequest< K > >) {
         K last_failed_key;
         ret = to_variant_node(my_node)->multi_put(req.working_range(), req.input_range().start_key(), *req.m_newval,
@@ -185,6 +193,28 @@ btree_status_t Btree< K, V >::mutate_write_leaf_node(const BtreeNodePtr& my_node
         ret =
             to_variant_node(my_node)->put(req.key(), req.value(), req.m_put_type, req.m_existing_val, req.m_filter_cb);
         COUNTER_INCREMENT(m_metrics, btree_obj_count, 1);
+    } else if constexpr (std::is_same_v< ReqT, BtreeMultiPutRequest< K > >) {
+        // Put all the keys of the batch which belong to this leaf, as long as there is room in it. Whatever is left
+        // over is picked up on the next walk down from the root (which would split this node if needed). The first
+        // key is always attempted, since the parent has already made room for it.
+        uint32_t nattempted{0};
+        uint32_t nput{0};
+        while (!req.is_done() && req.is_cur_key_within_bound()) {
+            if ((nattempted != 0) &&
+                !my_node->has_room_for_put(req.m_put_type, req.key().serialized_size(),
+                                           req.value().serialized_size())) {
+                break;
+            }
+            auto const status =
+                to_variant_node(my_node)->put(req.key(), req.value(), req.m_put_type, nullptr, req.m_filter_cb);
+            if (status == btree_status_t::success) { ++nput; }
+            req.complete_cur_key(status);
+            ++nattempted;
+        }
+        COUNTER_INCREMENT(m_metrics, btree_obj_count, nput);
+
+        ret = req.is_done() ? btree_status_t::success : btree_status_t::has_more;
+        if (nput == 0) { return ret; } // Nothing modified in this node
     }
 
     if ((ret == btree_status_t::success) || (ret == btree_status_t::has_more)) {
@@ -232,7 +262,8 @@ btree_status_t Btree< K, V >::check_split_root(ReqT& req) {
         goto done;
     }
 
-    ret = split_node(root, child_node, root->total_entries(), &split_key, req.m_op_context);
+    ret = split_node(root, child_node, root->total_entries(), &split_key, req.m_op_context,
+                     split_edge(child_node, req));
     if (ret != btree_status_t::success) {
         free_node(root, locktype_t::WRITE, req.m_op_context);
         root = std::move(child_node);
@@ -253,7 +284,7 @@ done:
 
 template < typename K, typename V >
 btree_status_t Btree< K, V >::split_node(const BtreeNodePtr& parent_node, const BtreeNodePtr& child_node,
-                                         uint32_t parent_ind, K* out_split_key, void* context) {
+                                         uint32_t parent_ind, K* out_split_key, void* context, int8_t insert_edge) {
     BtreeNodePtr child_node1 = child_node;
     BtreeNodePtr child_node2;
     child_node2.reset(child_node1->is_leaf() ? alloc_leaf_node().get() : alloc_interior_node().get());
@@ -267,8 +298,12 @@ btree_status_t Btree< K, V >::split_node(const BtreeNodePtr& parent_node, const
     child_node2->set_level(child_node1->level());
     uint32_t child1_filled_size = child_node1->node_data_size() - child_node1->available_size();
 
-    auto split_size = m_bt_cfg.split_size(child1_filled_size);
+    auto split_size = m_bt_cfg.split_size(child1_filled_size, insert_edge);
     uint32_t res = child_node1->move_out_to_right_by_size(m_bt_cfg, *child_node2, split_size);
+    if ((res == 0) && (insert_edge != 0)) {
+        // Share of the node to move out for an edge split is smaller than its last entry, fallback to regular split
+        res = child_node1->move_out_to_right_by_size(m_bt_cfg, *child_node2, m_bt_cfg.split_size(child1_filled_size));
+    }
 
     BT_NODE_REL_ASSERT_GT(res, 0, child_node1,
                           "Unable to split entries in the child node"); // means cannot split entries
@@ -276,6 +311,22 @@ btree_status_t Btree< K, V >::split_node(const BtreeNodePtr& parent_node, const
 
     // Insert the last entry in first child to parent node
     *out_split_key = child_node1->get_last_key< K >();
+    if constexpr (is_bytewise_btree_key_v< K >) {
+        if (m_bt_cfg.interior_node_type() == btree_node_type::VAR_PREFIX) {
+            // Suffix truncation: the shortest prefix of the first key in second child, which is still greater than the
+            // last key in first child, separates the two children as well as the full key does.
+            K const right_key = child_node2->get_first_key< K >();
+            sisl::blob const lb = out_split_key->serialize();
+            sisl::blob const rb = right_key.serialize();
+            uint32_t i{0};
+            while ((i < lb.size()) && (i < rb.size()) && (lb.cbytes()[i] == rb.cbytes()[i])) {
+                ++i;
+            }
+            if ((i + 1 < lb.size()) && (i + 1 < rb.size())) {
+                out_split_key->deserialize(sisl::blob{const_cast< uint8_t* >(rb.cbytes()), i + 1}, true);
+            }
+        }
+    }
 
     BT_NODE_LOG(TRACE, parent_node, "Available space for split entry={}", parent_node->available_size());
 
@@ -289,6 +340,16 @@ btree_status_t Btree< K, V >::split_node(const BtreeNodePtr& parent_node, const
     // (i.e., new root) or updating the edge, this order made sure that edge is updated.
     parent_node->update(parent_ind, child_node2->link_info());
     parent_node->insert(parent_ind, *out_split_key, child_node1->link_info());
+    if (m_bt_cfg.m_split_policy == btree_split_policy::ADAPTIVE) {
+        // Splits of the edge child are the inserts on the edge for an interior node
+        int8_t edge{0};
+        if (parent_ind + 1 == parent_node->total_entries()) {
+            edge = 1;
+        } else if (parent_ind == 0) {
+            edge = -1;
+        }
+        parent_node->record_edge_insert(edge);
+    }
 
     BT_NODE_DBG_ASSERT_GT(child_node2->get_first_key< K >().compare(*out_split_key), 0, child_node2);
     BT_NODE_LOG(DEBUG, parent_node, "Split child_node={} with new_child_node={}, split_key={}", child_node1->node_id(),
@@ -310,10 +371,44 @@ bool Btree< K, V >::is_split_needed(const BtreeNodePtr& node, ReqT& req) const {
         return !node->has_room_for_put(btree_put_type::UPSERT, K::get_max_size(), BtreeLinkInfo::get_fixed_size());
     } else if constexpr (std::is_same_v< ReqT, BtreeRangePutRequest< K > >) {
         return !node->has_room_for_put(req.m_put_type, req.first_key_size(), req.m_newval->serialized_size());
-    } else if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest >) {
+    } else if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest > ||
+                         std::is_same_v< ReqT, BtreeMultiPutRequest< K > >) {
         return !node->has_room_for_put(req.m_put_type, req.key().serialized_size(), req.value().serialized_size());
     } else {
         return false;
     }
 }
+
+template < typename K, typename V >
+template < typename ReqT >
+int8_t Btree< K, V >::split_edge(const BtreeNodePtr& node, ReqT& req) const {
+    if (m_bt_cfg.m_split_policy == btree_split_policy::EVEN) { return 0; }
+
+    int8_t edge{0};
+    if constexpr (std::is_same_v< ReqT, BtreeRangePutRequest< K > >) {
+        edge = node->template insert_edge< K >(req.working_range().start_key());
+    } else if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest > ||
+                         std::is_same_v< ReqT, BtreeMultiPutRequest< K > >) {
+        edge = node->template insert_edge< K >(req.key());
+    }
+
+    if ((edge != 0) && (m_bt_cfg.m_split_policy == btree_split_policy::ADAPTIVE)) {
+        // Split at the edge only if the node has been seeing inserts on the same edge for a while
+        auto const run = node->edge_insert_run();
+        if ((edge > 0) ? (run < m_bt_cfg.m_sequential_run_len) : (-run < m_bt_cfg.m_sequential_run_len)) { edge = 0; }
+    }
+    return edge;
+}
+
+template < typename K, typename V >
+template < typename ReqT >
+void Btree< K, V >::record_edge_insert(const BtreeNodePtr& node, ReqT& req) const {
+    if (m_bt_cfg.m_split_policy != btree_split_policy::ADAPTIVE) { return; }
+    if constexpr (std::is_same_v< ReqT, BtreeRangePutRequest< K > >) {
+        node->record_edge_insert(node->template insert_edge< K >(req.working_range().start_key()));
+    } else if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest > ||
+                         std::is_same_v< ReqT, BtreeMultiPutRequest< K > >) {
+        node->record_edge_insert(node->template insert_edge< K >(req.key()));
+    }
+}
 } // namespace homestore
@@ -15,7 +15,9 @@
  *********************************************************************************/
 
 #pragma once
+#include <atomic>
 #include <iostream>
+#include <optional>
 #include <queue>
 #include <iomgr/fiber_lib.hpp>
 
@@ -34,6 +36,10 @@ struct transient_hdr_t {
     mutable iomgr::FiberManagerLib::shared_mutex lock;
     sisl::atomic_counter< uint16_t > upgraders{0};
 
+    // Number of inserts in a row past the last key (positive) or before the first key (negative) of the node, for the
+    // adaptive split policy to detect sequential inserts. Updated under the node write lock.
+    int8_t edge_insert_run{0};
+
     /* these variables are accessed without taking lock and are not expected to change after init */
     uint8_t leaf_node{0};
     uint64_t max_keys_in_node{0};
@@ -101,6 +107,11 @@ public:
     transient_hdr_t m_trans_hdr;
     uint8_t* m_phys_node_buf;
 
+    // Version of the node contents, for readers which do not take the node lock (see Btree::do_optimistic_get). It is
+    // made odd when the node is write locked and even again on unlock, so a reader which sees the same even version
+    // before and after reading the node has read a consistent node.
+    mutable std::atomic< uint64_t > m_lock_version{0};
+
 public:
     BtreeNode(uint8_t* node_buf, bnodeid_t id, bool init_buf, bool is_leaf, BtreeConfig const& cfg) :
             m_phys_node_buf{node_buf} {
@@ -183,6 +194,13 @@ public:
         return std::make_pair(found, idx);
     }
 
+    // Same as find(), but called without holding the node lock, so the node could be modified underneath. It has to
+    // stay within the node buffer no matter what it reads and the caller discards the result if the node version
+    // changed. Node types which cannot do that return nullopt.
+    virtual std::optional< node_find_result_t > find_unlocked(BtreeKey const& key, BtreeValue* outval) const {
+        return std::nullopt;
+    }
+
     template < typename K >
     bool match_range(BtreeKeyRange< K > const& range, uint32_t& start_idx, uint32_t& end_idx) const {
         LOGMSG_ASSERT_EQ(magic(), BTREE_NODE_MAGIC, "Magic mismatch on btree_node {}",
@@ -307,6 +325,28 @@ public:
         return get_nth_key< K >(0, true);
     }
 
+    /// @brief Returns 1 if the key would be inserted past the last key of this node, -1 if before its first key and 0
+    /// if in between or the node is empty
+    template < typename K >
+    int8_t insert_edge(BtreeKey const& key) const {
+        if (total_entries() == 0) { return 0; }
+        if (get_nth_key< K >(total_entries() - 1, false).compare(key) < 0) { return 1; }
+        if (get_nth_key< K >(0, false).compare(key) > 0) { return -1; }
+        return 0;
+    }
+
+    void record_edge_insert(int8_t edge) {
+        auto& run = m_trans_hdr.edge_insert_run;
+        if (edge > 0) {
+            run = (run > 0) ? std::min< int8_t >(run + 1, std::numeric_limits< int8_t >::max()) : 1;
+        } else if (edge < 0) {
+            run = (run < 0) ? std::max< int8_t >(run - 1, std::numeric_limits< int8_t >::min()) : -1;
+        } else {
+            run = 0;
+        }
+    }
+    int8_t edge_insert_run() const { return m_trans_hdr.edge_insert_run; }
+
     template < typename K >
     bool validate_key_order() const {
         for (auto i = 1u; i < total_entries(); ++i) {
@@ -345,6 +385,8 @@ public:
             m_trans_hdr.lock.lock_shared();
         } else if (l == locktype_t::WRITE) {
             m_trans_hdr.lock.lock();
+            m_lock_version.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
         }
     }
 
@@ -352,10 +394,20 @@ public:
         if (l == locktype_t::READ) {
             m_trans_hdr.lock.unlock_shared();
         } else if (l == locktype_t::WRITE) {
+            m_lock_version.fetch_add(1, std::memory_order_release);
             m_trans_hdr.lock.unlock();
         }
     }
 
+    uint64_t lock_version() const { return m_lock_version.load(std::memory_order_acquire); }
+    static bool is_write_locked_version(uint64_t version) { return ((version & 1) != 0); }
+
+    // Returns true if the node was not write locked since lock_version() returned the given version
+    bool validate_lock_version(uint64_t version) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return (m_lock_version.load(std::memory_order_relaxed) == version);
+    }
+
     void lock_upgrade() {
         m_trans_hdr.upgraders.increment(1);
         this->unlock(locktype_t::READ);
@@ -445,7 +497,8 @@ public:
     virtual std::string to_dot_keys() const = 0;
 
 protected:
-    node_find_result_t bsearch_node(const BtreeKey& key) const {
+    // Node types which can search their keys without going through compare_nth_key for every probe override this
+    virtual node_find_result_t bsearch_node(const BtreeKey& key) const {
         DEBUG_ASSERT_EQ(magic(), BTREE_NODE_MAGIC);
         auto [found, idx] = bsearch(-1, total_entries(), key);
         if (found) { DEBUG_ASSERT_LT(idx, total_entries()); }
@@ -289,6 +289,11 @@ BtreeNode* Btree< K, V >::init_node(uint8_t* node_buf, bnodeid_t id, bool init_b
                     : create_node< FixedPrefixNode< K, BtreeLinkInfo > >(node_buf, id, init_buf, false, this->m_bt_cfg);
         break;
 
+    case btree_node_type::VAR_PREFIX:
+        n = is_leaf ? create_node< VarPrefixNode< K, V > >(node_buf, id, init_buf, true, this->m_bt_cfg)
+                    : create_node< VarPrefixNode< K, BtreeLinkInfo > >(node_buf, id, init_buf, false, this->m_bt_cfg);
+        break;
+
     default:
         BT_REL_ASSERT(false, "Unsupported node type {}", node_type);
         break;
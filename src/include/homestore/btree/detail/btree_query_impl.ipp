@@ -18,6 +18,32 @@
 
 namespace homestore {
 
+// Ask the store to start loading the children [start_idx, end_idx] of the node (capped by the read ahead window of the
+// query), so that by the time the query moves to them, they are hopefully in cache. Caller holds the node lock.
+template < typename K, typename V >
+void Btree< K, V >::read_ahead_children(const BtreeNodePtr& node, uint32_t start_idx, uint32_t end_idx,
+                                        BtreeQueryRequest< K > const& qreq) const {
+    if ((qreq.read_ahead() == 0) || (start_idx > end_idx)) { return; }
+    end_idx = std::min(end_idx, start_idx + qreq.read_ahead() - 1);
+
+    std::vector< bnodeid_t > ids;
+    ids.reserve(end_idx - start_idx + 1);
+    for (auto i = start_idx; i <= end_idx; ++i) {
+        if (i >= node->total_entries()) {
+            if (node->has_valid_edge()) { ids.push_back(node->edge_id()); }
+            break;
+        }
+        BtreeLinkInfo child_info;
+        node->get_nth_value(i, &child_info, false /* copy */);
+        ids.push_back(child_info.bnode_id());
+    }
+
+    if (!ids.empty()) {
+        COUNTER_INCREMENT(m_metrics, btree_read_ahead_nodes, ids.size());
+        prefetch_nodes(ids);
+    }
+}
+
 template < typename K, typename V >
 btree_status_t Btree< K, V >::do_sweep_query(BtreeNodePtr& my_node, BtreeQueryRequest< K >& qreq,
                                              std::vector< std::pair< K, V > >& out_values) const {
@@ -26,6 +52,7 @@ btree_status_t Btree< K, V >::do_sweep_query(BtreeNodePtr& my_node, BtreeQueryRe
         BT_NODE_DBG_ASSERT_GT(qreq.batch_size(), 0, my_node);
 
         auto count = 0U;
+        uint32_t nleaves{0};
         BtreeNodePtr next_node = nullptr;
 
         do {
@@ -56,6 +83,14 @@ btree_status_t Btree< K, V >::do_sweep_query(BtreeNodePtr& my_node, BtreeQueryRe
                 ret = read_and_lock_node(my_node->next_bnode(), next_node, locktype_t::READ, locktype_t::READ,
                                          qreq.m_op_context);
                 if (ret != btree_status_t::success) { break; }
+
+                // Beyond the leaves the parent read ahead for us, keep one sibling ahead of the one we are on
+                if ((qreq.read_ahead() != 0) && (++nleaves >= qreq.read_ahead()) &&
+                    (next_node->next_bnode() != empty_bnodeid) &&
+                    (next_node->get_last_key< K >().compare(qreq.input_range().end_key()) < 0)) {
+                    COUNTER_INCREMENT(m_metrics, btree_read_ahead_nodes, 1);
+                    prefetch_nodes({next_node->next_bnode()});
+                }
             } else {
                 ret = btree_status_t::has_more;
                 break;
@@ -71,6 +106,13 @@ btree_status_t Btree< K, V >::do_sweep_query(BtreeNodePtr& my_node, BtreeQueryRe
     ASSERT_IS_VALID_INTERIOR_CHILD_INDX(isfound, idx, my_node);
     if (qreq.route_tracing) { append_route_trace(qreq, my_node, btree_event_t::READ, idx, idx); }
 
+    if ((my_node->level() == 1) && (qreq.read_ahead() != 0)) {
+        // Sweep is going to walk the leaves following this child, start loading them while we query this one
+        [[maybe_unused]] auto [end_found, end_idx] = my_node->find(qreq.input_range().end_key(), nullptr, false);
+        if ((end_idx == my_node->total_entries()) && !my_node->has_valid_edge()) { --end_idx; }
+        read_ahead_children(my_node, idx + 1, end_idx, qreq);
+    }
+
     BtreeNodePtr child_node;
     ret = read_and_lock_node(start_child_info.bnode_id(), child_node, locktype_t::READ, locktype_t::READ,
                              qreq.m_op_context);
@@ -118,7 +160,13 @@ btree_status_t Btree< K, V >::do_traversal_query(const BtreeNodePtr& my_node, Bt
     idx = start_idx;
 
     if (qreq.route_tracing) { append_route_trace(qreq, my_node, btree_event_t::READ, start_idx, end_idx); }
+    read_ahead_children(my_node, start_idx + 1, end_idx, qreq);
     while (idx <= end_idx) {
+        // Slide the read ahead window as we move through the children
+        if ((idx > start_idx) && (qreq.read_ahead() != 0) && (idx + qreq.read_ahead() <= end_idx)) {
+            read_ahead_children(my_node, idx + qreq.read_ahead(), idx + qreq.read_ahead(), qreq);
+        }
+
         BtreeLinkInfo child_info;
         my_node->get_nth_value(idx, &child_info, false);
         BtreeNodePtr child_node = nullptr;
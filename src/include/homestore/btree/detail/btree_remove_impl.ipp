@@ -40,6 +40,14 @@ btree_status_t Btree< K, V >::do_remove(const BtreeNodePtr& my_node, locktype_t
             req.shift_working_range();
         } else if constexpr (std::is_same_v< ReqT, BtreeRemoveAnyRequest< K > >) {
             if ((modified = my_node->remove_any(req.m_range, req.m_outkey, req.m_outval))) { ++removed_count; }
+        } else if constexpr (std::is_same_v< ReqT, BtreeMultiRemoveRequest< K > >) {
+            // Remove all the keys of the batch which belong to this leaf, rest are done on next walk from the root
+            while (!req.is_done() && req.is_cur_key_within_bound()) {
+                bool const found = my_node->remove_one(req.key(), nullptr, req.outval());
+                if (found) { ++removed_count; }
+                req.complete_cur_key(found ? btree_status_t::success : btree_status_t::not_found);
+            }
+            modified = (removed_count != 0);
         }
 #ifndef NDEBUG
         my_node->validate_key_order< K >();
@@ -51,6 +59,9 @@ btree_status_t Btree< K, V >::do_remove(const BtreeNodePtr& my_node, locktype_t
         }
 
         unlock_node(my_node, curlock);
+        if constexpr (std::is_same_v< ReqT, BtreeMultiRemoveRequest< K > >) {
+            return req.is_done() ? btree_status_t::success : btree_status_t::retry;
+        }
         return modified ? btree_status_t::success : btree_status_t::not_found;
     }
 
@@ -66,7 +77,8 @@ retry:
     };
 
     // Get the childPtr for given key.
-    if constexpr (std::is_same_v< ReqT, BtreeSingleRemoveRequest >) {
+    if constexpr (std::is_same_v< ReqT, BtreeSingleRemoveRequest > ||
+                  std::is_same_v< ReqT, BtreeMultiRemoveRequest< K > >) {
         auto const [found, idx] = my_node->find(req.key(), nullptr, false);
         ASSERT_IS_VALID_INTERIOR_CHILD_INDX(found, idx, my_node);
         end_idx = start_idx = idx;
@@ -89,6 +101,30 @@ retry:
     if (req.route_tracing) { append_route_trace(req, my_node, btree_event_t::READ, start_idx, end_idx); }
     curr_idx = start_idx;
     while (curr_idx <= end_idx) {
+        if constexpr (std::is_same_v< ReqT, BtreeRangeRemoveRequest< K > >) {
+            // Children which the range covers fully are unlinked here as a whole, instead of walking their leaves
+            auto const ndrop = num_droppable_children(my_node, curr_idx, end_idx, req);
+            if (ndrop != 0) {
+                if (curlock != locktype_t::WRITE) {
+                    ret = upgrade_node_lock(my_node, curlock, req.m_op_context);
+                    if (ret != btree_status_t::success) { goto out_return; }
+                }
+
+                auto const drop_end_idx = curr_idx + ndrop - 1;
+                K last_dropped_key = my_node->get_nth_key< K >(drop_end_idx, true /* copy */);
+                ret = drop_subtrees(my_node, curr_idx, drop_end_idx, req.m_op_context);
+                if (ret != btree_status_t::success) { goto out_return; }
+                if (req.route_tracing) {
+                    append_route_trace(req, my_node, btree_event_t::REMOVE, curr_idx, drop_end_idx);
+                }
+                at_least_one_child_modified = true;
+
+                // Rest of the range starts past the dropped children, which is now within the child at curr_idx
+                req.shift_working_range(std::move(last_dropped_key), false /* start_incl */);
+                goto retry;
+            }
+        }
+
         BtreeLinkInfo child_info;
         BtreeNodePtr child_node;
         ret = get_child_and_lock_node(my_node, curr_idx, child_info, child_node, locktype_t::READ, locktype_t::WRITE,
@@ -96,7 +132,10 @@ retry:
         if (ret != btree_status_t::success) { goto out_return; }
         child_cur_lock = child_node->is_leaf() ? locktype_t::WRITE : locktype_t::READ;
 
-        if (child_node->is_merge_needed(m_bt_cfg)) {
+        if (m_bt_cfg.m_lazy_merge) {
+            // Merge is left to the background, which saves removes the write locks and the merge writes
+            if (child_node->is_merge_needed(m_bt_cfg)) { add_merge_candidate(my_node, curr_idx, child_node); }
+        } else if (child_node->is_merge_needed(m_bt_cfg)) {
             // If child node is minimal and can be merged
             uint32_t node_end_idx = my_node->total_entries();
             if (!my_node->has_valid_edge()) { --node_end_idx; }
@@ -142,6 +181,11 @@ retry:
             }
         }
 
+        if constexpr (std::is_same_v< ReqT, BtreeMultiRemoveRequest< K > >) {
+            // Narrow down the keys of the batch this child covers, the edge child inherits the bound of this node
+            if (curr_idx < my_node->total_entries()) { req.set_upper_bound(my_node->get_nth_key< K >(curr_idx, true)); }
+        }
+
 #ifndef NDEBUG
         if (child_node->total_entries()) {
             if (curr_idx != my_node->total_entries()) { // not edge
@@ -165,6 +209,10 @@ retry:
 
         ret = do_remove(child_node, child_cur_lock, req);
         if (ret == btree_status_t::success) { at_least_one_child_modified = true; }
+        if constexpr (std::is_same_v< ReqT, BtreeRangeRemoveRequest< K > >) {
+            // Working range has moved past whatever is removed so far, the rest is picked up again from the root
+            if (ret == btree_status_t::retry) { goto out_return; }
+        }
         ++curr_idx;
     }
 
@@ -172,9 +220,158 @@ out_return:
     // Warning: Do not access childNode or myNode beyond this point, since it would
     // have been unlocked by the recursive function and it could also been deleted.
     if (curlock != locktype_t::NONE) { unlock_lambda(my_node, curlock); }
+    if constexpr (std::is_same_v< ReqT, BtreeRangeRemoveRequest< K > >) {
+        if (ret == btree_status_t::retry) { return ret; }
+    }
     return (at_least_one_child_modified) ? btree_status_t::success : ret;
 }
 
+template < typename K, typename V >
+uint32_t Btree< K, V >::num_droppable_children(const BtreeNodePtr& node, uint32_t start_idx, uint32_t end_idx,
+                                               BtreeRangeRemoveRequest< K > const& rrreq) const {
+    // Filter has to see every entry. The first child is never dropped, since its lower bound is not in this node,
+    // nor is the last child, so that the node is always left with children.
+    if (!m_bt_cfg.m_drop_subtrees || !can_drop_subtrees() || rrreq.m_filter_cb || (start_idx == 0)) { return 0; }
+    auto const& range = rrreq.working_range();
+    if (range.start_key().compare(node->get_nth_key< K >(start_idx - 1, false /* copy */)) > 0) { return 0; }
+
+    uint32_t const last_child_idx = node->has_valid_edge() ? node->total_entries() : node->total_entries() - 1;
+    uint32_t n{0};
+    while ((start_idx + n <= end_idx) && (start_idx + n < last_child_idx)) {
+        auto const x = node->get_nth_key< K >(start_idx + n, false /* copy */).compare(range.end_key());
+        if ((x > 0) || ((x == 0) && !range.is_end_inclusive())) { break; }
+        ++n;
+    }
+    return n;
+}
+
+/*
+ * Unlink the children [start_idx, end_idx] of the write locked parent and free their subtrees. The sibling links are
+ * repaired at every level, by pointing the right spine of the child before the dropped ones to the left spine of the
+ * child after them, which always exists since the last child is never dropped.
+ *
+ * Only the dropped children and the top of the spine are part of the transaction. Spine nodes below it are written and
+ * the descendants freed without a journal record, which is why only stores that are not recovered after a crash can
+ * drop subtrees, see can_drop_subtrees().
+ */
+template < typename K, typename V >
+btree_status_t Btree< K, V >::drop_subtrees(const BtreeNodePtr& parent_node, uint32_t start_idx, uint32_t end_idx,
+                                            void* context) {
+    BtreeNodeList left_spine;
+    BtreeNodeList dropped_nodes;
+    std::vector< bnodeid_t > right_spine_ids;
+    BtreeLinkInfo child_info;
+    BtreeNodePtr node;
+
+    auto last_child_info = [](const BtreeNodePtr& n) {
+        BtreeLinkInfo info;
+        if (n->has_valid_edge()) {
+            info = n->get_edge_value();
+        } else {
+            n->get_nth_value(n->total_entries() - 1, &info, false /* copy */);
+        }
+        return info;
+    };
+
+    // Nodes are locked left to right at every level, same as the sibling walk of queries
+    parent_node->get_nth_value(start_idx - 1, &child_info, false /* copy */);
+    auto ret = read_and_lock_node(child_info.bnode_id(), node, locktype_t::WRITE, locktype_t::WRITE, context);
+    while (ret == btree_status_t::success) {
+        left_spine.push_back(node);
+        if (node->is_leaf()) { break; }
+        ret = read_and_lock_node(last_child_info(node).bnode_id(), node, locktype_t::WRITE, locktype_t::WRITE,
+                                 context);
+    }
+
+    for (auto idx = start_idx; (ret == btree_status_t::success) && (idx <= end_idx); ++idx) {
+        parent_node->get_nth_value(idx, &child_info, false /* copy */);
+        ret = read_and_lock_node(child_info.bnode_id(), node, locktype_t::WRITE, locktype_t::WRITE, context);
+        if (ret == btree_status_t::success) { dropped_nodes.push_back(node); }
+    }
+
+    // Only the ids of the right spine are needed, so its leaf is not read
+    if (ret == btree_status_t::success) {
+        if ((end_idx + 1) == parent_node->total_entries()) {
+            child_info = parent_node->get_edge_value();
+        } else {
+            parent_node->get_nth_value(end_idx + 1, &child_info, false /* copy */);
+        }
+        right_spine_ids.push_back(child_info.bnode_id());
+        while (right_spine_ids.size() < left_spine.size()) {
+            ret = read_and_lock_node(right_spine_ids.back(), node, locktype_t::READ, locktype_t::READ, context);
+            if (ret != btree_status_t::success) { break; }
+            if (node->total_entries() == 0) {
+                child_info = node->get_edge_value();
+            } else {
+                node->get_nth_value(0, &child_info, false /* copy */);
+            }
+            unlock_node(node, locktype_t::READ);
+            right_spine_ids.push_back(child_info.bnode_id());
+        }
+    }
+
+    if (ret != btree_status_t::success) {
+        for (auto it = dropped_nodes.rbegin(); it != dropped_nodes.rend(); ++it) {
+            unlock_node(*it, locktype_t::WRITE);
+        }
+        for (auto it = left_spine.rbegin(); it != left_spine.rend(); ++it) {
+            unlock_node(*it, locktype_t::WRITE);
+        }
+        return ret;
+    }
+
+    // No going back from here on. Lower levels of the spine are written first, the top one is part of the transaction.
+    for (size_t level{left_spine.size()}; level-- > 0;) {
+        left_spine[level]->set_next_bnode(right_spine_ids[level]);
+        if (level != 0) { write_node(left_spine[level], context); }
+    }
+
+    for (auto const& dropped : dropped_nodes) {
+        if (dropped->is_leaf()) {
+            COUNTER_DECREMENT(m_metrics, btree_obj_count, dropped->total_entries());
+        } else {
+            free_subtree_below(dropped, context);
+        }
+    }
+    parent_node->remove(start_idx, end_idx);
+    ret = transact_nodes({}, dropped_nodes, left_spine[0], parent_node, context);
+    COUNTER_INCREMENT(m_metrics, btree_subtree_drop_count, dropped_nodes.size());
+    BT_NODE_LOG(DEBUG, parent_node, "Dropped children [{}-{}] of the node as part of range remove", start_idx, end_idx);
+
+    for (auto it = left_spine.rbegin(); it != left_spine.rend(); ++it) {
+        unlock_node(*it, locktype_t::WRITE);
+    }
+    return ret;
+}
+
+// Free all the descendants of the write locked interior node, which is already unlinked from the tree
+template < typename K, typename V >
+void Btree< K, V >::free_subtree_below(const BtreeNodePtr& node, void* context) {
+    uint32_t const nchildren = node->total_entries() + (node->has_valid_edge() ? 1 : 0);
+    for (uint32_t i{0}; i < nchildren; ++i) {
+        BtreeLinkInfo child_info;
+        if (i == node->total_entries()) {
+            child_info = node->get_edge_value();
+        } else {
+            node->get_nth_value(i, &child_info, false /* copy */);
+        }
+
+        BtreeNodePtr child;
+        if (read_and_lock_node(child_info.bnode_id(), child, locktype_t::WRITE, locktype_t::WRITE, context) !=
+            btree_status_t::success) {
+            BT_NODE_LOG(ERROR, node, "Unable to read child {} of a dropped subtree, its nodes are not freed",
+                        child_info.bnode_id());
+            continue;
+        }
+        if (child->is_leaf()) {
+            COUNTER_DECREMENT(m_metrics, btree_obj_count, child->total_entries());
+        } else {
+            free_subtree_below(child, context);
+        }
+        free_node(child, locktype_t::WRITE, context);
+    }
+}
+
 template < typename K, typename V >
 template < typename ReqT >
 btree_status_t Btree< K, V >::check_collapse_root(ReqT& req) {
@@ -238,6 +435,23 @@ btree_status_t Btree< K, V >::merge_nodes(const BtreeNodePtr& parent_node, const
     uint32_t expected_tail{0};
     uint32_t init_holes{0};
     uint32_t init_tail{0};
+    // Leaf and interior VAR_PREFIX nodes hold different value types, so the size is tracked through the node type of
+    // the level being merged
+    std::optional< typename VarPrefixNode< K, V >::reencoded_size > leaf_var_size;
+    std::optional< typename VarPrefixNode< K, BtreeLinkInfo >::reencoded_size > interior_var_size;
+    bool is_var_prefix{false};
+    auto const var_num_fit = [&leaf_var_size, &interior_var_size](const BtreeNodePtr& node, uint32_t max_size) {
+        return leaf_var_size
+            ? leaf_var_size->num_fit(static_cast< const VarPrefixNode< K, V >& >(*node), 0, max_size)
+            : interior_var_size->num_fit(static_cast< const VarPrefixNode< K, BtreeLinkInfo >& >(*node), 0, max_size);
+    };
+    auto const var_add = [&leaf_var_size, &interior_var_size](const BtreeNodePtr& node, uint32_t nentries) {
+        if (leaf_var_size) {
+            leaf_var_size->add(static_cast< const VarPrefixNode< K, V >& >(*node), 0, nentries);
+        } else {
+            interior_var_size->add(static_cast< const VarPrefixNode< K, BtreeLinkInfo >& >(*node), 0, nentries);
+        }
+    };
 
     struct _leftmost_src_info {
         std::vector< uint32_t > ith_nodes;
@@ -356,13 +570,23 @@ btree_status_t Btree< K, V >::merge_nodes(const BtreeNodePtr& parent_node, const
         init_holes = expected_holes;
         expected_tail = cur_node->cprefix_header()->tail_slot;
         init_tail = expected_tail;
+    } else if (leftmost_node->get_node_type() == btree_node_type::VAR_PREFIX) {
+        // Entries copied in are reencoded against the prefix common to all of them, which is known only as they are
+        // added, so track the size the leftmost node will take after the copy instead of summing up the entry sizes
+        is_var_prefix = true;
+        if (leftmost_node->is_leaf()) {
+            leaf_var_size.emplace(static_cast< const VarPrefixNode< K, V >& >(*leftmost_node));
+        } else {
+            interior_var_size.emplace(static_cast< const VarPrefixNode< K, BtreeLinkInfo >& >(*leftmost_node));
+        }
     }
     src_cursor.ith_node = old_nodes.size();
     for (uint32_t i{0}; (i < old_nodes.size() && available_size >= 0); ++i) {
         leftmost_src.ith_nodes.push_back(i);
         // TODO: check whether value size of the node is greater than available_size? If so nentries is 0. Suppose if a
         // node contains one entry and the value size is much bigger than available size
-        auto nentries = old_nodes[i]->num_entries_by_size(0, available_size);
+        auto nentries = is_var_prefix ? var_num_fit(old_nodes[i], balanced_size)
+                                      : old_nodes[i]->num_entries_by_size(0, available_size);
 
 #ifdef _PRERELEASE
         if (max_keys) {
@@ -376,6 +600,7 @@ btree_status_t Btree< K, V >::merge_nodes(const BtreeNodePtr& parent_node, const
 #endif
 
         total_entries -= nentries;
+        if (is_var_prefix) { var_add(old_nodes[i], nentries); }
         if ((old_nodes[i]->total_entries() - nentries) == 0) { // Entire node goes in
             if (old_nodes[i]->get_node_type() == btree_node_type::PREFIX) {
                 auto cur_node = static_cast< FixedPrefixNode< K, V >* >(old_nodes[i].get());
@@ -392,6 +617,9 @@ btree_status_t Btree< K, V >::merge_nodes(const BtreeNodePtr& parent_node, const
                 available_size -= (prefix_increased_size + suffix_increased_size);
                 init_holes = expected_holes;
                 init_tail = expected_tail;
+            } else if (is_var_prefix) {
+                available_size = static_cast< int32_t >(balanced_size) -
+                    (leaf_var_size ? leaf_var_size->size() : interior_var_size->size());
             } else {
                 available_size -= old_nodes[i]->occupied_size();
             }
@@ -445,9 +673,16 @@ btree_status_t Btree< K, V >::merge_nodes(const BtreeNodePtr& parent_node, const
             //  If it is the last node supposed to be, check if the remaining entries can be copied and not creating a
             //  new nodes. This will make the last new node a little skewed from balanced size due to large key/values
             //  but avoid making extra new node.
-            if (new_nodes.size() == num_nodes - 1 && total_size < new_node->available_size()) {
+            if ((nentries != 0) && (new_nodes.size() == num_nodes - 1) && (total_size < new_node->available_size())) {
                 available_size = new_node->available_size();
                 src_cursor.nth_entry += nentries;
+            } else if ((nentries == 0) && (new_node->total_entries() == 0)) {
+                // Not even one entry fits in an empty node within the balanced size, don't keep allocating nodes
+                ret = btree_status_t::merge_not_required;
+                BT_NODE_LOG(DEBUG, parent_node, "MERGE disqualified for parent node {}! entry {} of old node {} doesn't "
+                            "fit in balanced size {}", parent_node->to_string(), src_cursor.nth_entry,
+                            src_cursor.ith_node, balanced_size);
+                goto out;
             } else {
                 src_cursor.nth_entry += nentries;
                 available_size = 0;
@@ -507,10 +742,13 @@ btree_status_t Btree< K, V >::merge_nodes(const BtreeNodePtr& parent_node, const
     {
         for (uint32_t i{0}; i < leftmost_src.ith_nodes.size(); ++i) {
             auto const idx = leftmost_src.ith_nodes[i];
-            leftmost_node->copy_by_entries(m_bt_cfg, *old_nodes[idx], 0,
-                                           (i == leftmost_src.ith_nodes.size() - 1)
+            auto const nentries = std::min((i == leftmost_src.ith_nodes.size() - 1)
                                                ? leftmost_src.last_node_upto
-                                               : std::numeric_limits< uint32_t >::max());
+                                               : std::numeric_limits< uint32_t >::max(),
+                                           old_nodes[idx]->total_entries());
+            auto const ncopied = leftmost_node->copy_by_entries(m_bt_cfg, *old_nodes[idx], 0, nentries);
+            BT_NODE_REL_ASSERT_EQ(ncopied, nentries, leftmost_node,
+                                  "Leftmost node didn't fit the entries planned for it, info {}", complete_info_str());
         }
         // std::string parent_node_step1 = parent_node->to_string();
 
@@ -622,4 +860,122 @@ out:
     }
     return ret;
 }
+template < typename K, typename V >
+void Btree< K, V >::add_merge_candidate(const BtreeNodePtr& parent_node, uint32_t child_idx,
+                                        const BtreeNodePtr& child_node) {
+    MergeCandidate c;
+    c.level = child_node->level();
+    if (child_idx < parent_node->total_entries()) {
+        c.key = parent_node->get_nth_key< K >(child_idx, true /* copy */);
+    } else if (child_node->total_entries() != 0) {
+        c.key = child_node->get_first_key< K >();
+    } else {
+        return; // Empty edge node can't be routed to by a key, it is merged when a remove finds it again
+    }
+
+    std::lock_guard lg(m_merge_candidates_mtx);
+    if (m_merge_candidates.size() >= m_bt_cfg.m_max_merge_candidates) { return; }
+    if (m_merge_candidates.insert(std::move(c)).second) {
+        COUNTER_INCREMENT(m_metrics, btree_merge_candidate_count, 1);
+    }
+}
+
+template < typename K, typename V >
+btree_status_t Btree< K, V >::merge_next_candidate(void* context) {
+    MergeCandidate c;
+    {
+        std::lock_guard lg(m_merge_candidates_mtx);
+        if (m_merge_candidates.empty()) { return btree_status_t::not_found; }
+        c = std::move(m_merge_candidates.extract(m_merge_candidates.begin()).value());
+    }
+
+    bool collapse_root{false};
+    m_btree_lock.lock_shared();
+    auto const ret = merge_candidate(c, context, collapse_root);
+    m_btree_lock.unlock_shared();
+
+    if (ret == btree_status_t::cp_mismatch) {
+        // Caller retries with the context of the new cp
+        std::lock_guard lg(m_merge_candidates_mtx);
+        m_merge_candidates.insert(std::move(c));
+    } else if (collapse_root) {
+        // Merge left the root with only its edge, which no remove might walk through to collapse it. If it fails, the
+        // next remove which finds the root empty collapses it.
+        BtreeRequest req{nullptr, context};
+        auto const collapse_ret = check_collapse_root(req);
+        if ((collapse_ret != btree_status_t::success) && (collapse_ret != btree_status_t::merge_not_required)) {
+            BT_LOG(DEBUG, "Collapse of root after lazy merge failed with status={}", enum_name(collapse_ret));
+        }
+    }
+    return ret;
+}
+
+template < typename K, typename V >
+size_t Btree< K, V >::num_merge_candidates() const {
+    std::lock_guard lg(m_merge_candidates_mtx);
+    return m_merge_candidates.size();
+}
+
+/*
+ * Walk down to the parent of the underfull node and merge it with its right siblings, same as a remove would have done
+ * inline. The tree could have changed since the node was recorded, so it is merged only if it still needs one.
+ * collapse_root is set if the parent is the root and is left with no entries, to be collapsed by the caller.
+ */
+template < typename K, typename V >
+btree_status_t Btree< K, V >::merge_candidate(MergeCandidate const& candidate, void* context, bool& collapse_root) {
+    BtreeNodePtr node;
+    locktype_t cur_lock{locktype_t::READ};
+    auto ret = read_and_lock_node(m_root_node_info.bnode_id(), node, cur_lock, cur_lock, context);
+    if (ret != btree_status_t::success) { return ret; }
+
+    while (node->level() > (candidate.level + 1)) {
+        auto const [found, idx] = node->find(candidate.key, nullptr, false);
+        ASSERT_IS_VALID_INTERIOR_CHILD_INDX(found, idx, node);
+
+        BtreeLinkInfo child_info;
+        BtreeNodePtr child_node;
+        ret = get_child_and_lock_node(node, idx, child_info, child_node, locktype_t::READ, locktype_t::READ, context);
+        unlock_node(node, cur_lock);
+        if (ret != btree_status_t::success) { return ret; }
+        node = std::move(child_node);
+    }
+
+    if (node->level() != (candidate.level + 1)) {
+        // Tree has shrunk below the level of the node
+        unlock_node(node, cur_lock);
+        return btree_status_t::merge_not_required;
+    }
+
+    ret = upgrade_node_lock(node, cur_lock, context);
+    if (ret == btree_status_t::retry) { return btree_status_t::merge_not_required; } // Node changed, remove finds it
+    if (ret != btree_status_t::success) { return ret; }
+
+    auto const [found, idx] = node->find(candidate.key, nullptr, false);
+    ASSERT_IS_VALID_INTERIOR_CHILD_INDX(found, idx, node);
+
+    BtreeLinkInfo child_info;
+    BtreeNodePtr child_node;
+    ret = get_child_and_lock_node(node, idx, child_info, child_node, locktype_t::WRITE, locktype_t::WRITE, context);
+    if (ret != btree_status_t::success) {
+        unlock_node(node, locktype_t::WRITE);
+        return ret;
+    }
+
+    ret = btree_status_t::merge_not_required;
+    if (child_node->is_merge_needed(m_bt_cfg)) {
+        uint32_t end_idx = node->total_entries();
+        if (!node->has_valid_edge()) { --end_idx; }
+        end_idx = std::min(end_idx, idx + m_bt_cfg.m_max_merge_nodes - 1);
+        if (end_idx > idx) {
+            ret = merge_nodes(node, child_node, idx, end_idx, context);
+            if (ret == btree_status_t::success) {
+                COUNTER_INCREMENT(m_metrics, btree_merge_count, 1);
+                collapse_root = (node->total_entries() == 0) && (node->node_id() == m_root_node_info.bnode_id());
+            }
+        }
+    }
+    unlock_node(child_node, locktype_t::WRITE);
+    unlock_node(node, locktype_t::WRITE);
+    return ret;
+}
 } // namespace homestore
@@ -356,6 +356,99 @@ public:
         return (get_nth_key_size(ind) + get_nth_value_size(ind));
     }
 
+    std::optional< node_find_result_t > find_unlocked(const BtreeKey& key, BtreeValue* outval) const override {
+        // Number of entries could be anything while a writer is modifying the node, bound it by what the node can hold
+        uint32_t const obj_size = get_nth_obj_size(0);
+        uint32_t const nentries = std::min(this->total_entries(), this->node_data_size() / obj_size);
+
+        node_find_result_t ret;
+        if constexpr (is_integral_btree_key_v< K >) {
+            ret = integral_bsearch(key, nentries);
+        } else {
+            uint32_t start{0};
+            uint32_t end{nentries};
+            bool found{false};
+            K nkey;
+            while (start < end) {
+                uint32_t const mid = start + (end - start) / 2;
+                nkey.deserialize(sisl::blob{this->node_data_area_const() + (obj_size * mid), get_nth_key_size(mid)},
+                                 false /* copy */);
+                auto const x = nkey.compare(key);
+                if (x < 0) {
+                    start = mid + 1;
+                } else {
+                    found = found || (x == 0);
+                    end = mid;
+                }
+            }
+            ret = std::make_pair(found && (start < nentries), start);
+        }
+
+        if (outval) {
+            if (ret.second < nentries) {
+                sisl::blob b{const_cast< uint8_t* >(this->node_data_area_const() + (obj_size * ret.second) +
+                                                    get_nth_key_size(ret.second)),
+                             dummy_value< V >.serialized_size()};
+                outval->deserialize(b, true /* copy */);
+            } else if (!this->is_leaf()) {
+                *r_cast< BtreeLinkInfo* >(outval) = this->get_edge_value();
+            }
+        }
+        return ret;
+    }
+
+protected:
+    node_find_result_t bsearch_node(const BtreeKey& key) const override {
+        if constexpr (is_integral_btree_key_v< K >) {
+            auto const ret = integral_bsearch(key, this->total_entries());
+            DEBUG_ASSERT(ret == BtreeNode::bsearch_node(key), "Integral key search mismatch with generic search");
+            return ret;
+        } else {
+            return BtreeNode::bsearch_node(key);
+        }
+    }
+
+private:
+    // Search for keys which are plain integers (see is_integral_btree_key). The keys are compared in place as integers
+    // instead of deserializing them into K and calling compare() on every probe. The binary search part selects the
+    // next half with a conditional move instead of a branch, so it is not subject to branch mispredictions, and once
+    // the remaining range fits in a few cache lines, it simply counts the smaller keys in a loop without any early
+    // exit, which the compiler is free to vectorize.
+    template < typename T = typename K::integral_key_t >
+    node_find_result_t integral_bsearch(const BtreeKey& key, uint32_t nentries) const {
+        static constexpr uint32_t linear_scan_size = 256;
+        auto const load = [](uint8_t const* p) {
+            T v;
+            std::memcpy(&v, p, sizeof(T));
+            return v;
+        };
+
+        sisl::blob const kb = key.serialize();
+        DEBUG_ASSERT_EQ(kb.size(), sizeof(T), "Integral key serialized size mismatch");
+        T const search_key = load(kb.cbytes());
+
+        uint8_t const* entries = this->node_data_area_const();
+        uint32_t const stride = dummy_key< K >.serialized_size() + dummy_value< V >.serialized_size();
+        uint32_t const linear_entries = std::max(linear_scan_size / stride, 1u);
+
+        // Invariant: the first key >= search_key is within [start, start + len]
+        uint32_t start{0};
+        uint32_t len{nentries};
+        while (len > linear_entries) {
+            uint32_t const half = len / 2;
+            start = (load(entries + (start + half - 1) * stride) < search_key) ? start + half : start;
+            len -= half;
+        }
+
+        uint32_t idx{start};
+        for (uint32_t i{0}; i < len; ++i) {
+            idx += (load(entries + (start + i) * stride) < search_key) ? 1u : 0u;
+        }
+        bool const found = (idx < nentries) && (load(entries + idx * stride) == search_key);
+        return std::make_pair(found, idx);
+    }
+
+public:
     /*int compare_nth_key_range(const BtreeKeyRange& range, uint32_t ind) const override {
         return get_nth_key(ind, false).compare_range(range);
     }*/
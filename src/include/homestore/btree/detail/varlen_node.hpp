@@ -771,4 +771,366 @@ private:
     };
 #pragma pack()
 };
+
+/***************** Template Specialization for prefix compressed variable object records ******************/
+// Keys of this node are stored as suffixes of a common prefix which is stored once per node, at the far end of the
+// data area. So the internal format is
+// [Persistent Header][var node header][Record][Record].. ...  ... [key suffix][value][key suffix][value][prefix]
+//
+// The prefix is the common prefix of all the keys of the node at the time the node was last rebuilt, which happens when
+// entries are moved out on split or copied in on merge. A key inserted afterwards which doesn't share the prefix is
+// stored in full and marked so in its record, hence inserts never need to reencode the other keys and the room needed
+// for a put is the same as in VarObjSizeNode.
+//
+// Sizes reported for rebalancing (occupied_size, num_entries_by_size) are the sizes as stored, prefix included. The
+// entries copied in on merge are reencoded against a prefix common to all of them, which can be shorter than the prefix
+// of either node, so copy_by_size and copy_by_entries plan the copy with reencoded_size and never copy more than fits.
+template < typename K, typename V >
+class VarPrefixNode : public VariableNode< K, V > {
+public:
+    VarPrefixNode(uint8_t* node_buf, bnodeid_t id, bool init, bool is_leaf, const BtreeConfig& cfg) :
+            VariableNode< K, V >(node_buf, id, init, is_leaf, cfg) {
+        this->set_node_type(btree_node_type::VAR_PREFIX);
+    }
+    virtual ~VarPrefixNode() = default;
+
+    btree_status_t insert(uint32_t ind, const BtreeKey& key, const BtreeValue& val) override {
+        LOGTRACEMOD(btree, "{}:{}", key.to_string(), val.to_string());
+        auto sz = insert_encoded(ind, key.serialize(), val.serialize());
+        return (sz == 0) ? btree_status_t::space_not_avail : btree_status_t::success;
+    }
+
+    void update(uint32_t ind, const BtreeKey& key, const BtreeValue& val) override {
+        DEBUG_ASSERT_LE(ind, this->total_entries());
+        if (ind == this->total_entries()) {
+            DEBUG_ASSERT_EQ(this->is_leaf(), false);
+            this->set_edge_value(val);
+            this->inc_gen();
+            return;
+        }
+
+        sisl::blob const kb = key.serialize();
+        sisl::blob const vb = val.serialize();
+        uint32_t const shared = shared_prefix_size(kb);
+        uint16_t const new_obj_size = kb.size() - shared + vb.size();
+        uint16_t const cur_obj_size = this->get_nth_obj_size(ind);
+        if (cur_obj_size >= new_obj_size) {
+            uint8_t* key_ptr = this->get_nth_obj_mutable(ind);
+            std::memmove(key_ptr, kb.cbytes() + shared, kb.size() - shared);
+            std::memmove(key_ptr + kb.size() - shared, vb.cbytes(), vb.size());
+
+            auto rec = r_cast< var_prefix_record* >(this->get_nth_record_mutable(ind));
+            rec->m_key_len = kb.size() - shared;
+            rec->m_full_key = (shared == 0) ? 1 : 0;
+            rec->m_value_len = vb.size();
+            this->get_var_node_header()->m_available_space += cur_obj_size - new_obj_size;
+            this->inc_gen();
+        } else {
+            this->remove(ind, ind);
+            insert(ind, key, val);
+        }
+    }
+
+    uint32_t occupied_size() const override { return capacity() - this->available_size(); }
+
+    uint32_t move_out_to_right_by_entries(const BtreeConfig& cfg, BtreeNode& o, uint32_t nentries) override {
+        nentries = std::min(nentries, this->total_entries());
+        if (nentries == 0) { return 0; }
+        move_out_to_right(static_cast< VarPrefixNode& >(o), this->total_entries() - nentries);
+        return nentries;
+    }
+
+    uint32_t move_out_to_right_by_size(const BtreeConfig& cfg, BtreeNode& o, uint32_t size_to_move) override {
+        // Split computes the size to move from the space used in this node, so it is accounted in stored sizes here
+        uint32_t ind = this->total_entries() - 1;
+        uint32_t nmoved{0};
+        while (ind > 0) {
+            uint32_t const sz = this->get_nth_obj_size(ind) + get_record_size();
+            if (sz > size_to_move) { break; }
+            size_to_move -= sz;
+            --ind;
+            ++nmoved;
+        }
+        if (nmoved != 0) { move_out_to_right(static_cast< VarPrefixNode& >(o), ind + 1); }
+        return nmoved;
+    }
+
+    uint32_t num_entries_by_size(uint32_t start_idx, uint32_t size) const override {
+        auto idx = start_idx;
+        uint32_t cum_size{0};
+        while (idx < this->total_entries()) {
+            cum_size += this->get_nth_obj_size(idx) + get_record_size();
+            if (cum_size > size) { break; }
+            ++idx;
+        }
+        return idx - start_idx;
+    }
+
+    uint32_t copy_by_size(const BtreeConfig& cfg, const BtreeNode& o, uint32_t start_idx, uint32_t copy_size) override {
+        auto& other = static_cast< const VarPrefixNode& >(o);
+        auto const max_size = std::min(capacity(), occupied_size() + copy_size);
+        return copy_in(other, start_idx, reencoded_size{*this}.num_fit(other, start_idx, max_size));
+    }
+
+    uint32_t copy_by_entries(const BtreeConfig& cfg, const BtreeNode& o, uint32_t start_idx,
+                             uint32_t nentries) override {
+        auto& other = static_cast< const VarPrefixNode& >(o);
+        nentries = std::min(nentries, other.total_entries() - start_idx);
+        return copy_in(other, start_idx, std::min(nentries, reencoded_size{*this}.num_fit(other, start_idx, capacity())));
+    }
+
+    void get_nth_key_internal(uint32_t ind, BtreeKey& out_key, bool copy) const override {
+        assert(ind < this->total_entries());
+        auto const rec = r_cast< const var_prefix_record* >(this->get_nth_record(ind));
+        if (rec->m_full_key || (prefix_size() == 0)) {
+            out_key.deserialize(sisl::blob{const_cast< uint8_t* >(this->get_nth_obj(ind)), rec->m_key_len}, copy);
+        } else {
+            // The key is not contiguous in the node, so it is always handed out as a copy
+            static thread_local std::vector< uint8_t > s_key_buf;
+            s_key_buf.assign(prefix_bytes(), prefix_bytes() + prefix_size());
+            s_key_buf.insert(s_key_buf.end(), this->get_nth_obj(ind), this->get_nth_obj(ind) + rec->m_key_len);
+            out_key.deserialize(sisl::blob{s_key_buf.data(), uint32_cast(s_key_buf.size())}, true);
+        }
+    }
+
+    uint32_t get_nth_key_size(uint32_t ind) const override {
+        return r_cast< const var_prefix_record* >(this->get_nth_record(ind))->m_key_len;
+    }
+    uint32_t get_nth_value_size(uint32_t ind) const override {
+        return r_cast< const var_prefix_record* >(this->get_nth_record(ind))->m_value_len;
+    }
+    uint32_t get_record_size() const override { return sizeof(var_prefix_record); }
+
+    void set_nth_key_len(uint8_t* rec_ptr, uint32_t key_len) override {
+        r_cast< var_prefix_record* >(rec_ptr)->m_key_len = key_len;
+        r_cast< var_prefix_record* >(rec_ptr)->m_full_key = m_insert_full_key ? 1 : 0;
+    }
+    void set_nth_value_len(uint8_t* rec_ptr, uint32_t value_len) override {
+        r_cast< var_prefix_record* >(rec_ptr)->m_value_len = value_len;
+    }
+
+    uint16_t prefix_size() const {
+        return this->node_data_size() - this->get_var_node_header_const()->m_init_available_space;
+    }
+
+    // Size a run of entries takes in a node once rebuilt against their common prefix, prefix and records included.
+    // Entries are added in key order from one or more nodes, so merge can plan how many of them fit in a node before
+    // copying anything.
+    class reencoded_size {
+    public:
+        reencoded_size() = default;
+        explicit reencoded_size(const VarPrefixNode& node) { add(node, 0, node.total_entries()); }
+
+        uint32_t size() const {
+            if (m_nentries == 0) { return 0; }
+            auto const psize = uint32_cast(m_prefix.size());
+            return uint32_cast(psize + m_key_size - uint64_t{m_nentries} * psize + m_value_size +
+                               uint64_t{m_nentries} * sizeof(var_prefix_record));
+        }
+
+        void add(const VarPrefixNode& node, uint32_t start_idx, uint32_t n) {
+            for (auto i{start_idx}; i < start_idx + n; ++i) {
+                add_one(node, i);
+            }
+        }
+
+        // Number of entries of the node from start_idx onwards which can be added without the size exceeding max_size
+        uint32_t num_fit(const VarPrefixNode& node, uint32_t start_idx, uint32_t max_size) const {
+            reencoded_size tmp{*this};
+            uint32_t n{0};
+            for (auto i{start_idx}; i < node.total_entries(); ++i, ++n) {
+                tmp.add_one(node, i);
+                if (tmp.size() > max_size) { break; }
+            }
+            return n;
+        }
+
+    private:
+        void add_one(const VarPrefixNode& node, uint32_t ind) {
+            auto const rec = r_cast< const var_prefix_record* >(node.get_nth_record(ind));
+            auto const key_prefix_size = rec->m_full_key ? 0u : uint32_t{node.prefix_size()};
+            if (m_nentries == 0) {
+                m_prefix.assign(node.prefix_bytes(), node.prefix_bytes() + key_prefix_size);
+                m_prefix.insert(m_prefix.end(), node.get_nth_obj(ind), node.get_nth_obj(ind) + rec->m_key_len);
+            } else {
+                // Common prefix can only shrink, compare the key against it in its prefix and suffix parts
+                uint32_t len{0};
+                auto const max_len = std::min(uint32_cast(m_prefix.size()), key_prefix_size + rec->m_key_len);
+                while ((len < max_len) &&
+                       (m_prefix[len] == ((len < key_prefix_size) ? node.prefix_bytes()[len]
+                                                                  : node.get_nth_obj(ind)[len - key_prefix_size]))) {
+                    ++len;
+                }
+                m_prefix.resize(len);
+            }
+            ++m_nentries;
+            m_key_size += key_prefix_size + rec->m_key_len;
+            m_value_size += rec->m_value_len;
+        }
+
+    private:
+        std::vector< uint8_t > m_prefix; // Common prefix of all keys added so far
+        uint32_t m_nentries{0};
+        uint64_t m_key_size{0};
+        uint64_t m_value_size{0};
+    };
+
+private:
+#pragma pack(1)
+    struct var_prefix_record : public btree_obj_record {
+        uint16_t m_key_len : 14;
+        uint16_t m_full_key : 1; // Key is stored in full instead of as a suffix of the node prefix
+        uint16_t reserved : 1;
+
+        uint16_t m_value_len : 14;
+        uint16_t reserved2 : 2;
+    };
+#pragma pack()
+
+    // Full keys and values of a run of entries, copied out so that a node can be rebuilt from them
+    struct entry_list {
+        struct entry {
+            uint32_t offset;
+            uint32_t key_size;
+            uint32_t value_size;
+        };
+        std::vector< uint8_t > buf;
+        std::vector< entry > entries;
+
+        uint32_t size() const { return entries.size(); }
+        sisl::blob key(uint32_t i) const {
+            return sisl::blob{const_cast< uint8_t* >(buf.data()) + entries[i].offset, entries[i].key_size};
+        }
+        sisl::blob value(uint32_t i) const {
+            return sisl::blob{const_cast< uint8_t* >(buf.data()) + entries[i].offset + entries[i].key_size,
+                              entries[i].value_size};
+        }
+    };
+
+    const uint8_t* prefix_bytes() const {
+        return this->offset_to_ptr(this->get_var_node_header_const()->m_init_available_space);
+    }
+
+    // Space in the data area for the prefix, records and objects
+    uint32_t capacity() const { return this->node_data_size() - sizeof(var_node_header); }
+
+    // Number of leading bytes of the key covered by the node prefix, 0 if the key has to be stored in full
+    uint32_t shared_prefix_size(sisl::blob const& kb) const {
+        auto const psize = prefix_size();
+        if ((psize == 0) || (kb.size() < psize) || (std::memcmp(kb.cbytes(), prefix_bytes(), psize) != 0)) {
+            return 0;
+        }
+        return psize;
+    }
+
+    uint32_t insert_encoded(uint32_t ind, sisl::blob const& kb, sisl::blob const& vb) {
+        uint32_t const shared = shared_prefix_size(kb);
+        m_insert_full_key = (shared == 0);
+        return VariableNode< K, V >::insert(ind, sisl::blob{kb.cbytes() + shared, kb.size() - shared}, vb);
+    }
+
+    void collect_entries(uint32_t start_ind, uint32_t end_ind, entry_list& out) const {
+        for (uint32_t i{start_ind}; i < end_ind; ++i) {
+            auto const rec = r_cast< const var_prefix_record* >(this->get_nth_record(i));
+            auto const offset = uint32_cast(out.buf.size());
+            auto const key_prefix_size = rec->m_full_key ? 0u : uint32_t{prefix_size()};
+            out.buf.insert(out.buf.end(), prefix_bytes(), prefix_bytes() + key_prefix_size);
+            out.buf.insert(out.buf.end(), this->get_nth_obj(i),
+                           this->get_nth_obj(i) + rec->m_key_len + rec->m_value_len);
+            out.entries.push_back({offset, key_prefix_size + rec->m_key_len, rec->m_value_len});
+        }
+    }
+
+    static uint32_t common_prefix_size(entry_list const& el) {
+        if (el.size() == 0) { return 0; }
+        auto const first = el.key(0);
+        uint32_t len = first.size();
+        for (uint32_t i{1}; (i < el.size()) && (len != 0); ++i) {
+            auto const k = el.key(i);
+            len = std::min(len, k.size());
+            uint32_t j{0};
+            while ((j < len) && (k.cbytes()[j] == first.cbytes()[j])) {
+                ++j;
+            }
+            len = j;
+        }
+        return len;
+    }
+
+    // Rewrite the node with the given entries, keeping their common prefix only once. Edge info is left as is.
+    void rebuild(entry_list const& el, uint32_t psize) {
+        auto hdr = this->get_var_node_header();
+        this->sub_entries(this->total_entries());
+        hdr->m_init_available_space = this->node_data_size() - psize;
+        hdr->m_tail_arena_offset = hdr->m_init_available_space;
+        hdr->m_available_space = hdr->m_init_available_space - sizeof(var_node_header);
+        if (psize != 0) {
+            std::memcpy(this->offset_to_ptr_mutable(hdr->m_init_available_space), el.key(0).cbytes(), psize);
+        }
+        for (uint32_t i{0}; i < el.size(); ++i) {
+            auto const sz = insert_encoded(i, el.key(i), el.value(i));
+            RELEASE_ASSERT_NE(sz, 0, "Rebuild of node with {} entries and prefix size {} doesn't fit entry {}",
+                              el.size(), psize, i);
+        }
+    }
+
+    // Rebuild the node if reencoding its entries against their common prefix takes less space. The remaining entries
+    // after a split could share a longer prefix or the keys stored in full could share the prefix again.
+    void compress() {
+        entry_list el;
+        collect_entries(0, this->total_entries(), el);
+        auto const psize = common_prefix_size(el);
+        uint32_t new_size = psize;
+        for (uint32_t i{0}; i < el.size(); ++i) {
+            new_size += el.key(i).size() - psize + el.value(i).size() + get_record_size();
+        }
+        if (new_size < occupied_size()) {
+            rebuild(el, psize);
+        }
+    }
+
+    // Moves the entries from start_ind onwards to the front of the other node. The other node is rebuilt right away
+    // against the common prefix of all its entries instead of inserting the moved keys in full.
+    void move_out_to_right(VarPrefixNode& other, uint32_t start_ind) {
+        auto const this_gen = this->node_gen();
+        auto const other_gen = other.node_gen();
+
+        entry_list el;
+        collect_entries(start_ind, this->total_entries(), el);
+        other.collect_entries(0, other.total_entries(), el);
+        other.rebuild(el, common_prefix_size(el));
+
+        if (!this->is_leaf() && (other.total_entries() != 0)) {
+            // Incase this node is an edge node, move the stick to the right hand side node
+            other.set_edge_info(this->edge_info());
+            this->invalidate_edge();
+        }
+
+        this->remove(start_ind, this->total_entries() - 1);
+        compress();
+
+        this->set_gen(this_gen + 1);
+        other.set_gen(other_gen + 1);
+    }
+
+    uint32_t copy_in(const VarPrefixNode& other, uint32_t start_idx, uint32_t n) {
+        auto const this_gen = this->node_gen();
+        if (n != 0) {
+            entry_list el;
+            collect_entries(0, this->total_entries(), el);
+            other.collect_entries(start_idx, start_idx + n, el);
+            rebuild(el, common_prefix_size(el));
+        }
+        this->set_gen(this_gen + 1);
+
+        // If we copied everything from start_idx till end and if its an edge node, need to copy the edge id as well.
+        if (other.has_valid_edge() && ((start_idx + n) == other.total_entries())) {
+            this->set_edge_info(other.edge_info());
+        }
+        return n;
+    }
+
+private:
+    bool m_insert_full_key{true}; // Marks the record being inserted, see set_nth_key_len
+};
 } // namespace homestore
@@ -14,6 +14,8 @@
  *
  *********************************************************************************/
 #pragma once
+#include <mutex>
+
 #ifdef StoreSpecificBtreeNode
 #undef StoreSpecificBtreeNode
 #endif
@@ -28,6 +30,11 @@ class MemBtree : public Btree< K, V > {
 private:
     std::vector< std::shared_ptr< uint8_t[] > > node_buf_ptr_vec;
 
+    // Freed nodes are kept around while lock free readers are in flight, since they could still be holding a node id
+    // read from its parent just before it was freed. They are released by the next free with no reader in flight.
+    std::mutex m_retired_mtx;
+    std::vector< BtreeNodePtr > m_retired_nodes;
+
 public:
     MemBtree(const BtreeConfig& cfg) : Btree< K, V >(cfg) {
         BT_LOG(INFO, "New {} being created: Node size {}", btree_store_type(), cfg.node_size());
@@ -41,6 +48,7 @@ public:
     }
 
     std::string btree_store_type() const override { return "MEM_BTREE"; }
+    bool can_drop_subtrees() const override { return true; }
 
 private:
     BtreeNodePtr alloc_node(bool is_leaf) override {
@@ -64,7 +72,22 @@ private:
         return btree_status_t::success;
     }
 
-    void free_node_impl(const BtreeNodePtr& node, void* context) override { intrusive_ptr_release(node.get()); }
+    btree_status_t read_cached_node_impl(bnodeid_t id, BtreeNodePtr& node) const override {
+        return read_node_impl(id, node);
+    }
+
+    void free_node_impl(const BtreeNodePtr& node, void* context) override {
+        std::vector< BtreeNodePtr > reclaimed;
+        {
+            std::lock_guard lg(m_retired_mtx);
+            m_retired_nodes.push_back(node);
+
+            // The node is unlinked from its parent by now, so a reader which starts after this point can't reach it
+            // and the ones in flight are counted
+            if (this->m_optimistic_readers.load() == 0) { reclaimed.swap(m_retired_nodes); }
+        }
+        intrusive_ptr_release(node.get());
+    }
 
     btree_status_t transact_nodes(const BtreeNodeList& new_nodes, const BtreeNodeList& freed_nodes,
                                   const BtreeNodePtr& left_child_node, const BtreeNodePtr& parent_node,
@@ -73,7 +96,7 @@ private:
             this->write_node(node, context);
         }
         this->write_node(left_child_node, context);
-        this->write_node(parent_node, context);
+        if (parent_node) { this->write_node(parent_node, context); }
 
         for (const auto& node : freed_nodes) {
             this->free_node(node, locktype_t::WRITE, context);
@@ -0,0 +1,203 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+#include <sisl/fds/buffer.hpp>
+
+namespace homestore {
+
+/*
+ * In-memory blocked bloom filter of the keys of an IndexTable, which answers the point lookups of missing keys without
+ * walking down the tree. Every key maps to one 64 byte block and sets num_probes bits within it, so a lookup touches
+ * a single cache line. Adds and lookups are lock free.
+ *
+ * Bits can't be cleared, so removed keys are dropped only by a rebuild. The filter has two bit arrays of half the
+ * memory budget each. Lookups use the active one, while a rebuild fills the other one from a scan of the tree. Keys
+ * added while the rebuild is going on are set in both, and the arrays are swapped once the scan is done.
+ *
+ * A key is added before it is inserted in the tree, so that a lookup never misses a key it can find in the tree. The
+ * scan of a rebuild started in between can miss the key though, so the key is set again after the insert if that
+ * happened, see added().
+ *
+ * Writes which can't add their keys (range puts, bulk load, recovery) make the filter unusable until it is rebuilt
+ * after the last of them is done, see begin_unfiltered_write().
+ */
+class IndexBloomFilter {
+public:
+    static constexpr uint32_t block_size{64};
+    static constexpr uint32_t num_probes{6};
+
+    explicit IndexBloomFilter(uint64_t size) : m_nblocks{std::max(size / (2 * block_size), uint64_t{1})} {
+        for (auto& bits : m_bits) {
+            bits = std::make_unique< std::atomic< uint64_t >[] >(m_nblocks * words_per_block);
+        }
+    }
+
+    IndexBloomFilter(const IndexBloomFilter&) = delete;
+    IndexBloomFilter& operator=(const IndexBloomFilter&) = delete;
+
+    /// @brief Add the key, before it is inserted in the tree.
+    /// @return Token to be passed to added() once the key is in the tree
+    uint64_t add(sisl::blob const& key) {
+        // Rebuild generation has to be read before the rebuild flag, which is set before the generation is bumped
+        auto const token = m_rebuild_gen.load();
+        if (add_bits(hash(key))) { m_rebuild_num_keys.fetch_add(1, std::memory_order_relaxed); }
+        m_num_keys.fetch_add(1, std::memory_order_relaxed);
+        return token;
+    }
+
+    /// @brief Called once the key added with the token is in the tree. A rebuild which started in between could have
+    /// scanned the tree ahead of the insert, in which case the key is set again in the arrays in use.
+    void added(sisl::blob const& key, uint64_t token) {
+        if (m_rebuild_gen.load() != token) { add_bits(hash(key)); }
+    }
+
+    /// @brief Returns false if the key is definitely not in the tree. Caller needs to check is_usable() first.
+    bool may_contain(sisl::blob const& key) const {
+        auto const h = hash(key);
+        auto const* block = &m_bits[m_active.load()][block_of(h) * words_per_block];
+        for (uint32_t i{0}; i < num_probes; ++i) {
+            auto const bit = probe_bit(h, i);
+            if ((block[bit / 64].load(std::memory_order_relaxed) & (1ull << (bit % 64))) == 0) { return false; }
+        }
+        return true;
+    }
+
+    bool is_usable() const { return m_usable.load(); }
+
+    /// @brief Returns true if the keys removed since the last rebuild just went past rebuild_pct of the keys added.
+    bool on_keys_removed(uint64_t n, uint8_t rebuild_pct) {
+        auto const old_removed = m_num_removed.fetch_add(n, std::memory_order_relaxed);
+        auto const threshold = m_num_keys.load(std::memory_order_relaxed) * rebuild_pct;
+        return ((old_removed * 100) <= threshold) && (((old_removed + n) * 100) > threshold);
+    }
+
+    void begin_unfiltered_write() {
+        std::unique_lock lg{m_mtx};
+        ++m_unfiltered_writes;
+        ++m_unfiltered_gen;
+        m_usable.store(false);
+    }
+
+    void end_unfiltered_write() {
+        std::unique_lock lg{m_mtx};
+        --m_unfiltered_writes;
+        ++m_unfiltered_gen;
+    }
+
+    /// @brief Start a rebuild, after which the caller scans the tree and adds every key with add_to_rebuild(). Only one
+    /// rebuild is expected to be running at a time.
+    /// @return Token to be passed to finish_rebuild()
+    uint64_t start_rebuild() {
+        auto const inactive = m_active.load() ^ 1;
+        for (uint64_t w{0}; w < m_nblocks * words_per_block; ++w) {
+            m_bits[inactive][w].store(0, std::memory_order_relaxed);
+        }
+        m_rebuild_num_keys.store(0);
+
+        std::unique_lock lg{m_mtx};
+        m_rebuilding.store(true);
+        m_rebuild_gen.fetch_add(1);
+        // Writes which started before the scan could insert keys behind it, so the filter can't be used after this
+        // rebuild if there is any of them
+        return (m_unfiltered_writes == 0) ? m_unfiltered_gen : invalid_token;
+    }
+
+    void add_to_rebuild(sisl::blob const& key) {
+        set_bits(m_active.load() ^ 1, hash(key));
+        m_rebuild_num_keys.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Swap in the rebuilt array. Returns true if the filter is usable after the rebuild.
+    bool finish_rebuild(uint64_t token) {
+        std::unique_lock lg{m_mtx};
+        m_active.store(m_active.load() ^ 1);
+        m_num_keys.store(m_rebuild_num_keys.load());
+        m_num_removed.store(0);
+        m_rebuilding.store(false);
+        m_usable.store(token == m_unfiltered_gen);
+        return m_usable.load();
+    }
+
+    /// @brief Memory used by the filter in bytes
+    uint64_t size() const { return 2 * m_nblocks * block_size; }
+    uint64_t num_keys() const { return m_num_keys.load(std::memory_order_relaxed); }
+
+    /// @brief Estimated false positive rate for the number of keys added since the last rebuild
+    double false_positive_rate() const {
+        double const bits_per_key = double(m_nblocks * block_size * 8) / std::max(num_keys(), uint64_t{1});
+        return std::pow(1.0 - std::exp(-double(num_probes) / bits_per_key), num_probes);
+    }
+
+private:
+    static constexpr uint32_t words_per_block{block_size / sizeof(uint64_t)};
+    static constexpr uint64_t invalid_token{std::numeric_limits< uint64_t >::max()};
+
+    static uint64_t hash(sisl::blob const& key) {
+        return std::hash< std::string_view >{}(
+            std::string_view{reinterpret_cast< const char* >(key.cbytes()), key.size()});
+    }
+
+    uint64_t block_of(uint64_t h) const { return uint64_t((__uint128_t(h) * m_nblocks) >> 64); }
+
+    // Probes take 9 bits each of the rehashed key, to address a bit within the 512 bit block
+    static uint32_t probe_bit(uint64_t h, uint32_t i) {
+        return uint32_t(((h * 0x9E3779B97F4A7C15ull) >> (i * 9)) & (block_size * 8 - 1));
+    }
+
+    // If the rebuild is found not started, its scan of the tree is yet to start. Otherwise the key is set in both of the
+    // arrays. Returns true if the key was set in the array being rebuilt.
+    bool add_bits(uint64_t h) {
+        bool const rebuilding = m_rebuilding.load();
+        auto const active = m_active.load();
+        set_bits(active, h);
+        if (rebuilding) { set_bits(active ^ 1, h); }
+        return rebuilding;
+    }
+
+    void set_bits(uint32_t which, uint64_t h) {
+        auto* block = &m_bits[which][block_of(h) * words_per_block];
+        for (uint32_t i{0}; i < num_probes; ++i) {
+            auto const bit = probe_bit(h, i);
+            block[bit / 64].fetch_or(1ull << (bit % 64), std::memory_order_relaxed);
+        }
+    }
+
+private:
+    uint64_t const m_nblocks;
+    std::unique_ptr< std::atomic< uint64_t >[] > m_bits[2];
+    std::atomic< uint32_t > m_active{0};
+    std::atomic_bool m_rebuilding{false};
+    std::atomic< uint64_t > m_rebuild_gen{0};
+    std::atomic_bool m_usable{true};
+    std::atomic< uint64_t > m_num_keys{0};
+    std::atomic< uint64_t > m_num_removed{0};
+    std::atomic< uint64_t > m_rebuild_num_keys{0};
+
+    std::mutex m_mtx; // Serializes the unfiltered writes with the start and finish of a rebuild
+    uint32_t m_unfiltered_writes{0};
+    uint64_t m_unfiltered_gen{0};
+};
+} // namespace homestore
@@ -99,6 +99,7 @@ public:
     virtual void update_sb() = 0;
     virtual void load_metrics(uint64_t interior, uint64_t leaf, uint8_t depth) = 0;
     virtual bool sanity_check(const IndexBufferPtrList& bufs) const = 0;
+    virtual uint32_t merge_underfull_nodes(uint32_t max_merges) = 0;
 };
 
 enum class index_buf_state_t : uint8_t {
@@ -138,6 +139,9 @@ struct IndexBuffer : public sisl::ObjLifeCounter< IndexBuffer > {
     uint8_t m_is_meta_buf{false}; // Is the index buffer writing to metablk?
     bool m_node_freed{false};
 
+    std::atomic< uint64_t > m_write_gen{0};    // Bumped on every write of the node in this buffer
+    std::atomic< uint64_t > m_trickled_gen{0}; // Write generation which was trickle flushed ahead of the CP
+
     IndexBuffer(BlkId blkid, uint32_t buf_size, uint32_t align_size);
     IndexBuffer(uint8_t* raw_bytes, BlkId blkid);
     virtual ~IndexBuffer();
@@ -17,7 +17,9 @@
 
 #include <vector>
 #include <atomic>
+#include <optional>
 #include <homestore/index/index_internal.hpp>
+#include <homestore/index/index_bloom_filter.hpp>
 #include <homestore/btree/btree.ipp>
 #include <homestore/superblk_handler.hpp>
 #include <homestore/index_service.hpp>
@@ -48,6 +50,11 @@ private:
 
     uint64_t get_pending_request_num() const { return pending_request_num.load(); }
 
+    // Filter of point lookups, null if it is not enabled in the config
+    std::unique_ptr< IndexBloomFilter > m_bloom;
+    std::atomic_bool m_bloom_rebuild_running{false};
+    std::atomic_bool m_bloom_rebuild_pending{false};
+
     void incr_pending_request_num() const { pending_request_num++; }
     void decr_pending_request_num() const { pending_request_num--; }
 
@@ -64,6 +71,7 @@ public:
                uint32_t ordinal = INVALID_ORDINAL, const std::vector< chunk_num_t >& chunk_ids = {},
                uint32_t pdev_id = 0, uint64_t max_size_bytes = 0) :
             Btree< K, V >{cfg}, m_sb{"index"} {
+        if (cfg.m_bloom_filter_size != 0) { m_bloom = std::make_unique< IndexBloomFilter >(cfg.m_bloom_filter_size); }
         uint32_t ord_num = INVALID_ORDINAL;
         if (ordinal != INVALID_ORDINAL) {
             BT_LOG_ASSERT(!hs()->index_service().get_index_table(ordinal), "table with ordinal {} already exists",
@@ -94,6 +102,11 @@ public:
 
     IndexTable(superblk< index_table_sb >&& sb, const BtreeConfig& cfg) : Btree< K, V >{cfg}, m_sb{std::move(sb)} {
         m_sb_buffer = std::make_shared< MetaIndexBuffer >(m_sb);
+        if (cfg.m_bloom_filter_size != 0) {
+            // Filter is built from the tree once the recovery is completed
+            m_bloom = std::make_unique< IndexBloomFilter >(cfg.m_bloom_filter_size);
+            m_bloom->begin_unfiltered_write();
+        }
 
         // After recovery, we see that root node is empty, which means that after btree is created, we crashed.
         // So create new root node, which is essential for btree to function.
@@ -102,6 +115,13 @@ public:
         }
     }
 
+    ~IndexTable() override {
+        // Prefetches and the filter rebuild run in the background with this table captured
+        while (get_pending_request_num()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
     void recovery_completed() override {
         if (m_sb->root_node == empty_bnodeid) {
             // After recovery, we see that root node is empty, which means that after btree is created, we crashed.
@@ -112,6 +132,10 @@ public:
                 throw std::runtime_error(fmt::format("Unable to create root node"));
             }
         }
+        if (m_bloom) {
+            m_bloom->end_unfiltered_write();
+            schedule_bloom_rebuild();
+        }
     }
 
     void audit_tree() const override {
@@ -157,6 +181,22 @@ public:
     btree_status_t put(ReqT& put_req) {
         if (is_stopping()) return btree_status_t::stopping;
         incr_pending_request_num();
+        // Keys of a range put are not known individually, so the filter can't be used until it is rebuilt afterwards
+        bool const unfiltered = m_bloom && !std::is_same_v< ReqT, BtreeSinglePutRequest > &&
+            !std::is_same_v< ReqT, BtreeMultiPutRequest< K > >;
+        if (unfiltered) { m_bloom->begin_unfiltered_write(); }
+        // Keys are added ahead of the insert, so that a concurrent get of a key already in the tree is never filtered
+        uint64_t bloom_token{0};
+        if (m_bloom && !unfiltered) {
+            if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest >) {
+                bloom_token = m_bloom->add(put_req.key().serialize());
+            } else if constexpr (std::is_same_v< ReqT, BtreeMultiPutRequest< K > >) {
+                for (uint32_t i{0}; i < put_req.num_keys(); ++i) {
+                    auto const token = m_bloom->add(put_req.nth_key(i).serialize());
+                    if (i == 0) { bloom_token = token; }
+                }
+            }
+        }
         auto ret = btree_status_t::success;
         do {
             auto cpg = cp_mgr().cp_guard();
@@ -167,6 +207,20 @@ public:
                 COUNTER_INCREMENT(this->m_metrics, btree_retry_count, 1);
             }
         } while (ret == btree_status_t::cp_mismatch);
+
+        if (unfiltered) {
+            m_bloom->end_unfiltered_write();
+            schedule_bloom_rebuild();
+        } else if (m_bloom) {
+            // A rebuild which started after the keys were added could have scanned the tree ahead of the insert
+            if constexpr (std::is_same_v< ReqT, BtreeSinglePutRequest >) {
+                m_bloom->added(put_req.key().serialize(), bloom_token);
+            } else if constexpr (std::is_same_v< ReqT, BtreeMultiPutRequest< K > >) {
+                for (uint32_t i{0}; i < put_req.num_keys(); ++i) {
+                    m_bloom->added(put_req.nth_key(i).serialize(), bloom_token);
+                }
+            }
+        }
         decr_pending_request_num();
         return ret;
     }
@@ -185,6 +239,51 @@ public:
                 COUNTER_INCREMENT(this->m_metrics, btree_retry_count, 1);
             }
         } while (ret == btree_status_t::cp_mismatch);
+
+        if (m_bloom && (ret == btree_status_t::success)) {
+            // Removed keys stay in the filter till it is rebuilt. Keys removed by a range remove are not known, so
+            // they are not accounted for, rebuild_bloom_filter() can be called explicitly after large range removes.
+            uint64_t nremoved{1};
+            if constexpr (std::is_same_v< ReqT, BtreeMultiRemoveRequest< K > >) {
+                auto const& statuses = remove_req.statuses();
+                nremoved = std::count(statuses.begin(), statuses.end(), btree_status_t::success);
+            } else if constexpr (std::is_same_v< ReqT, BtreeRangeRemoveRequest< K > >) {
+                nremoved = 0;
+            }
+            if (m_bloom->on_keys_removed(nremoved, this->m_bt_cfg.m_bloom_filter_rebuild_pct)) {
+                schedule_bloom_rebuild();
+            }
+        }
+        decr_pending_request_num();
+        return ret;
+    }
+
+    /// @brief Build an empty index table bottom-up from a sorted stream instead of a put per key. Nodes are packed up
+    /// to fill_pct percent (0 means the configured ideal fill pct) and written through the wb cache. The whole load is
+    /// done under a single CP guard and the new tree is installed in place of the empty root at the end of it, so the
+    /// CP persists either all of the loaded keys or, after a crash, none of them. The CP being flushed waits for the
+    /// load to complete.
+    /// @param begin, end Iterators over std::pair< K, V > in strictly ascending order of keys
+    /// @return not_supported if the table is not empty or input is not sorted, space_not_avail if nodes can't be
+    /// allocated, success otherwise. On failure the table is left empty and the load can be retried.
+    template < typename IterT >
+    btree_status_t bulk_load(IterT begin, IterT end, uint8_t fill_pct = 0) {
+        if (is_stopping()) return btree_status_t::stopping;
+        incr_pending_request_num();
+        if (m_bloom) { m_bloom->begin_unfiltered_write(); }
+        auto ret = btree_status_t::success;
+        do {
+            auto cpg = cp_mgr().cp_guard();
+            ret = Btree< K, V >::bulk_load(begin, end, fill_pct, (void*)cpg.context(cp_consumer_t::INDEX_SVC));
+            if (ret == btree_status_t::cp_mismatch) {
+                LOGTRACEMOD(wbcache, "CP Mismatch, retrying bulk load");
+                COUNTER_INCREMENT(this->m_metrics, btree_retry_count, 1);
+            }
+        } while (ret == btree_status_t::cp_mismatch);
+        if (m_bloom) {
+            m_bloom->end_unfiltered_write();
+            schedule_bloom_rebuild();
+        }
         decr_pending_request_num();
         return ret;
     }
@@ -193,11 +292,69 @@ public:
     btree_status_t get(ReqT& greq) const {
         if (is_stopping()) return btree_status_t::stopping;
         incr_pending_request_num();
+        bool filtered{false};
+        if constexpr (std::is_same_v< ReqT, BtreeSingleGetRequest >) {
+            if (m_bloom && m_bloom->is_usable()) {
+                if (!m_bloom->may_contain(greq.key().serialize())) {
+                    COUNTER_INCREMENT(this->m_metrics, btree_bloom_filter_negatives, 1);
+                    decr_pending_request_num();
+                    return btree_status_t::not_found;
+                }
+                filtered = true;
+            }
+        }
         auto ret = Btree< K, V >::get(greq);
+        if (filtered && (ret == btree_status_t::not_found)) {
+            COUNTER_INCREMENT(this->m_metrics, btree_bloom_filter_false_positives, 1);
+        }
         decr_pending_request_num();
         return ret;
     }
 
+    /// @brief Rebuild the filter of point lookups from a scan of the tree, which drops the removed keys from it. It is
+    /// scheduled in the background when needed, calling it directly is useful only after large range removes.
+    /// @return false if the filter is not enabled or a rebuild is already running, which will then run once again
+    bool rebuild_bloom_filter() {
+        if (!m_bloom) { return false; }
+        if (m_bloom_rebuild_running.exchange(true)) {
+            m_bloom_rebuild_pending = true;
+            return false;
+        }
+        do_bloom_rebuild();
+        m_bloom_rebuild_running = false;
+        if (m_bloom_rebuild_pending.exchange(false)) { schedule_bloom_rebuild(); }
+        return true;
+    }
+
+    /// @brief Merge up to max_merges of the underfull nodes recorded by removes, when merges are lazy. Called by the
+    /// index service in the background.
+    /// @return Number of merges done
+    uint32_t merge_underfull_nodes(uint32_t max_merges) override {
+        if (!this->m_bt_cfg.m_lazy_merge || is_stopping()) { return 0; }
+        incr_pending_request_num();
+        uint32_t nmerged{0};
+        for (uint32_t i{0}; (i < max_merges) && !is_stopping(); ++i) {
+            auto ret = btree_status_t::success;
+            do {
+                auto cpg = cp_mgr().cp_guard();
+                ret = this->merge_next_candidate((void*)cpg.context(cp_consumer_t::INDEX_SVC));
+            } while (ret == btree_status_t::cp_mismatch);
+            if (ret == btree_status_t::not_found) { break; }
+            if (ret == btree_status_t::success) { ++nmerged; }
+        }
+        decr_pending_request_num();
+        return nmerged;
+    }
+
+    /// @brief Memory used by the filter of point lookups in bytes, 0 if it is not enabled
+    uint64_t bloom_filter_size() const { return m_bloom ? m_bloom->size() : 0; }
+
+    /// @brief Estimated false positive rate of the filter of point lookups, 1 if it is not enabled or is not usable
+    /// until it is rebuilt
+    double bloom_filter_fpr() const {
+        return (m_bloom && m_bloom->is_usable()) ? m_bloom->false_positive_rate() : 1.0;
+    }
+
     void repair_root_node(IndexBufferPtr const& idx_buf) override {
         LOGTRACEMOD(wbcache, "check if this was the previous root node {} for buf {} ", m_sb->root_node,
                     idx_buf->to_string());
@@ -283,6 +440,33 @@ public:
         }
     }
 
+private:
+    void schedule_bloom_rebuild() {
+        if (m_bloom_rebuild_running.exchange(true)) {
+            m_bloom_rebuild_pending = true;
+            return;
+        }
+        incr_pending_request_num();
+        // Scan of the tree reads nodes synchronously, so run it on a fiber which can do blocking io
+        iomanager.run_on_forget(cp_mgr().pick_blocking_io_fiber(), [this]() {
+            do {
+                m_bloom_rebuild_pending = false;
+                do_bloom_rebuild();
+                m_bloom_rebuild_running = false;
+            } while (m_bloom_rebuild_pending.load() && !is_stopping() && !m_bloom_rebuild_running.exchange(true));
+            decr_pending_request_num();
+        });
+    }
+
+    void do_bloom_rebuild() {
+        auto const token = m_bloom->start_rebuild();
+        this->visit_keys([this](K const& key) { m_bloom->add_to_rebuild(key.serialize()); });
+        bool const usable = m_bloom->finish_rebuild(token);
+        COUNTER_INCREMENT(this->m_metrics, btree_bloom_filter_rebuilds, 1);
+        LOGDEBUGMOD(wbcache, "Rebuilt bloom filter of index table ordinal={} keys={} size={} est_fpr={:.4f} usable={}",
+                    ordinal(), m_bloom->num_keys(), m_bloom->size(), m_bloom->false_positive_rate(), usable);
+    }
+
 protected:
     ////////////////// Override Implementation of underlying store requirements //////////////////
     BtreeNodePtr alloc_node(bool is_leaf) override {
@@ -298,10 +482,18 @@ protected:
         auto idx_node = static_cast< IndexBtreeNode* >(node.get());
 
         node->set_checksum();
+        idx_node->m_idx_buf->m_write_gen.fetch_add(1);
         auto prev_state = idx_node->m_idx_buf->m_state.exchange(index_buf_state_t::DIRTY);
         idx_node->m_idx_buf->m_node_level = node->level();
         if (prev_state == index_buf_state_t::CLEAN) {
             // It was clean before, dirtying it first time, add it to the wb_cache list to flush
+            if ((idx_node->m_idx_buf->m_created_cp_id != -1) && (idx_node->m_idx_buf->m_write_gen.load() == 1) &&
+                (idx_node->m_idx_buf->m_created_cp_id > cp_ctx->id())) {
+                // New node written the first time by an op holding on to an older cp, which was switched over after
+                // the op started (bulk load holds its cp for the whole load). It belongs to the cp of the writer.
+                idx_node->m_idx_buf->m_created_cp_id = cp_ctx->id();
+                idx_node->m_idx_buf->m_dirtied_cp_id = cp_ctx->id();
+            }
             if (idx_node->m_idx_buf->m_dirtied_cp_id != -1) {
                 BT_DBG_ASSERT_EQ(idx_node->m_idx_buf->m_dirtied_cp_id, cp_ctx->id(),
                                  "Writing a node which was not acquired by this cp");
@@ -347,17 +539,32 @@ protected:
 
     btree_status_t read_node_impl(bnodeid_t id, BtreeNodePtr& node) const override {
         try {
-            wb_cache().read_buf(id, node, [this](const IndexBufferPtr& idx_buf) mutable -> BtreeNodePtr {
-                bool is_leaf = BtreeNode::identify_leaf_node(idx_buf->raw_buffer());
-                BtreeNode* n = this->init_node(idx_buf->raw_buffer(), idx_buf->blkid().to_integer(),
-                                               false /* init_buf */, is_leaf);
-                static_cast< IndexBtreeNode* >(n)->attach_buf(idx_buf);
-                return BtreeNodePtr{n};
-            });
+            wb_cache().read_buf(id, node, [this](const IndexBufferPtr& idx_buf) { return node_from_buf(idx_buf); });
             return btree_status_t::success;
         } catch (std::exception& e) { return btree_status_t::node_read_failed; }
     }
 
+    btree_status_t read_cached_node_impl(bnodeid_t id, BtreeNodePtr& node) const override {
+        return wb_cache().get_cached_buf(id, node) ? btree_status_t::success : btree_status_t::not_found;
+    }
+
+    void prefetch_nodes(std::vector< bnodeid_t > const& node_ids) const override {
+        // Reads complete in the background with this table captured, so they are counted as pending requests
+        if (is_stopping()) { return; }
+        incr_pending_request_num();
+        wb_cache().prefetch_bufs(
+            node_ids, [this](const IndexBufferPtr& idx_buf) { return node_from_buf(idx_buf); },
+            [this]() { decr_pending_request_num(); });
+    }
+
+    BtreeNodePtr node_from_buf(const IndexBufferPtr& idx_buf) const {
+        bool is_leaf = BtreeNode::identify_leaf_node(idx_buf->raw_buffer());
+        BtreeNode* n =
+            this->init_node(idx_buf->raw_buffer(), idx_buf->blkid().to_integer(), false /* init_buf */, is_leaf);
+        static_cast< IndexBtreeNode* >(n)->attach_buf(idx_buf);
+        return BtreeNodePtr{n};
+    }
+
     btree_status_t refresh_node(const BtreeNodePtr& node, bool for_read_modify_write, void* context) const override {
         if (context == nullptr || !for_read_modify_write) { return btree_status_t::success; }
         return wb_cache().get_writable_buf(node, r_cast< CPContext* >(context)) ? btree_status_t::success
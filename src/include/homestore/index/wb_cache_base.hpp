@@ -48,6 +48,20 @@ public:
 
     virtual void read_buf(bnodeid_t id, BtreeNodePtr& node, node_initializer_t&& node_initializer) = 0;
 
+    /// @brief Get the node only if it is in cache, without reading it from the device or adding it to the cache
+    /// @param id Node id of the buffer
+    /// @param node Node found in cache
+    /// @return false if the node is not in cache
+    virtual bool get_cached_buf(bnodeid_t id, BtreeNodePtr& node) { return false; }
+
+    /// @brief Start loading the buffers into the cache in the background, if they are not already in cache. Nothing is
+    /// returned, a later read_buf on these ids is expected to find them in cache.
+    /// @param ids Node ids to be loaded
+    /// @param node_initializer Callback to be called upon which buffer is turned into btree node
+    /// @param on_done Callback to be called once all the reads are completed and node_initializer is no longer used
+    virtual void prefetch_bufs(std::vector< bnodeid_t > const& ids, node_initializer_t&& node_initializer,
+                               std::function< void() >&& on_done) = 0;
+
     virtual bool get_writable_buf(const BtreeNodePtr& node, CPContext* context) = 0;
 
     virtual bool refresh_meta_buf(shared< MetaIndexBuffer >& meta_buf, CPContext* cp_ctx) = 0;
@@ -66,6 +80,9 @@ public:
     /// @return
     // virtual IndexBufferPtr copy_buffer(const IndexBufferPtr& cur_buf, const CPContext* context) const = 0;
     virtual void recover(sisl::byte_view sb) = 0;
+
+    /// @brief Stop any background activity of the cache, called as part of index service stop
+    virtual void stop() {}
 };
 
 } // namespace homestore
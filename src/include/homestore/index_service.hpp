@@ -52,6 +52,10 @@ private:
     std::unique_ptr< sisl::IDReserver > m_ordinal_reserver;
     std::shared_ptr< ChunkSelector > m_custom_chunk_selector;
 
+    // Background merge of the underfull nodes of the index tables with lazy merge
+    iomgr::timer_handle_t m_lazy_merge_timer_hdl{iomgr::null_timer_handle};
+    std::atomic_bool m_lazy_merge_running{false};
+
     mutable std::mutex m_index_map_mtx;
     std::map< uuid_t, std::shared_ptr< IndexTableBase > > m_index_map;
     std::unordered_map< uint32_t, std::shared_ptr< IndexTableBase > > m_ordinal_index_map;
@@ -109,6 +113,9 @@ private:
     std::atomic_bool m_stopping{false};
     mutable std::atomic_uint64_t pending_request_num{0};
 
+    void start_lazy_merge();
+    void lazy_merge();
+
     bool is_stopping() const { return m_stopping.load(); }
     void start_stopping() { m_stopping = true; }
 
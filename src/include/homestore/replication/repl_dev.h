@@ -119,6 +119,9 @@ struct snapshot_obj {
     sisl::io_blob_safe blob;
     bool is_first_obj{false};
     bool is_last_obj{false};
+    // Optionally set by read_snapshot_obj on the leader to the offset of the object the follower is expected to ask
+    // next. When set, the next objects are read ahead while the current one is in transit. 0 means unknown.
+    uint64_t next_offset{0};
 
     snapshot_obj(void*& ctx) : user_ctx(ctx) {}
 };
@@ -231,6 +234,12 @@ public:
     /// @return true if the request didn't receive the data already, false otherwise
     bool save_fetched_data(sisl::GenericClientResponse const& fetched_data, uint8_t const* data, uint32_t data_size);
 
+    /// @brief Same as above, but for data which was already decoded (say decompressed) by the data channel into its own
+    /// aligned buffer. The request takes ownership of the buffer, so no further copy is made.
+    /// @return true if the request didn't receive the data already, false otherwise
+    bool save_pushed_data(intrusive< sisl::GenericRpcData > const& pushed_data, sisl::io_blob_safe&& decoded_data);
+    bool save_fetched_data(sisl::GenericClientResponse const& fetched_data, sisl::io_blob_safe&& decoded_data);
+
     void set_remote_blkid(RemoteBlkId const& rbid) { m_remote_blkid = rbid; }
     void set_local_blkids(std::vector< MultiBlkId > const& lbids) { m_local_blkids = std::move(lbids); }
     void set_is_volatile(bool is_volatile) { m_is_volatile.store(is_volatile); }
@@ -433,6 +442,16 @@ public:
     /// After this the raft on the follower side can do the incremental resync.
     virtual void write_snapshot_obj(shared< snapshot_context > context, shared< snapshot_obj > snp_obj) = 0;
 
+    /// @brief Asynchronous version of write_snapshot_obj, used when snapshot_io_max_inflight_objs > 1. The listener
+    /// should update snp_obj->offset with the next object id before returning and can complete the write later through
+    /// the returned future. This lets several objects be written in parallel. snp_obj->user_ctx must not be accessed
+    /// after returning. The default implementation writes synchronously.
+    virtual folly::Future< folly::Unit > async_write_snapshot_obj(shared< snapshot_context > context,
+                                                                  shared< snapshot_obj > snp_obj) {
+        write_snapshot_obj(std::move(context), std::move(snp_obj));
+        return folly::makeFuture< folly::Unit >(folly::Unit{});
+    }
+
     /// @brief Free up user-defined context inside the snapshot_obj that is allocated during read_snapshot_obj.
     virtual void free_user_snp_ctx(void*& user_snp_ctx) = 0;
 
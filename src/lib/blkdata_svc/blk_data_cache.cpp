@@ -0,0 +1,161 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#include <algorithm>
+#include <cstring>
+
+#include <folly/small_vector.h>
+
+#include "common/homestore_config.hpp"
+#include "common/s3fifo_evictor.hpp"
+#include "blk_data_cache.hpp"
+
+namespace homestore {
+
+namespace {
+// Walks the iovs as one contiguous buffer, copying a block at a time in or out of it
+class IovCursor {
+public:
+    IovCursor(iovec const* iovs, int iovcnt) : m_iovs{iovs}, m_iovcnt{iovcnt} {}
+
+    void copy_out(uint8_t const* src, uint32_t len) {
+        walk(len, [&src](uint8_t* iov_ptr, uint32_t n) {
+            std::memcpy(iov_ptr, src, n);
+            src += n;
+        });
+    }
+
+    void copy_in(uint8_t* dst, uint32_t len) {
+        walk(len, [&dst](uint8_t* iov_ptr, uint32_t n) {
+            std::memcpy(dst, iov_ptr, n);
+            dst += n;
+        });
+    }
+
+private:
+    template < typename CopyFn >
+    void walk(uint32_t len, CopyFn&& fn) {
+        while ((len > 0) && (m_idx < m_iovcnt)) {
+            auto const n = std::min(uint32_t(m_iovs[m_idx].iov_len - m_offset), len);
+            fn(r_cast< uint8_t* >(m_iovs[m_idx].iov_base) + m_offset, n);
+            len -= n;
+            m_offset += n;
+            if (m_offset == m_iovs[m_idx].iov_len) {
+                ++m_idx;
+                m_offset = 0;
+            }
+        }
+    }
+
+private:
+    iovec const* m_iovs;
+    int m_iovcnt;
+    int m_idx{0};
+    size_t m_offset{0};
+};
+} // namespace
+
+BlkDataCache::BlkDataCache(uint64_t size, uint32_t blk_size) :
+        m_size{size},
+        m_blk_size{blk_size},
+        m_evictor{std::make_shared< S3FifoEvictor >(size, HS_DYNAMIC_CONFIG(generic.cache_evictor_npartitions),
+                                                    HS_DYNAMIC_CONFIG(generic.cache_evictor_small_queue_pct))},
+        m_cache{m_evictor, uint32_cast(std::max(size / blk_size, uint64_t{1})), blk_size,
+                [](const CachedDataBlkPtr& blk) -> BlkId { return blk->m_blkid; },
+                [this](const sisl::CacheRecord&) -> bool {
+                    // Cached blocks are always clean
+                    COUNTER_INCREMENT(m_metrics, data_cache_evict_blks, 1);
+                    return true;
+                }} {}
+
+BlkDataCache::~BlkDataCache() = default;
+
+bool BlkDataCache::read(BlkId const& bid, iovec const* iovs, int iovcnt, uint32_t size) {
+    auto const nblks = std::min(uint32_cast(bid.blk_count()), sisl::round_up(size, m_blk_size) / m_blk_size);
+
+    // Look up all the blocks first, so a partial hit neither copies nor counts as a hit
+    folly::small_vector< CachedDataBlkPtr, 8 > blks;
+    for (uint32_t i{0}; i < nblks; ++i) {
+        CachedDataBlkPtr blk;
+        if (!m_cache.get(blk_at(bid, i), blk)) {
+            COUNTER_INCREMENT(m_metrics, data_cache_miss_cnt, 1);
+            return false;
+        }
+        blks.push_back(std::move(blk));
+    }
+
+    IovCursor cursor{iovs, iovcnt};
+    uint32_t remaining{size};
+    for (auto const& blk : blks) {
+        auto const len = std::min(remaining, m_blk_size);
+        cursor.copy_out(blk->m_buf.get(), len);
+        remaining -= len;
+    }
+    COUNTER_INCREMENT(m_metrics, data_cache_hit_cnt, 1);
+    return true;
+}
+
+void BlkDataCache::insert(BlkId const& bid, iovec const* iovs, int iovcnt, uint32_t size, bool overwrite) {
+    auto const nblks = std::min(uint32_cast(bid.blk_count()), size / m_blk_size);
+
+    IovCursor cursor{iovs, iovcnt};
+    for (uint32_t i{0}; i < nblks; ++i) {
+        auto blk = std::make_shared< CachedDataBlk >();
+        blk->m_blkid = blk_at(bid, i);
+        blk->m_buf = std::make_unique< uint8_t[] >(m_blk_size);
+        cursor.copy_in(blk->m_buf.get(), m_blk_size);
+        if (overwrite) {
+            m_cache.upsert(blk);
+        } else if (!m_cache.insert(blk)) {
+            // Already cached by an earlier read of the same block, which has the same data
+            continue;
+        }
+        COUNTER_INCREMENT(m_metrics, data_cache_insert_blks, 1);
+    }
+}
+
+uint64_t BlkDataCache::generation(BlkId const& bid) const {
+    // Generations only go up, so their sum is unchanged if and only if none of them changed
+    uint64_t gen{0};
+    for (uint32_t i{0}; i < bid.blk_count(); ++i) {
+        gen += gen_of(blk_at(bid, i)).load();
+    }
+    return gen;
+}
+
+void BlkDataCache::insert_read(BlkId const& bid, iovec const* iovs, int iovcnt, uint32_t size, uint64_t gen) {
+    if (generation(bid) != gen) { return; }
+    insert(bid, iovs, iovcnt, size, false /* overwrite */);
+
+    // An invalidate which bumped the generation after the check above could have run before the insert, in which
+    // case it is up to us to drop the blocks. One which bumps it after this check removes them itself.
+    if (generation(bid) != gen) {
+        for (uint32_t i{0}; i < bid.blk_count(); ++i) {
+            CachedDataBlkPtr blk;
+            m_cache.remove(blk_at(bid, i), blk);
+        }
+    }
+}
+
+void BlkDataCache::invalidate(BlkId const& bid) {
+    for (uint32_t i{0}; i < bid.blk_count(); ++i) {
+        auto const blkid = blk_at(bid, i);
+        gen_of(blkid).fetch_add(1);
+        CachedDataBlkPtr blk;
+        m_cache.remove(blkid, blk);
+    }
+    COUNTER_INCREMENT(m_metrics, data_cache_invalidate_cnt, 1);
+}
+} // namespace homestore
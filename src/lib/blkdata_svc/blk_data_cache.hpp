@@ -0,0 +1,130 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+#include <sys/uio.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include <sisl/cache/simple_cache.hpp>
+#include <sisl/fds/utils.hpp>
+#include <sisl/metrics/metrics.hpp>
+#include <homestore/blk.h>
+
+namespace homestore {
+class S3FifoEvictor;
+
+class BlkDataCacheMetrics : public sisl::MetricsGroup {
+public:
+    explicit BlkDataCacheMetrics() : sisl::MetricsGroup("BlkDataCache", "DataSvc") {
+        REGISTER_COUNTER(data_cache_hit_cnt, "Reads of a blkid served from the data cache");
+        REGISTER_COUNTER(data_cache_miss_cnt, "Reads of a blkid which had to go to the device");
+        REGISTER_COUNTER(data_cache_insert_blks, "Blocks added to the data cache");
+        REGISTER_COUNTER(data_cache_evict_blks, "Blocks evicted from the data cache");
+        REGISTER_COUNTER(data_cache_invalidate_cnt, "Blkids invalidated in the data cache on write or free");
+        register_me_to_farm();
+    }
+
+    BlkDataCacheMetrics(const BlkDataCacheMetrics&) = delete;
+    BlkDataCacheMetrics& operator=(const BlkDataCacheMetrics&) = delete;
+    BlkDataCacheMetrics(BlkDataCacheMetrics&&) noexcept = delete;
+    BlkDataCacheMetrics& operator=(BlkDataCacheMetrics&&) noexcept = delete;
+
+    ~BlkDataCacheMetrics() { deregister_me_from_farm(); }
+};
+
+struct CachedDataBlk {
+    BlkId m_blkid; // Single block
+    std::unique_ptr< uint8_t[] > m_buf;
+};
+using CachedDataBlkPtr = std::shared_ptr< CachedDataBlk >;
+
+//
+// Read cache of the data blocks, used by BlkDataService when the resource limit data_cache_size_percent is set.
+//
+// Every block is cached on its own, keyed by its single block BlkId, so reads and frees of blkids which only partly
+// overlap are handled the same way as the exact ones. The cache has its own scan resistant evictor, whose size is
+// carved out of the homestore cache size, so a scan over cold objects does not push out the index nodes or the hot
+// data blocks. Both the hashmap and the evictor are sharded by the hash of the blkid.
+//
+// Only clean data is cached, so every block can be evicted at any time. It is the caller's responsibility to not read
+// a blkid while it is being written or freed, same as without the cache. A read which missed the cache can still
+// complete after a write issued meanwhile, so every invalidate bumps the generation of the blocks, and the read only
+// caches what it read if the generation it took before going to the device is unchanged.
+//
+class BlkDataCache {
+public:
+    BlkDataCache(uint64_t size, uint32_t blk_size);
+    ~BlkDataCache();
+
+    BlkDataCache(const BlkDataCache&) = delete;
+    BlkDataCache& operator=(const BlkDataCache&) = delete;
+    BlkDataCache(BlkDataCache&&) noexcept = delete;
+    BlkDataCache& operator=(BlkDataCache&&) noexcept = delete;
+
+    /**
+     * @brief : copy the first size bytes of the blkid into the iovs, if all the blocks it spans are cached.
+     *
+     * @return : true if the read is served from the cache, false if the caller needs to read it from the device;
+     */
+    bool read(BlkId const& bid, iovec const* iovs, int iovcnt, uint32_t size);
+
+    /**
+     * @brief : add the blocks of the blkid which are fully covered by the first size bytes of the iovs. Blocks already
+     * in the cache are replaced if overwrite is set and left as is otherwise.
+     */
+    void insert(BlkId const& bid, iovec const* iovs, int iovcnt, uint32_t size, bool overwrite);
+
+    /**
+     * @brief : generation of the blocks of the blkid, to be taken by a read which missed the cache before it goes to
+     * the device;
+     */
+    uint64_t generation(BlkId const& bid) const;
+
+    /**
+     * @brief : add the blocks read from the device, same as insert without overwrite, unless the blkid was invalidated
+     * since gen was taken, in which case the data read could be stale.
+     */
+    void insert_read(BlkId const& bid, iovec const* iovs, int iovcnt, uint32_t size, uint64_t gen);
+
+    /**
+     * @brief : drop all the blocks of the blkid from the cache;
+     */
+    void invalidate(BlkId const& bid);
+
+    uint64_t size() const { return m_size; }
+
+private:
+    static BlkId blk_at(BlkId const& bid, uint32_t i) {
+        return BlkId{s_cast< blk_num_t >(bid.blk_num() + i), blk_count_t{1}, bid.chunk_num()};
+    }
+
+    std::atomic< uint64_t >& gen_of(BlkId const& blk) { return m_gens[blk.to_integer() % gen_slots]; }
+    std::atomic< uint64_t > const& gen_of(BlkId const& blk) const { return m_gens[blk.to_integer() % gen_slots]; }
+
+private:
+    uint64_t const m_size;
+    uint32_t const m_blk_size;
+    std::shared_ptr< S3FifoEvictor > m_evictor;
+    sisl::SimpleCache< BlkId, CachedDataBlkPtr > m_cache;
+    BlkDataCacheMetrics m_metrics;
+
+    // Invalidate generations, hashed by block. Blocks sharing a slot only cost an extra dropped read.
+    static constexpr uint32_t gen_slots{4096};
+    std::array< std::atomic< uint64_t >, gen_slots > m_gens{};
+};
+} // namespace homestore
@@ -0,0 +1,141 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include <sisl/logging/logging.h>
+
+#include "common/homestore_config.hpp"
+#include "blk_data_compressor.hpp"
+
+namespace homestore {
+
+BlkDataCompressor::BlkDataCompressor(uint32_t blk_size, uint32_t align_size) :
+        m_blk_size{blk_size}, m_align_size{align_size} {}
+
+uint32_t BlkDataCompressor::compress(sisl::sg_list const& sgs, sisl::io_blob_safe& out) {
+    auto const codec = hs_compressor::to_codec(HS_DYNAMIC_CONFIG(generic.data_compression));
+    if ((codec == compression_codec_t::NONE) || (sgs.size < HS_DYNAMIC_CONFIG(generic.data_compress_min_size)) ||
+        (sgs.size < 2 * m_blk_size)) {
+        return 0;
+    }
+
+    // Sample the data first, so that already compressed or encrypted data doesn't cost a full compression pass
+    if (!hs_compressor::is_compressible(sgs, HS_DYNAMIC_CONFIG(generic.data_compress_sample_size),
+                                        HS_DYNAMIC_CONFIG(generic.data_compress_min_saving_pct))) {
+        COUNTER_INCREMENT(m_metrics, data_compress_skip_cnt, 1);
+        return 0;
+    }
+
+    // Extent is capped at one blk less than the data, which is what tells a compressed extent apart on read
+    auto const start_time = Clock::now();
+    uint32_t const max_extent_size = uint32_cast(sgs.size) - m_blk_size;
+    sisl::io_blob_safe extent(max_extent_size, m_align_size);
+    auto const compressed_size =
+        hs_compressor::compress(codec, sgs, extent.bytes() + sizeof(compressed_extent_header),
+                                max_extent_size - sizeof(compressed_extent_header),
+                                HS_DYNAMIC_CONFIG(generic.data_compression_level));
+    HISTOGRAM_OBSERVE(m_metrics, data_compress_latency_us, get_elapsed_time_us(start_time));
+    if (compressed_size == 0) {
+        COUNTER_INCREMENT(m_metrics, data_compress_skip_cnt, 1);
+        return 0;
+    }
+
+    auto* hdr = new (extent.bytes()) compressed_extent_header{};
+    hdr->codec = codec;
+    hdr->original_size = uint32_cast(sgs.size);
+    hdr->compressed_size = uint32_cast(compressed_size);
+
+    // Zero the padding, so that no stale memory makes it to the device
+    uint32_t const used_size = uint32_cast(sizeof(compressed_extent_header) + compressed_size);
+    uint32_t const extent_size = sisl::round_up(used_size, m_blk_size);
+    std::memset(extent.bytes() + used_size, 0, extent_size - used_size);
+
+    COUNTER_INCREMENT(m_metrics, data_compress_cnt, 1);
+    COUNTER_INCREMENT(m_metrics, data_compress_in_bytes, sgs.size);
+    COUNTER_INCREMENT(m_metrics, data_compress_out_bytes, extent_size);
+    HISTOGRAM_OBSERVE(m_metrics, data_compress_ratio_pct, uint64_t{extent_size} * 100 / sgs.size);
+    out = std::move(extent);
+    return extent_size;
+}
+
+std::error_code BlkDataCompressor::decompress(uint8_t const* extent, uint32_t extent_size, iovec const* iovs,
+                                              int iovcnt, uint32_t size) {
+    if (extent_size < sizeof(compressed_extent_header)) {
+        LOGERROR("Compressed data extent too short for its header, extent_size={} read size={}", extent_size, size);
+        COUNTER_INCREMENT(m_metrics, data_decompress_err_cnt, 1);
+        return std::make_error_code(std::errc::illegal_byte_sequence);
+    }
+
+    auto const* hdr = r_cast< compressed_extent_header const* >(extent);
+    if ((hdr->magic != compressed_extent_header::MAGIC) || (hdr->original_size != size) ||
+        (hdr->compressed_size > extent_size - sizeof(compressed_extent_header))) {
+        LOGERROR("Invalid compressed data extent, extent_size={} read size={} magic={:#x} original_size={}",
+                 extent_size, size, hdr->magic, hdr->original_size);
+        COUNTER_INCREMENT(m_metrics, data_decompress_err_cnt, 1);
+        return std::make_error_code(std::errc::illegal_byte_sequence);
+    }
+
+    auto const start_time = Clock::now();
+    uint8_t const* payload = extent + sizeof(compressed_extent_header);
+    bool ok;
+    if ((iovcnt == 1) && (iovs[0].iov_len >= size)) {
+        // Most common case, decompress straight into the caller's buffer
+        ok = hs_compressor::decompress(hdr->codec, payload, hdr->compressed_size, r_cast< uint8_t* >(iovs[0].iov_base),
+                                       size);
+    } else {
+        auto buf = std::make_unique< uint8_t[] >(size);
+        ok = hs_compressor::decompress(hdr->codec, payload, hdr->compressed_size, buf.get(), size);
+        uint32_t copied{0};
+        for (int i{0}; ok && (i < iovcnt) && (copied < size); ++i) {
+            auto const n = std::min(uint32_cast(iovs[i].iov_len), size - copied);
+            std::memcpy(iovs[i].iov_base, buf.get() + copied, n);
+            copied += n;
+        }
+    }
+
+    if (!ok) {
+        LOGERROR("Failed to decompress data extent, codec={} compressed_size={} original_size={}",
+                 enum_name(hdr->codec), hdr->compressed_size, hdr->original_size);
+        COUNTER_INCREMENT(m_metrics, data_decompress_err_cnt, 1);
+        return std::make_error_code(std::errc::illegal_byte_sequence);
+    }
+    HISTOGRAM_OBSERVE(m_metrics, data_decompress_latency_us, get_elapsed_time_us(start_time));
+    return std::error_code{};
+}
+
+std::error_code BlkDataCompressor::check_raw_read(iovec const* iovs, int iovcnt, uint32_t size) {
+    if (size < sizeof(compressed_extent_header)) { return std::error_code{}; }
+
+    compressed_extent_header hdr;
+    auto* dst = r_cast< uint8_t* >(&hdr);
+    uint32_t copied{0};
+    for (int i{0}; (i < iovcnt) && (copied < sizeof(hdr)); ++i) {
+        auto const n = std::min(uint32_cast(iovs[i].iov_len), uint32_cast(sizeof(hdr)) - copied);
+        std::memcpy(dst + copied, iovs[i].iov_base, n);
+        copied += n;
+    }
+    if ((copied < sizeof(hdr)) || (hdr.magic != compressed_extent_header::MAGIC) ||
+        (hdr.version != compressed_extent_header::VERSION) || (hdr.reserved != 0) || (hdr.original_size <= size)) {
+        return std::error_code{};
+    }
+
+    LOGERROR("Compressed data extent read partially, read size={} original_size={}", size, hdr.original_size);
+    COUNTER_INCREMENT(m_metrics, data_partial_read_err_cnt, 1);
+    return std::make_error_code(std::errc::invalid_argument);
+}
+} // namespace homestore
@@ -0,0 +1,129 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+#include <sys/uio.h>
+#include <cstdint>
+#include <system_error>
+
+#include <sisl/fds/buffer.hpp>
+#include <sisl/fds/utils.hpp>
+#include <sisl/metrics/metrics.hpp>
+
+#include "common/compression.hpp"
+
+namespace homestore {
+
+class BlkDataCompressorMetrics : public sisl::MetricsGroup {
+public:
+    explicit BlkDataCompressorMetrics() : sisl::MetricsGroup("BlkDataCompressor", "DataSvc") {
+        // Ratio is the size on the device in percentage of the original size
+        REGISTER_COUNTER(data_compress_cnt, "data writes stored compressed", "data_compress_cnt",
+                         {"result", "compressed"});
+        REGISTER_COUNTER(data_compress_skip_cnt, "data writes stored as is since they were incompressible",
+                         "data_compress_cnt", {"result", "skipped"});
+        REGISTER_COUNTER(data_compress_in_bytes, "data bytes before compression", "data_compress_bytes",
+                         {"op", "in"});
+        REGISTER_COUNTER(data_compress_out_bytes, "data bytes written to the device after compression",
+                         "data_compress_bytes", {"op", "out"});
+        REGISTER_COUNTER(data_decompress_err_cnt, "compressed data extents failed to decompress");
+        REGISTER_COUNTER(data_partial_read_err_cnt, "compressed data extents read partially as raw data");
+        REGISTER_HISTOGRAM(data_compress_ratio_pct, "data compressed size percentage of the original",
+                           HistogramBucketsType(PercentileBuckets));
+        REGISTER_HISTOGRAM(data_compress_latency_us, "data compression cpu time in us", "data_compression_latency",
+                           {"op", "compress"}, HistogramBucketsType(OpLatecyBuckets));
+        REGISTER_HISTOGRAM(data_decompress_latency_us, "data decompression cpu time in us",
+                           "data_compression_latency", {"op", "decompress"}, HistogramBucketsType(OpLatecyBuckets));
+        register_me_to_farm();
+    }
+
+    BlkDataCompressorMetrics(const BlkDataCompressorMetrics&) = delete;
+    BlkDataCompressorMetrics& operator=(const BlkDataCompressorMetrics&) = delete;
+    BlkDataCompressorMetrics(BlkDataCompressorMetrics&&) noexcept = delete;
+    BlkDataCompressorMetrics& operator=(BlkDataCompressorMetrics&&) noexcept = delete;
+
+    ~BlkDataCompressorMetrics() { deregister_me_from_farm(); }
+};
+
+// Header at the start of every compressed data extent, followed by the compressed payload and zero padding up to the
+// blk size.
+#pragma pack(1)
+struct compressed_extent_header {
+    static constexpr uint32_t MAGIC{0xC0DEDA7A};
+    static constexpr uint8_t VERSION{1};
+
+    uint32_t magic{MAGIC};
+    uint8_t version{VERSION};
+    compression_codec_t codec{compression_codec_t::NONE};
+    uint16_t reserved{0};
+    uint32_t original_size{0};
+    uint32_t compressed_size{0};
+};
+#pragma pack()
+
+//
+// Inline compression of the data written through BlkDataService::async_alloc_write, turned on by the generic config
+// data_compression.
+//
+// A write is stored compressed only if it saves at least one blk, so an extent is compressed if and only if it is
+// smaller on the device than the size it is read back with. That keeps the raw extents free of any header and lets
+// the compression be turned on and off without any persisted state. The flip side is that a compressed extent has to be
+// read as a whole, with the original size of the write. A read of a prefix of a compressed extent is caught by the
+// header at its start and failed, while a read starting in the middle of one cannot be told apart from raw data.
+//
+class BlkDataCompressor {
+public:
+    BlkDataCompressor(uint32_t blk_size, uint32_t align_size);
+
+    BlkDataCompressor(const BlkDataCompressor&) = delete;
+    BlkDataCompressor& operator=(const BlkDataCompressor&) = delete;
+    BlkDataCompressor(BlkDataCompressor&&) noexcept = delete;
+    BlkDataCompressor& operator=(BlkDataCompressor&&) noexcept = delete;
+
+    /**
+     * @brief : compress the data into an aligned extent, which is to be written in place of it.
+     *
+     * @param out : the compressed extent, header included and padded up to the blk size;
+     * @return : size of the compressed extent, 0 if the data is to be written as is;
+     */
+    uint32_t compress(sisl::sg_list const& sgs, sisl::io_blob_safe& out);
+
+    /**
+     * @brief : whether an extent of extent_size bytes on the device, read back as size bytes, is compressed;
+     */
+    static bool is_compressed(uint32_t extent_size, uint32_t size) { return extent_size < size; }
+
+    /**
+     * @brief : decompress a compressed extent read from the device into the first size bytes of the iovs.
+     *
+     * @return : error if the extent is not a valid compressed extent of size bytes;
+     */
+    std::error_code decompress(uint8_t const* extent, uint32_t extent_size, iovec const* iovs, int iovcnt,
+                               uint32_t size);
+
+    /**
+     * @brief : check that the first size bytes of the iovs, read from the device as raw data, are not the start of a
+     * compressed extent, which happens if a compressed extent is read with less than its original size.
+     *
+     * @return : error if the data starts with the header of a compressed extent larger than size;
+     */
+    std::error_code check_raw_read(iovec const* iovs, int iovcnt, uint32_t size);
+
+private:
+    uint32_t const m_blk_size;
+    uint32_t const m_align_size;
+    BlkDataCompressorMetrics m_metrics;
+};
+} // namespace homestore
@@ -16,75 +16,93 @@
 #include "common/homestore_assert.hpp"
 
 namespace homestore {
-static BlkId extract_key(const BlkTrackRecord& rec) { return rec.m_key; }
-
-BlkReadTracker::BlkReadTracker() : m_pending_reads_map(s_expected_num_records, extract_key, nullptr /* access_cb */) {}
+BlkReadTracker::BlkReadTracker(uint32_t num_slots) :
+        m_slots{std::make_unique< std::atomic< uint64_t >[] >(num_slots)}, m_num_slots{num_slots} {
+    for (uint32_t i{0}; i < m_num_slots; ++i) {
+        m_slots[i].store(0, std::memory_order_relaxed);
+    }
+}
 
 BlkReadTracker::~BlkReadTracker() = default;
 
 // BlkReadTrackerMetrics& BlkReadTracker::get_metrics() { return m_metrics; }
 
-void BlkReadTracker::merge(const BlkId& blkid, int64_t new_ref_count,
-                           const std::shared_ptr< blk_track_waiter >& waiter) {
-    HS_DBG_ASSERT(new_ref_count ? waiter == nullptr : waiter != nullptr, "Invalid waiter");
-
-    auto cur_base_blk_num = s_cast< blk_num_t >(sisl::round_down(blkid.blk_num(), entries_per_record()));
-    auto last_base_blk_num =
-        s_cast< blk_num_t >(sisl::round_down(blkid.blk_num() + blkid.blk_count() - 1, entries_per_record()));
-
-    [[maybe_unused]] bool waiter_rescheduled{false};
-    // everything is aligned after this point, so we don't need to handle sub_range in a base blkid;
-    while (cur_base_blk_num <= last_base_blk_num) {
-        BlkId base_blkid{cur_base_blk_num, entries_per_record(), blkid.chunk_num()};
-
-        if (new_ref_count > 0) {
-            // This is an insert operation
-            m_pending_reads_map.upsert_or_delete(base_blkid,
-                                                 [&base_blkid, new_ref_count](BlkTrackRecord& rec, bool existing) {
-                                                     if (!existing) { rec.m_key = base_blkid; }
-                                                     rec.m_ref_cnt += new_ref_count;
-                                                     return false;
-                                                 });
-        } else if (new_ref_count < 0) {
-            // This is a remove operation
-            m_pending_reads_map.upsert_or_delete(
-                base_blkid, [new_ref_count, &base_blkid](BlkTrackRecord& rec, bool existing) {
-                    HS_DBG_ASSERT_EQ(existing, true, "Decrement a ref count (blk: {}) which does not exist in map",
-                                     base_blkid.to_string());
-                    rec.m_ref_cnt += new_ref_count;
-                    return (rec.m_ref_cnt == 0);
-                });
-        } else {
-            // this is wait_on operation
-            m_pending_reads_map.update(base_blkid, [&waiter_rescheduled, &waiter](BlkTrackRecord& rec) {
-                rec.m_waiters.push_back(waiter);
-                waiter_rescheduled = true;
-            });
-        }
-
-        cur_base_blk_num += entries_per_record();
+void BlkReadTracker::add_ref(const BlkId& blkid) {
+    for_each_slot(blkid, [this](uint32_t slot) { m_slots[slot].fetch_add(1, std::memory_order_acq_rel); });
+}
+
+void BlkReadTracker::drop_ref(const BlkId& blkid) {
+    for_each_slot(blkid, [this, &blkid](uint32_t slot) {
+        auto const old = m_slots[slot].fetch_sub(1, std::memory_order_acq_rel);
+        HS_DBG_ASSERT_GT((old & s_ref_cnt_mask), 0, "Decrement a ref count (blk: {}) which does not exist",
+                         blkid.to_string());
+        if (((old & s_ref_cnt_mask) == 1) && (old & s_waiting_bit)) { release_waiters(slot); }
+    });
+}
+
+void BlkReadTracker::add_waiter(uint32_t slot, const blk_track_waiter_ptr& waiter) {
+    bool last_read_done{false};
+    {
+        auto& shard = shard_of(slot);
+        std::unique_lock lg(shard.mtx);
+        if ((m_slots[slot].load(std::memory_order_acquire) & s_ref_cnt_mask) == 0) { return; }
+
+        shard.waiters[slot].push_back(waiter);
+        auto const old = m_slots[slot].fetch_or(s_waiting_bit, std::memory_order_acq_rel);
+        last_read_done = ((old & s_ref_cnt_mask) == 0);
     }
 
+    if (last_read_done) {
+        // Last pending read completed before the bit is set, so it has not released the waiters
+        release_waiters(slot);
+        return;
+    }
 #ifdef _PRERELEASE
-    if (waiter_rescheduled) { COUNTER_INCREMENT(m_metrics, blktrack_erase_blk_rescheduled, 1); }
+    COUNTER_INCREMENT(m_metrics, blktrack_erase_blk_rescheduled, 1);
 #endif
+}
+
+void BlkReadTracker::release_waiters(uint32_t slot) {
+    folly::small_vector< blk_track_waiter_ptr, 4 > waiters;
+    {
+        auto& shard = shard_of(slot);
+        std::unique_lock lg(shard.mtx);
+        // A new read could have come in after the count dropped to zero, in which case it releases them when it is done
+        if ((m_slots[slot].load(std::memory_order_acquire) & s_ref_cnt_mask) != 0) { return; }
+        m_slots[slot].fetch_and(~s_waiting_bit, std::memory_order_acq_rel);
+
+        auto it = shard.waiters.find(slot);
+        if (it == shard.waiters.end()) { return; }
+        waiters = std::move(it->second);
+        shard.waiters.erase(it);
+    }
+    // waiters are dereferenced outside the lock, as the last one to go out triggers the callback
+}
 
-    // if no record is found for a wait-on operation, it means no one is holding reference for this waiter and cb will
-    // be called automatically when this function exits (waiter's destrctor will be called);
+void BlkReadTracker::insert(const BlkId& blkid) { add_ref(blkid); }
+void BlkReadTracker::remove(const BlkId& blkid) { drop_ref(blkid); }
+
+void BlkReadTracker::insert(MultiBlkId const& blkids) {
+    auto it = blkids.iterate();
+    while (auto const b = it.next()) {
+        add_ref(*b);
+    }
 }
 
-void BlkReadTracker::insert(const BlkId& blkid) { merge(blkid, 1, nullptr); }
-void BlkReadTracker::remove(const BlkId& blkid) { merge(blkid, -1, nullptr); }
+void BlkReadTracker::remove(MultiBlkId const& blkids) {
+    auto it = blkids.iterate();
+    while (auto const b = it.next()) {
+        drop_ref(*b);
+    }
+}
 
 void BlkReadTracker::wait_on(MultiBlkId const& blkids, after_remove_cb_t&& after_remove_cb) {
-    if (blkids.num_pieces() == 1) {
-        merge(blkids, 0, std::make_shared< blk_track_waiter >(std::move(after_remove_cb)));
-    } else {
-        auto waiter = std::make_shared< blk_track_waiter >(std::move(after_remove_cb));
-        auto it = blkids.iterate();
-        while (auto const b = it.next()) {
-            merge(*b, 0, waiter);
-        }
+    // if no slot has a pending read, no one is holding reference for this waiter and cb will be called automatically
+    // when this function exits (waiter's destructor will be called);
+    auto waiter = std::make_shared< blk_track_waiter >(std::move(after_remove_cb));
+    auto it = blkids.iterate();
+    while (auto const b = it.next()) {
+        for_each_slot(*b, [this, &waiter](uint32_t slot) { add_waiter(slot, waiter); });
     }
 }
 
@@ -13,10 +13,14 @@
  *
  *********************************************************************************/
 #pragma once
+#include <array>
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <folly/small_vector.h>
-#include <sisl/cache/simple_hashmap.hpp>
 #include <sisl/fds/utils.hpp>
 #include <sisl/metrics/metrics.hpp>
 #include <folly/Function.h>
@@ -56,39 +60,36 @@ typedef std::shared_ptr< blk_track_waiter > blk_track_waiter_ptr;
 //  A read can never overlap a unfinished free-blk id;
 //  A read can overlap a pending read;
 //
+//  Blocks of a chunk are tracked in regions of entries_per_record blocks. Every region maps to a slot, which has the
+//  count of reads pending on the region and a bit set if any free is waiting on it. Reads only do an atomic add and
+//  subtract on the slots of the regions they span, so they neither take a lock nor allocate.
+//
 //  Say alignment is 16;
 //  1. read-1: {17, 32, 0}
 //  2. free blk: {8, 32, 0}
-//  3. read-2: {0, 4, 0}  // <<< this read will also create track record on {0, 16, 0}, it is fine though as we don't
-//  create any record under {0, 16, 0} on free;
-//
-
-//
-// When ref_cnt drops to zero (read completes), remove every waiter from the vector in this Record;
-// same waiter can be attached to multple BlkTrackRecord's vector and whom ever is the last to dereference the
-// shared_ptr of a waiter, triggers waiter's destrctor which sends the callback;
+//  3. read-2: {0, 4, 0}  // <<< this read will also add to the count of region {0, 16, 0}, it is fine though as the free
+//  doesn't wait on a region which has no pending read;
 //
+//  A free registers its waiter on every slot of its regions which has pending reads, under the lock of the shard of
+//  the slot. The read which drops the count of a slot to zero, with the waiter bit set, releases the waiters of the slot.
+//  Same waiter can be attached to multiple slots and whom ever is the last to dereference the shared_ptr of a waiter,
+//  triggers waiter's destructor which sends the callback;
 //
 //  Chunk_id: 0 (alignment: 16)
 //   ---------------------------------------------------------------
 //  | 1, 2, ... 15, 16 | 17, 18, ..., 31, 32 | 33, 34, ..., 47, 48 |  Blk Number (unique within same chunk)
 //   ---------------------------------------------------------------
-//     BlkTrackRecord-1    BlkTrackRecord-2             Record-1 and Record-2 could belongs to two different read (or one read); 
-//                                                      Record-1/2 could be referenced by multiple reads fall through on same base ids;
-//      [ ],  [ ],  [ ]     [ ], [ ], [ ]               m_waiters: vector of shared_ptr
-//       |     |      \     /     |    |
-//       |     |       \   /      |    |
-//       |     |         |        |    |
-//      ( )   ( )       ( )      ( )  ( )                waiter's instance
+//        Region-1            Region-2              Region-1 and Region-2 could belong to two different reads (or one
+//           |                   |                  read), and could be referenced by multiple reads;
+//     [cnt | waiting]     [cnt | waiting]          slots, std::atomic< uint64_t >
+//           |                   |
+//      ( )   ( )               ( )                 waiter's instance, kept in the waiter list of the slot's shard
+//
+//  Slots are a fixed size array, consecutive regions of a chunk map to distinct slots. Regions which are far apart can
+//  share a slot, which can only make a free wait on an unrelated read, never release it early.
 //
 //  clang-format on
 //
-struct BlkTrackRecord {
-    BlkId m_key; // aligned key
-    int64_t m_ref_cnt{0};
-    folly::small_vector< blk_track_waiter_ptr, 8 > m_waiters; // multiple waiters can wait on same record
-};
-
 class BlkReadTrackerMetrics : public sisl::MetricsGroup {
 public:
     explicit BlkReadTrackerMetrics() : sisl::MetricsGroupWrapper("BlkReadTracker", "DataSvc") {
@@ -109,16 +110,27 @@ public:
 };
 
 class BlkReadTracker {
-    static constexpr uint32_t s_expected_num_records = 1000;
+    static constexpr uint32_t s_default_num_slots = 64 * 1024;
+    static constexpr uint32_t s_num_shards = 64;
     static constexpr uint16_t s_entries_per_record = 8; // this number could be candidate to tune perf;
 
+    static constexpr uint64_t s_waiting_bit = 1ull << 63;
+    static constexpr uint64_t s_ref_cnt_mask = s_waiting_bit - 1;
+
+    struct Shard {
+        std::mutex mtx;
+        std::unordered_map< uint32_t, folly::small_vector< blk_track_waiter_ptr, 4 > > waiters; // slot -> waiters
+    };
+
 private:
-    sisl::SimpleHashMap< BlkId, BlkTrackRecord > m_pending_reads_map;
+    std::unique_ptr< std::atomic< uint64_t >[] > m_slots;
+    uint32_t m_num_slots;
+    std::array< Shard, s_num_shards > m_shards;
     BlkReadTrackerMetrics m_metrics;
     uint32_t m_entries_per_record{s_entries_per_record};
 
 public:
-    BlkReadTracker();
+    explicit BlkReadTracker(uint32_t num_slots = s_default_num_slots);
     ~BlkReadTracker();
 
     BlkReadTracker(const BlkReadTracker&) = delete;
@@ -127,29 +139,41 @@ public:
     BlkReadTracker& operator=(BlkReadTracker&&) noexcept = delete;
 
     uint16_t entries_per_record() const;
-    
+
     BlkReadTrackerMetrics& get_metrics();
 
+    /**
+     * @brief : set the number of blks per tracked region. It can only be changed when there are no pending reads;
+     */
     void set_entries_per_record(uint16_t num_entries);
 
     /**
-     * @brief :  Insert the blkid into read tracker. If entry already exists, it will increment the reference count of
-     * the blkid It symbolises that this blkid is being read right now.
+     * @brief :  Insert the blkid into read tracker. It increments the reference count of every region the blkid spans.
+     * It symbolises that this blkid is being read right now.
      *
      * @param blkid : the blkid that is being added for reference;
      */
     void insert(const BlkId& blkid);
 
+    /**
+     * @brief : Insert all the pieces of the blkid in one go;
+     */
+    void insert(MultiBlkId const& blkids);
+
     /**
      * @brief : decrease the reference count of the BlkId by 1 in this read tracker.
-     * If the ref count drops to zero, it means no read is pending on this blkid and if there is a waiter on this blkid,
-     * callback should be triggered and all entries associated with this blkid (there could be more than one
-     * sub_ranges) should be removed.
+     * If the ref count of a region drops to zero, it means no read is pending on this region and the waiters on it are
+     * released; the callback of a waiter is triggered once it is released from all the regions it waits on.
      *
      * @param blkid : blkid that is being dereferneced;
      */
     void remove(const BlkId& blkid);
 
+    /**
+     * @brief : Remove all the pieces of the blkid in one go;
+     */
+    void remove(MultiBlkId const& blkids);
+
     /**
      * @brief : Check if the reference count of the blkid is 0 or entry itself doesn't exists.
      * It will do the callback if the ref count is zero or the blkid entry doesn't exsit;
@@ -159,21 +183,26 @@ public:
      */
     void wait_on(MultiBlkId const& blkids, after_remove_cb_t&& after_remove_cb);
 
-    /**
-     * @brief : get size of the pending map;
-     *
-     * @return : size of the pending map;
-     */
-    // uint64_t get_size() const { return m_pending_reads_map.get_size(); }
-
 private:
     /**
-     * @brief
-     *
-     * @param blkid
-     * @param new_ref_count
-     * @param waiters
+     * @brief : call the func with the slot index of every region the blkid spans;
      */
-    void merge(const BlkId& blkid, int64_t new_ref_count, const std::shared_ptr< blk_track_waiter >& waiters);
+    template < typename FuncT >
+    void for_each_slot(const BlkId& blkid, FuncT&& func) const {
+        if (blkid.blk_count() == 0) { return; }
+        auto const first_region = blkid.blk_num() / entries_per_record();
+        auto const last_region = (blkid.blk_num() + blkid.blk_count() - 1) / entries_per_record();
+        // Spread the chunks apart, so that consecutive regions of a chunk never share a slot
+        auto const chunk_base = uint64_t(blkid.chunk_num()) * 0x9E3779B1ull;
+        for (auto region = first_region; region <= last_region; ++region) {
+            func(uint32_t((chunk_base + region) % m_num_slots));
+        }
+    }
+
+    void add_ref(const BlkId& blkid);
+    void drop_ref(const BlkId& blkid);
+    void add_waiter(uint32_t slot, const blk_track_waiter_ptr& waiter);
+    void release_waiters(uint32_t slot);
+    Shard& shard_of(uint32_t slot) { return m_shards[slot % s_num_shards]; }
 };
 } // namespace homestore
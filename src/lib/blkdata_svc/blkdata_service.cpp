@@ -23,7 +23,10 @@
 #include "common/homestore_config.hpp" // is_data_drive_hdd
 #include "common/homestore_assert.hpp"
 #include "common/error.h"
+#include "common/resource_mgr.hpp"
 #include "blk_read_tracker.hpp"
+#include "blk_data_cache.hpp"
+#include "blk_data_compressor.hpp"
 #include "data_svc_cp.hpp"
 
 namespace homestore {
@@ -78,17 +81,58 @@ static auto collect_all_futures(std::vector< folly::Future< std::error_code > >&
     });
 }
 
+// Data cache drops the old copy of the blocks before the write is issued and again once it completes, in case a read
+// which raced with the write has cached it. If the cache is write through, the written data is cached instead.
+template < typename WriteFn >
+static folly::Future< std::error_code > write_with_cache(BlkDataCache* cache, BlkId const& bid, sisl::sg_iovs_t iovs,
+                                                         uint32_t size, WriteFn&& write_fn) {
+    if (cache == nullptr) { return write_fn(); }
+
+    cache->invalidate(bid);
+    return write_fn().thenValue([cache, bid, iovs = std::move(iovs), size](auto&& ec) {
+        if (!ec && HS_DYNAMIC_CONFIG(generic.data_cache_write_through)) {
+            cache->insert(bid, iovs.data(), s_cast< int >(iovs.size()), size, true /* overwrite */);
+        } else {
+            cache->invalidate(bid);
+        }
+        return folly::makeFuture< std::error_code >(std::move(ec));
+    });
+}
+
 folly::Future< std::error_code > BlkDataService::async_read(MultiBlkId const& blkid, uint8_t* buf, uint32_t size,
                                                             bool part_of_batch) {
     if (is_stopping()) return folly::makeFuture< std::error_code >(std::make_error_code(std::errc::operation_canceled));
+    if (!m_data_compressor) { return async_read_raw(blkid, buf, size, part_of_batch); }
+    if (BlkDataCompressor::is_compressed(blkid.blk_count() * m_blk_size, size)) {
+        return async_read_compressed(blkid, sisl::sg_iovs_t{iovec{buf, size}}, size, part_of_batch);
+    }
+    return async_read_raw(blkid, buf, size, part_of_batch).thenValue([this, buf, size](auto&& ec) {
+        if (ec) { return folly::makeFuture< std::error_code >(std::move(ec)); }
+        iovec const iov{buf, size};
+        return folly::makeFuture< std::error_code >(m_data_compressor->check_raw_read(&iov, 1, size));
+    });
+}
+
+folly::Future< std::error_code > BlkDataService::async_read_raw(MultiBlkId const& blkid, uint8_t* buf, uint32_t size,
+                                                                bool part_of_batch) {
     incr_pending_request_num();
-    auto do_read = [this](BlkId const& bid, uint8_t* buf, uint32_t size, bool part_of_batch) {
+    auto do_read = [this](BlkId const& bid, uint8_t* buf, uint32_t size,
+                          bool part_of_batch) -> folly::Future< std::error_code > {
+        iovec const iov{buf, size};
+        if (m_data_cache && m_data_cache->read(bid, &iov, 1, size)) {
+            return folly::makeFuture< std::error_code >(std::error_code{});
+        }
         m_blk_read_tracker->insert(bid);
 
-        return m_vdev->async_read(r_cast< char* >(buf), size, bid, part_of_batch).thenValue([this, bid](auto&& ec) {
-            m_blk_read_tracker->remove(bid);
-            return folly::makeFuture< std::error_code >(std::move(ec));
-        });
+        // Taken before the read is issued, so a write of the blocks issued meanwhile keeps it from caching them
+        auto const gen = m_data_cache ? m_data_cache->generation(bid) : 0;
+        return m_vdev->async_read(r_cast< char* >(buf), size, bid, part_of_batch)
+            .thenValue([this, bid, iov, size, gen](auto&& ec) {
+                // Cache the blocks before the read is untracked, so a free waiting on the read drops them after
+                if (!ec && m_data_cache) { m_data_cache->insert_read(bid, &iov, 1, size, gen); }
+                m_blk_read_tracker->remove(bid);
+                return folly::makeFuture< std::error_code >(std::move(ec));
+            });
     };
 
     if (blkid.num_pieces() == 1) {
@@ -112,15 +156,38 @@ folly::Future< std::error_code > BlkDataService::async_read(MultiBlkId const& bl
 folly::Future< std::error_code > BlkDataService::async_read(MultiBlkId const& blkid, sisl::sg_list& sgs, uint32_t size,
                                                             bool part_of_batch) {
     if (is_stopping()) return folly::makeFuture< std::error_code >(std::make_error_code(std::errc::operation_canceled));
+    if (!m_data_compressor) { return async_read_raw(blkid, sgs, size, part_of_batch); }
+    if (BlkDataCompressor::is_compressed(blkid.blk_count() * m_blk_size, size)) {
+        return async_read_compressed(blkid, sgs.iovs, size, part_of_batch);
+    }
+    return async_read_raw(blkid, sgs, size, part_of_batch).thenValue([this, iovs = sgs.iovs, size](auto&& ec) {
+        if (ec) { return folly::makeFuture< std::error_code >(std::move(ec)); }
+        return folly::makeFuture< std::error_code >(
+            m_data_compressor->check_raw_read(iovs.data(), s_cast< int >(iovs.size()), size));
+    });
+}
+
+folly::Future< std::error_code > BlkDataService::async_read_raw(MultiBlkId const& blkid, sisl::sg_list& sgs,
+                                                                uint32_t size, bool part_of_batch) {
     incr_pending_request_num();
     // TODO: sg_iovs_t should not be passed by value. We need it pass it as const&, but that is failing because
     // iovs.data() will then return "const iovec*", but unfortunately all the way down to iomgr, we take iovec*
     // instead it can easily take "const iovec*". Until we change this is made as copy by value
-    auto do_read = [this](BlkId const& bid, sisl::sg_iovs_t iovs, uint32_t size, bool part_of_batch) {
+    auto do_read = [this](BlkId const& bid, sisl::sg_iovs_t iovs, uint32_t size,
+                          bool part_of_batch) -> folly::Future< std::error_code > {
+        if (m_data_cache && m_data_cache->read(bid, iovs.data(), s_cast< int >(iovs.size()), size)) {
+            return folly::makeFuture< std::error_code >(std::error_code{});
+        }
         m_blk_read_tracker->insert(bid);
 
+        // Taken before the read is issued, so a write of the blocks issued meanwhile keeps it from caching them
+        auto const gen = m_data_cache ? m_data_cache->generation(bid) : 0;
         return m_vdev->async_readv(iovs.data(), iovs.size(), size, bid, part_of_batch)
-            .thenValue([this, bid](auto&& ec) {
+            .thenValue([this, bid, iovs, size, gen](auto&& ec) {
+                // Cache the blocks before the read is untracked, so a free waiting on the read drops them after
+                if (!ec && m_data_cache) {
+                    m_data_cache->insert_read(bid, iovs.data(), s_cast< int >(iovs.size()), size, gen);
+                }
                 m_blk_read_tracker->remove(bid);
                 return folly::makeFuture< std::error_code >(std::move(ec));
             });
@@ -149,12 +216,27 @@ folly::Future< std::error_code > BlkDataService::async_alloc_write(const sisl::s
                                                                    bool part_of_batch) {
     if (is_stopping()) return folly::makeFuture< std::error_code >(std::make_error_code(std::errc::operation_canceled));
     incr_pending_request_num();
-    const auto status = alloc_blks(sgs.size, hints, out_blkids);
+    sisl::io_blob_safe extent;
+    auto const extent_size = m_data_compressor ? m_data_compressor->compress(sgs, extent) : 0;
+
+    const auto status = alloc_blks((extent_size > 0) ? extent_size : sgs.size, hints, out_blkids);
     if (status != BlkAllocStatus::SUCCESS) {
         decr_pending_request_num();
         return folly::makeFuture< std::error_code >(std::make_error_code(std::errc::resource_unavailable_try_again));
     }
-    auto ret = async_write(sgs, out_blkids, part_of_batch);
+    if (extent_size == 0) {
+        auto ret = async_write(sgs, out_blkids, part_of_batch);
+        decr_pending_request_num();
+        return ret;
+    }
+
+    // Compressed extent is written in place of the data and has to live until the write completes
+    auto extent_sgs = std::make_unique< sisl::sg_list >(
+        sisl::sg_list{extent_size, sisl::sg_iovs_t{iovec{extent.bytes(), extent_size}}});
+    auto ret = async_write(*extent_sgs, out_blkids, part_of_batch)
+                   .thenValue([extent = std::move(extent), extent_sgs = std::move(extent_sgs)](auto&& ec) {
+                       return folly::makeFuture< std::error_code >(std::move(ec));
+                   });
     decr_pending_request_num();
     return ret;
 }
@@ -163,10 +245,15 @@ folly::Future< std::error_code > BlkDataService::async_write(const char* buf, ui
                                                              bool part_of_batch) {
     if (is_stopping()) return folly::makeFuture< std::error_code >(std::make_error_code(std::errc::operation_canceled));
     incr_pending_request_num();
+    auto do_write = [this](BlkId const& bid, const char* buf, uint32_t size, bool part_of_batch) {
+        return write_with_cache(m_data_cache.get(), bid, sisl::sg_iovs_t{iovec{const_cast< char* >(buf), size}}, size,
+                                [&]() { return m_vdev->async_write(buf, size, bid, part_of_batch); });
+    };
+
     if (blkid.num_pieces() == 1) {
         // Shortcut to most common case
         decr_pending_request_num();
-        return m_vdev->async_write(buf, size, blkid.to_single_blkid(), part_of_batch);
+        return do_write(blkid.to_single_blkid(), buf, size, part_of_batch);
     } else {
         static thread_local std::vector< folly::Future< std::error_code > > s_futs;
         s_futs.clear();
@@ -175,7 +262,7 @@ folly::Future< std::error_code > BlkDataService::async_write(const char* buf, ui
         auto blkid_it = blkid.iterate();
         while (auto const bid = blkid_it.next()) {
             uint32_t sz = bid->blk_count() * m_blk_size;
-            s_futs.emplace_back(m_vdev->async_write(ptr, sz, *bid, part_of_batch));
+            s_futs.emplace_back(do_write(*bid, ptr, sz, part_of_batch));
             ptr += sz;
         }
         decr_pending_request_num();
@@ -190,10 +277,15 @@ folly::Future< std::error_code > BlkDataService::async_write(sisl::sg_list const
     // TODO: Async write should pass this by value the sgs.size parameter as well, currently vdev write routine
     // walks through again all the iovs and then getting the len to pass it down to iomgr. This defeats the purpose of
     // taking size parameters (which was done exactly done to avoid this walk through)
+    auto do_write = [this](BlkId const& bid, sisl::sg_iovs_t const& iovs, uint32_t size, bool part_of_batch) {
+        return write_with_cache(m_data_cache.get(), bid, iovs, size,
+                                [&]() { return m_vdev->async_writev(iovs.data(), iovs.size(), bid, part_of_batch); });
+    };
+
     if (blkid.num_pieces() == 1) {
         // Shortcut to most common case
         decr_pending_request_num();
-        return m_vdev->async_writev(sgs.iovs.data(), sgs.iovs.size(), blkid.to_single_blkid(), part_of_batch);
+        return do_write(blkid.to_single_blkid(), sgs.iovs, sgs.size, part_of_batch);
     } else {
         static thread_local std::vector< folly::Future< std::error_code > > s_futs;
         s_futs.clear();
@@ -201,8 +293,9 @@ folly::Future< std::error_code > BlkDataService::async_write(sisl::sg_list const
 
         auto blkid_it = blkid.iterate();
         while (auto const bid = blkid_it.next()) {
-            const auto iovs = sg_it.next_iovs(bid->blk_count() * m_blk_size);
-            s_futs.emplace_back(m_vdev->async_writev(iovs.data(), iovs.size(), *bid, part_of_batch));
+            uint32_t const sz = bid->blk_count() * m_blk_size;
+            const auto iovs = sg_it.next_iovs(sz);
+            s_futs.emplace_back(do_write(*bid, iovs, sz, part_of_batch));
         }
         decr_pending_request_num();
         return collect_all_futures(s_futs);
@@ -284,6 +377,7 @@ folly::Future< std::error_code > BlkDataService::async_free_blk(MultiBlkId const
         promise.setValue(std::make_error_code(std::errc::resource_unavailable_try_again));
     } else {
         m_blk_read_tracker->wait_on(bids, [this, bids, p = std::move(promise)]() mutable {
+            drop_from_data_cache(bids);
             {
                 auto cpg = hs()->cp_mgr().cp_guard();
                 m_vdev->free_blk(bids, s_cast< VDevCPContext* >(cpg.context(cp_consumer_t::BLK_DATA_SVC)));
@@ -303,6 +397,7 @@ std::error_code BlkDataService::free_blk_now(MultiBlkId const& bids) {
         decr_pending_request_num();
         return std::make_error_code(std::errc::resource_unavailable_try_again);
     } else {
+        drop_from_data_cache(bids);
         auto cpg = hs()->cp_mgr().cp_guard();
         m_vdev->free_blk(bids, s_cast< VDevCPContext* >(cpg.context(cp_consumer_t::BLK_DATA_SVC)), true /* free_now */);
     }
@@ -310,9 +405,37 @@ std::error_code BlkDataService::free_blk_now(MultiBlkId const& bids) {
     return std::error_code{};
 }
 
+void BlkDataService::drop_from_data_cache(MultiBlkId const& bids) {
+    if (!m_data_cache) { return; }
+    auto it = bids.iterate();
+    while (auto const bid = it.next()) {
+        m_data_cache->invalidate(*bid);
+    }
+}
+
+folly::Future< std::error_code > BlkDataService::async_read_compressed(MultiBlkId const& blkid, sisl::sg_iovs_t iovs,
+                                                                       uint32_t size, bool part_of_batch) {
+    // Read the whole extent through the regular path, so it is tracked and cached same as the raw data
+    uint32_t const extent_size = blkid.blk_count() * m_blk_size;
+    sisl::io_blob_safe extent(extent_size, get_align_size());
+    auto* buf = extent.bytes();
+    return async_read_raw(blkid, buf, extent_size, part_of_batch)
+        .thenValue([this, extent = std::move(extent), iovs = std::move(iovs), size](auto&& ec) {
+            if (ec) { return folly::makeFuture< std::error_code >(std::move(ec)); }
+            return folly::makeFuture< std::error_code >(m_data_compressor->decompress(
+                extent.cbytes(), extent.size(), iovs.data(), s_cast< int >(iovs.size()), size));
+        });
+}
+
 bool BlkDataService::is_blk_alloced(BlkId const& blkid) const { return m_vdev->is_blk_alloced(blkid); }
 
 void BlkDataService::start() {
+    if (auto const cache_size = resource_mgr().get_data_cache_size(); cache_size > 0) {
+        m_data_cache = std::make_unique< BlkDataCache >(cache_size, m_blk_size);
+        LOGINFO("Data block cache enabled, size={} blk_size={}", cache_size, m_blk_size);
+    }
+    m_data_compressor = std::make_unique< BlkDataCompressor >(m_blk_size, get_align_size());
+
     // Register to CP for flush dirty buffers underlying virtual device layer;
     hs()->cp_mgr().register_consumer(cp_consumer_t::BLK_DATA_SVC,
                                      std::move(std::make_unique< DataSvcCPCallbacks >(m_vdev)));
@@ -13,27 +13,52 @@
  * specific language governing permissions and limitations under the License.
  *
  *********************************************************************************/
+#include <condition_variable>
+#include <mutex>
+
 #include <homestore/homestore.hpp>
+#include "common/homestore_config.hpp"
 #include "data_svc_cp.hpp"
 #include "device/virtual_dev.hpp"
 
 namespace homestore {
 
-DataSvcCPCallbacks::DataSvcCPCallbacks(shared< VirtualDev > vdev) : m_vdev{vdev} {}
+DataSvcCPCallbacks::DataSvcCPCallbacks(shared< VirtualDev > vdev) : m_vdev{vdev} {
+    if (!HS_DYNAMIC_CONFIG(generic.data_cp_flush_in_dedicated_thread)) { return; }
+
+    struct Context {
+        std::condition_variable cv;
+        std::mutex mtx;
+        bool started{false};
+    };
+    auto ctx = std::make_shared< Context >();
+
+    iomanager.create_reactor("data_cp_flush", iomgr::INTERRUPT_LOOP, 1u, [this, ctx](bool is_started) {
+        if (is_started) {
+            {
+                std::unique_lock< std::mutex > lk{ctx->mtx};
+                m_cp_flush_fiber = iomanager.iofiber_self();
+                ctx->started = true;
+            }
+            ctx->cv.notify_one();
+        }
+    });
+
+    {
+        std::unique_lock< std::mutex > lk{ctx->mtx};
+        ctx->cv.wait(lk, [ctx] { return ctx->started; });
+    }
+}
 
 std::unique_ptr< CPContext > DataSvcCPCallbacks::on_switchover_cp(CP* cur_cp, CP* new_cp) {
     return m_vdev->create_cp_context(new_cp);
 }
 
 folly::Future< bool > DataSvcCPCallbacks::cp_flush(CP* cp) {
-    // Pick a CP Manager blocking IO fiber to execute the cp flush of vdev
-    // iomanager.run_on_forget(hs()->cp_mgr().pick_blocking_io_fiber(), [this, cp]() {
+    // Chunk blk allocators are flushed on the data cp flush thread, so the cp thread is free to move on with the other
+    // consumers. The context is completed once the last chunk is flushed.
     auto cp_ctx = s_cast< VDevCPContext* >(cp->context(cp_consumer_t::BLK_DATA_SVC));
-    m_vdev->cp_flush(cp_ctx); // this is a blocking io call
-    cp_ctx->complete(true);
-    //});
-
-    return folly::makeFuture< bool >(true);
+    return m_vdev->async_cp_flush(cp_ctx, m_cp_flush_fiber);
 }
 
 void DataSvcCPCallbacks::cp_cleanup(CP* cp) {}
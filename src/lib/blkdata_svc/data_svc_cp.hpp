@@ -14,6 +14,7 @@
  *
  *********************************************************************************/
 #pragma once
+#include <iomgr/iomgr.hpp>
 #include <homestore/checkpoint/cp_mgr.hpp>
 #include <homestore/checkpoint/cp.hpp>
 #include <homestore/homestore_decl.hpp>
@@ -33,6 +34,7 @@ public:
 
 private:
     shared< VirtualDev > m_vdev;
+    iomgr::io_fiber_t m_cp_flush_fiber{nullptr}; // Fiber of the dedicated flush thread, null to flush inline
 };
 
 } // namespace homestore
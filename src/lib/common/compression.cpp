@@ -0,0 +1,122 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include <lz4.h>
+#include <zstd.h>
+#include <sisl/fds/utils.hpp>
+
+#include "compression.hpp"
+
+namespace homestore {
+compression_codec_t hs_compressor::to_codec(uint32_t v) {
+    switch (v) {
+    case uint32_cast(compression_codec_t::LZ4):
+        return compression_codec_t::LZ4;
+    case uint32_cast(compression_codec_t::ZSTD):
+        return compression_codec_t::ZSTD;
+    default:
+        return compression_codec_t::NONE;
+    }
+}
+
+size_t hs_compressor::compress_bound(compression_codec_t codec, size_t src_size) {
+    switch (codec) {
+    case compression_codec_t::LZ4:
+        return LZ4_compressBound(s_cast< int >(src_size));
+    case compression_codec_t::ZSTD:
+        return ZSTD_compressBound(src_size);
+    default:
+        return src_size;
+    }
+}
+
+size_t hs_compressor::compress(compression_codec_t codec, uint8_t const* src, size_t src_size, uint8_t* dst,
+                               size_t dst_capacity, int level) {
+    switch (codec) {
+    case compression_codec_t::LZ4: {
+        auto const ret = LZ4_compress_fast(r_cast< const char* >(src), r_cast< char* >(dst), s_cast< int >(src_size),
+                                           s_cast< int >(dst_capacity), (level > 0) ? level : 1 /* acceleration */);
+        return (ret > 0) ? s_cast< size_t >(ret) : 0;
+    }
+    case compression_codec_t::ZSTD: {
+        auto const ret = ZSTD_compress(dst, dst_capacity, src, src_size, (level > 0) ? level : 1);
+        return ZSTD_isError(ret) ? 0 : ret;
+    }
+    default:
+        return 0;
+    }
+}
+
+size_t hs_compressor::compress(compression_codec_t codec, sisl::sg_list const& src, uint8_t* dst,
+                               size_t dst_capacity, int level) {
+    if (src.iovs.size() == 1) {
+        return compress(codec, r_cast< uint8_t const* >(src.iovs[0].iov_base), src.iovs[0].iov_len, dst, dst_capacity,
+                        level);
+    }
+
+    auto gathered = std::make_unique< uint8_t[] >(src.size);
+    size_t offset{0};
+    for (auto const& iov : src.iovs) {
+        std::memcpy(gathered.get() + offset, iov.iov_base, iov.iov_len);
+        offset += iov.iov_len;
+    }
+    return compress(codec, gathered.get(), offset, dst, dst_capacity, level);
+}
+
+bool hs_compressor::decompress(compression_codec_t codec, uint8_t const* src, size_t src_size, uint8_t* dst,
+                               size_t dst_size) {
+    switch (codec) {
+    case compression_codec_t::LZ4: {
+        auto const ret = LZ4_decompress_safe(r_cast< const char* >(src), r_cast< char* >(dst), s_cast< int >(src_size),
+                                             s_cast< int >(dst_size));
+        return (ret >= 0) && (s_cast< size_t >(ret) == dst_size);
+    }
+    case compression_codec_t::ZSTD: {
+        auto const ret = ZSTD_decompress(dst, dst_size, src, src_size);
+        return !ZSTD_isError(ret) && (ret == dst_size);
+    }
+    case compression_codec_t::NONE:
+        if (src_size != dst_size) { return false; }
+        std::memcpy(dst, src, dst_size);
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool hs_compressor::is_compressible(uint8_t const* src, size_t src_size, uint32_t sample_size,
+                                    uint32_t min_saving_pct) {
+    auto const len = std::min(s_cast< size_t >(sample_size), src_size);
+    if (len == 0) { return false; }
+
+    // LZ4 at the default acceleration is fast enough to be used as an entropy probe irrespective of the codec that
+    // is eventually used to compress the whole payload.
+    auto const bound = LZ4_compressBound(s_cast< int >(len));
+    auto sample_out = std::make_unique< char[] >(bound);
+    auto const ret = LZ4_compress_default(r_cast< const char* >(src), sample_out.get(), s_cast< int >(len), bound);
+    if (ret <= 0) { return false; }
+    return (s_cast< size_t >(ret) * 100) <= (len * (100 - std::min(min_saving_pct, 100u)));
+}
+
+bool hs_compressor::is_compressible(sisl::sg_list const& src, uint32_t sample_size, uint32_t min_saving_pct) {
+    if (src.iovs.empty()) { return false; }
+    return is_compressible(r_cast< uint8_t const* >(src.iovs[0].iov_base), src.iovs[0].iov_len, sample_size,
+                           min_saving_pct);
+}
+} // namespace homestore
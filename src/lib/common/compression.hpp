@@ -0,0 +1,59 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <sisl/fds/buffer.hpp>
+#include <sisl/utility/enum.hpp>
+
+namespace homestore {
+
+// Values are persisted/sent on wire, do not change the existing ones
+VENUM(compression_codec_t, uint8_t, NONE = 0, LZ4 = 1, ZSTD = 2);
+
+class hs_compressor {
+public:
+    /// @brief Convert a configured value to a codec, anything unknown is treated as no compression
+    static compression_codec_t to_codec(uint32_t v);
+
+    /// @brief Bitmask (1 << codec) of all the codecs this build is able to decompress
+    static uint8_t supported_codecs_mask() {
+        return static_cast< uint8_t >((1u << static_cast< uint8_t >(compression_codec_t::LZ4)) |
+                                      (1u << static_cast< uint8_t >(compression_codec_t::ZSTD)));
+    }
+
+    /// @brief Worst case size of compressing src_size bytes with the given codec
+    static size_t compress_bound(compression_codec_t codec, size_t src_size);
+
+    /// @brief Compress src into dst. Returns the compressed size or 0 if compression failed or the output does not fit
+    /// within dst_capacity.
+    static size_t compress(compression_codec_t codec, uint8_t const* src, size_t src_size, uint8_t* dst,
+                           size_t dst_capacity, int level = 0);
+
+    /// @brief Same as above for a scattered buffer. Multiple iovs are gathered before compressing.
+    static size_t compress(compression_codec_t codec, sisl::sg_list const& src, uint8_t* dst, size_t dst_capacity,
+                           int level = 0);
+
+    /// @brief Decompress src into dst, which must be exactly dst_size (the original size) bytes. Returns false if the
+    /// input is corrupted or does not decompress to dst_size.
+    static bool decompress(compression_codec_t codec, uint8_t const* src, size_t src_size, uint8_t* dst,
+                           size_t dst_size);
+
+    /// @brief Cheap estimate of whether a payload is worth compressing. Compresses up to sample_size bytes from the
+    /// start of the payload with the fastest codec and checks whether it saved at least min_saving_pct percent.
+    static bool is_compressible(sisl::sg_list const& src, uint32_t sample_size, uint32_t min_saving_pct);
+    static bool is_compressible(uint8_t const* src, size_t src_size, uint32_t sample_size, uint32_t min_saving_pct);
+};
+} // namespace homestore
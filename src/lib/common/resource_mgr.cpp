@@ -179,6 +179,10 @@ uint64_t ResourceMgr::get_cache_size() const {
     return ((HS_STATIC_CONFIG(input.io_mem_size()) * HS_DYNAMIC_CONFIG(resource_limits.cache_size_percent)) / 100);
 }
 
+uint64_t ResourceMgr::get_data_cache_size() const {
+    return ((get_cache_size() * std::min(HS_DYNAMIC_CONFIG(resource_limits.data_cache_size_percent), 100u)) / 100);
+}
+
 bool ResourceMgr::check_journal_descriptor_size(const uint64_t used_size) const {
     return (used_size >= get_journal_descriptor_size_limit());
 }
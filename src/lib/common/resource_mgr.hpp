@@ -76,6 +76,9 @@ public:
     /* get cache size */
     uint64_t get_cache_size() const;
 
+    /* get the part of cache size used by the data block cache */
+    uint64_t get_data_cache_size() const;
+
     /**
      * @brief Checks if the journal virtual device (vdev) size is within the specified limits.
      *
@@ -0,0 +1,170 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#include <algorithm>
+
+#include "common/s3fifo_evictor.hpp"
+
+namespace homestore {
+
+S3FifoEvictor::S3FifoEvictor(int64_t max_size, uint32_t num_partitions, uint32_t small_queue_pct) :
+        sisl::Evictor(max_size, num_partitions),
+        m_partitions(std::max(num_partitions, 1u)),
+        m_part_max_size{max_size / std::max(num_partitions, 1u)},
+        m_small_max_size{(m_part_max_size * std::clamp(small_queue_pct, 1u, 90u)) / 100} {}
+
+bool S3FifoEvictor::add_record(uint64_t hash_code, sisl::CacheRecord& record) {
+    auto& p = get_partition(hash_code);
+    std::unique_lock lg(p.mtx);
+
+    // Same as the LRU evictor, the cache owner can't do anything about a full cache other than failing the insert of a
+    // node it already holds, so admit the record anyway and let the next additions bring the partition back in limits
+    if (!make_room(p, record.size())) { COUNTER_INCREMENT(m_metrics, evictor_evict_fail_cnt, 1); }
+
+    uint8_t const priority = m_priority_cb ? m_priority_cb(record) : 0;
+    bool to_main = (priority > 0);
+    if (p.ghost_set.erase(hash_code) > 0) {
+        COUNTER_INCREMENT(m_metrics, evictor_ghost_hit_cnt, 1);
+        to_main = true;
+    }
+
+    p.records[&record] = RecordInfo{hash_code, priority, priority, to_main};
+    if (to_main) {
+        p.main_q.push_back(record);
+        p.main_size += record.size();
+    } else {
+        p.small_q.push_back(record);
+        p.small_size += record.size();
+    }
+    return true;
+}
+
+void S3FifoEvictor::remove_record(uint64_t hash_code, sisl::CacheRecord& record) {
+    auto& p = get_partition(hash_code);
+    std::unique_lock lg(p.mtx);
+
+    auto it = p.records.find(&record);
+    if (it == p.records.end()) { return; }
+    if (it->second.in_main) {
+        p.main_q.erase(p.main_q.iterator_to(record));
+        p.main_size -= record.size();
+    } else {
+        p.small_q.erase(p.small_q.iterator_to(record));
+        p.small_size -= record.size();
+    }
+    p.records.erase(it);
+}
+
+void S3FifoEvictor::record_accessed(uint64_t hash_code, sisl::CacheRecord& record) {
+    auto& p = get_partition(hash_code);
+    std::unique_lock lg(p.mtx);
+
+    auto it = p.records.find(&record);
+    if (it == p.records.end()) { return; }
+    auto& info = it->second;
+    info.access_cnt = std::min(uint8_t(info.access_cnt + 1), uint8_t(max_access_cnt + info.priority));
+}
+
+void S3FifoEvictor::record_resized(uint64_t hash_code, const sisl::CacheRecord& record, uint32_t old_size) {
+    auto& p = get_partition(hash_code);
+    std::unique_lock lg(p.mtx);
+
+    auto it = p.records.find(&record);
+    if (it == p.records.end()) { return; }
+    int64_t const delta = int64_t(record.size()) - int64_t(old_size);
+    if (it->second.in_main) {
+        p.main_size += delta;
+    } else {
+        p.small_size += delta;
+    }
+}
+
+bool S3FifoEvictor::make_room(Partition& p, uint32_t needed_size) {
+    // Every record is visited a bounded number of times, after which whatever is left is not evictable
+    auto budget = (p.small_q.size() + p.main_q.size()) * (max_access_cnt + 2u) + 1u;
+    while ((p.small_size + p.main_size + needed_size) > m_part_max_size) {
+        if (budget-- == 0) { return false; }
+        if (!p.small_q.empty() && ((p.small_size >= m_small_max_size) || p.main_q.empty())) {
+            evict_from_small(p);
+        } else if (!p.main_q.empty()) {
+            evict_from_main(p);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void S3FifoEvictor::evict_from_small(Partition& p) {
+    auto& rec = p.small_q.front();
+    auto& info = p.records[&rec];
+    p.small_q.pop_front();
+    p.small_size -= rec.size();
+
+    if (info.access_cnt == 0) {
+        auto const hash_code = info.hash_code;
+        if (try_evict(p, rec)) {
+            add_to_ghost(p, hash_code);
+            COUNTER_INCREMENT(m_metrics, evictor_small_evict_cnt, 1);
+            return;
+        }
+    } else {
+        COUNTER_INCREMENT(m_metrics, evictor_promote_cnt, 1);
+    }
+
+    // Accessed again while in the small queue or is not evictable right now, either way it moves to the main queue
+    info.access_cnt = info.priority;
+    info.in_main = true;
+    p.main_q.push_back(rec);
+    p.main_size += rec.size();
+}
+
+void S3FifoEvictor::evict_from_main(Partition& p) {
+    auto& rec = p.main_q.front();
+    auto& info = p.records[&rec];
+    auto const size = rec.size();
+    p.main_q.pop_front();
+
+    if ((info.access_cnt == 0) && try_evict(p, rec)) {
+        p.main_size -= size;
+        COUNTER_INCREMENT(m_metrics, evictor_main_evict_cnt, 1);
+        return;
+    }
+
+    if (info.access_cnt > 0) { --info.access_cnt; }
+    p.main_q.push_back(rec);
+}
+
+bool S3FifoEvictor::try_evict(Partition& p, sisl::CacheRecord& rec) {
+    // The eviction callback of the record family checks if the record can be evicted and if so removes it from the
+    // cache, which frees the record. So its info is looked up by the address before invoking the callback.
+    auto it = p.records.find(&rec);
+    if (!get_eviction_cb(rec.record_family_id())(rec)) { return false; }
+    p.records.erase(it);
+    return true;
+}
+
+void S3FifoEvictor::add_to_ghost(Partition& p, uint64_t hash_code) {
+    if (!p.ghost_set.insert(hash_code).second) { return; }
+    p.ghost_q.push_back(hash_code);
+
+    // Ghost queue remembers as many entries as the partition holds records
+    auto const max_ghosts = std::max(p.records.size(), size_t(1));
+    while (p.ghost_q.size() > max_ghosts) {
+        p.ghost_set.erase(p.ghost_q.front());
+        p.ghost_q.pop_front();
+    }
+}
+} // namespace homestore
@@ -0,0 +1,122 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#pragma once
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/intrusive/list.hpp>
+#include <sisl/cache/evictor.hpp>
+#include <sisl/metrics/metrics.hpp>
+
+namespace homestore {
+class S3FifoEvictorMetrics : public sisl::MetricsGroup {
+public:
+    explicit S3FifoEvictorMetrics() : sisl::MetricsGroup("S3FifoEvictor", "S3FifoEvictor") {
+        REGISTER_COUNTER(evictor_small_evict_cnt, "Records evicted from the small queue");
+        REGISTER_COUNTER(evictor_main_evict_cnt, "Records evicted from the main queue");
+        REGISTER_COUNTER(evictor_promote_cnt, "Records promoted from the small to the main queue");
+        REGISTER_COUNTER(evictor_ghost_hit_cnt, "Records readmitted directly into main queue through ghost queue");
+        REGISTER_COUNTER(evictor_evict_fail_cnt, "Records added after failing to make room for them");
+        register_me_to_farm();
+    }
+
+    S3FifoEvictorMetrics(const S3FifoEvictorMetrics&) = delete;
+    S3FifoEvictorMetrics(S3FifoEvictorMetrics&&) noexcept = delete;
+    S3FifoEvictorMetrics& operator=(const S3FifoEvictorMetrics&) = delete;
+    S3FifoEvictorMetrics& operator=(S3FifoEvictorMetrics&&) noexcept = delete;
+    ~S3FifoEvictorMetrics() { deregister_me_from_farm(); }
+};
+
+/*
+ * Scan resistant evictor based on S3-FIFO. It is a drop-in replacement of sisl::LRUEvictor for the caches built on
+ * sisl::SimpleCache.
+ *
+ * Every partition has a small FIFO queue, a main FIFO queue and a ghost queue of recently evicted hash codes:
+ * - A new record is admitted into the small queue. When it reaches the head of the small queue, it is promoted to the
+ *   main queue if it was accessed while in the small queue, otherwise evicted and its hash is remembered in the ghost
+ *   queue. So a one time sweep over many records (full range scans, btree destroy walks) only churns the small queue
+ *   and does not push the working set out of the cache.
+ * - A record whose hash is in the ghost queue is admitted directly into the main queue.
+ * - The main queue is a CLOCK, a record at its head which was accessed since its last visit is reinserted at the tail
+ *   with its access count decremented.
+ *
+ * Records which can't be evicted (dirty buffers for instance) are moved to the tail of the main queue instead.
+ * Accesses only update a counter and do not move the record in the list, unlike LRU.
+ *
+ * The cache owner can set a priority callback, which returns a credit for the record. Records with a non zero credit
+ * are admitted directly into the main queue and survive those many additional CLOCK rounds. IndexWBCache uses it to
+ * keep the interior nodes resident.
+ */
+class S3FifoEvictor : public sisl::Evictor {
+public:
+    using priority_cb_t = std::function< uint8_t(const sisl::CacheRecord&) >;
+    static constexpr uint8_t max_access_cnt{3};
+
+    S3FifoEvictor(int64_t max_size, uint32_t num_partitions, uint32_t small_queue_pct);
+    S3FifoEvictor(const S3FifoEvictor&) = delete;
+    S3FifoEvictor(S3FifoEvictor&&) noexcept = delete;
+    S3FifoEvictor& operator=(const S3FifoEvictor&) = delete;
+    S3FifoEvictor& operator=(S3FifoEvictor&&) noexcept = delete;
+    ~S3FifoEvictor() override = default;
+
+    bool add_record(uint64_t hash_code, sisl::CacheRecord& record) override;
+    void remove_record(uint64_t hash_code, sisl::CacheRecord& record) override;
+    void record_accessed(uint64_t hash_code, sisl::CacheRecord& record) override;
+    void record_resized(uint64_t hash_code, const sisl::CacheRecord& record, uint32_t old_size) override;
+
+    /// @brief Set the priority callback. It needs to be set before any record is added to the evictor.
+    void set_priority_cb(priority_cb_t cb) { m_priority_cb = std::move(cb); }
+
+private:
+    using record_list_t = boost::intrusive::list< sisl::CacheRecord >;
+
+    struct RecordInfo {
+        uint64_t hash_code;
+        uint8_t access_cnt;
+        uint8_t priority;
+        bool in_main;
+    };
+
+    struct Partition {
+        std::mutex mtx;
+        record_list_t small_q;
+        record_list_t main_q;
+        int64_t small_size{0};
+        int64_t main_size{0};
+        std::unordered_map< const sisl::CacheRecord*, RecordInfo > records;
+        std::deque< uint64_t > ghost_q;
+        std::unordered_set< uint64_t > ghost_set;
+    };
+
+    Partition& get_partition(uint64_t hash_code) { return m_partitions[hash_code % m_partitions.size()]; }
+    bool make_room(Partition& p, uint32_t needed_size);
+    void evict_from_small(Partition& p);
+    void evict_from_main(Partition& p);
+    bool try_evict(Partition& p, sisl::CacheRecord& rec);
+    void add_to_ghost(Partition& p, uint64_t hash_code);
+
+private:
+    std::vector< Partition > m_partitions;
+    int64_t m_part_max_size;
+    int64_t m_small_max_size;
+    priority_cb_t m_priority_cb{nullptr};
+    S3FifoEvictorMetrics m_metrics;
+};
+} // namespace homestore
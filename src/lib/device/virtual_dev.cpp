@@ -13,9 +13,11 @@
  * specific language governing permissions and limitations under the License.
  *
  *********************************************************************************/
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <climits>
 #include <cstdint>
 #include <functional>
 #include <iterator>
@@ -25,9 +27,11 @@
 #include <mutex>
 #include <string>
 #include <system_error>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
+#include <folly/small_vector.h>
 #include <sisl/fds/buffer.hpp>
 #include <sisl/metrics/metrics.hpp>
 #include <sisl/logging/logging.h>
@@ -52,6 +56,20 @@ SISL_LOGGING_DECL(device)
 
 namespace homestore {
 
+// IO queued by the async read/write APIs as part of a batch, until the batch is submitted. Batches are per thread, same
+// as in the drive interface underneath, so the queue is thread local.
+struct BatchedIO {
+    PhysicalDev* pdev;
+    bool is_write;
+    uint64_t dev_offset;
+    uint64_t size;
+    folly::small_vector< iovec, 4 > iovs;
+    folly::Promise< std::error_code > promise;
+};
+static thread_local std::vector< BatchedIO > s_batched_ios;
+
+static bool batch_coalesce_enabled() { return (HS_DYNAMIC_CONFIG(device->batch_coalesce_max_size_kb) != 0); }
+
 static std::shared_ptr< BlkAllocator > create_blk_allocator(blk_allocator_type_t btype, uint32_t vblock_size,
                                                             uint32_t ppage_sz, uint32_t align_sz, uint64_t size,
                                                             bool is_auto_recovery, uint32_t unique_id, bool is_init,
@@ -399,6 +417,10 @@ folly::Future< std::error_code > VirtualDev::async_write(const char* buf, uint32
     if (sisl_unlikely(!hs_utils::mod_aligned_sz(dev_offset, pdev->align_size()))) {
         COUNTER_INCREMENT(m_metrics, unalign_writes, 1);
     }
+    if (part_of_batch && batch_coalesce_enabled()) {
+        iovec const iov{const_cast< char* >(buf), size};
+        return queue_batch_io(pdev, true /* is_write */, dev_offset, &iov, 1, size);
+    }
     return pdev->async_write(buf, size, dev_offset, part_of_batch);
 }
 
@@ -442,6 +464,9 @@ folly::Future< std::error_code > VirtualDev::async_writev(const iovec* iov, cons
     if (sisl_unlikely(!hs_utils::mod_aligned_sz(dev_offset, pdev->align_size()))) {
         COUNTER_INCREMENT(m_metrics, unalign_writes, 1);
     }
+    if (part_of_batch && batch_coalesce_enabled()) {
+        return queue_batch_io(pdev, true /* is_write */, dev_offset, iov, iovcnt, size);
+    }
     return pdev->async_writev(iov, iovcnt, size, dev_offset, part_of_batch);
 }
 
@@ -560,6 +585,10 @@ folly::Future< std::error_code > VirtualDev::async_read(char* buf, uint64_t size
     if (sisl_unlikely(dev_offset == INVALID_DEV_OFFSET)) {
         return folly::makeFuture< std::error_code >(std::make_error_code(std::errc::resource_unavailable_try_again));
     }
+    if (part_of_batch && batch_coalesce_enabled()) {
+        iovec const iov{buf, size};
+        return queue_batch_io(pchunk->physical_dev_mutable(), false /* is_write */, dev_offset, &iov, 1, size);
+    }
     return pchunk->physical_dev_mutable()->async_read(buf, size, dev_offset, part_of_batch);
 }
 
@@ -572,6 +601,9 @@ folly::Future< std::error_code > VirtualDev::async_readv(iovec* iovs, int iovcnt
     if (sisl_unlikely(dev_offset == INVALID_DEV_OFFSET)) {
         return folly::makeFuture< std::error_code >(std::make_error_code(std::errc::resource_unavailable_try_again));
     }
+    if (part_of_batch && batch_coalesce_enabled()) {
+        return queue_batch_io(pchunk->physical_dev_mutable(), false /* is_write */, dev_offset, iovs, iovcnt, size);
+    }
     return pchunk->physical_dev_mutable()->async_readv(iovs, iovcnt, size, dev_offset, part_of_batch);
 }
 
@@ -654,11 +686,84 @@ folly::Future< std::error_code > VirtualDev::queue_fsync_pdevs() {
 }
 
 void VirtualDev::submit_batch() {
+    submit_queued_batch_ios();
+
     // It is enough to submit batch on first pdev, since all pdevs are expected to be under same drive interfaces
     auto* pdev = *(m_pdevs.begin());
     return pdev->submit_batch();
 }
 
+folly::Future< std::error_code > VirtualDev::queue_batch_io(PhysicalDev* pdev, bool is_write, uint64_t dev_offset,
+                                                            const iovec* iov, int iovcnt, uint64_t size) {
+    auto& io = s_batched_ios.emplace_back(BatchedIO{pdev, is_write, dev_offset, size, {}, {}});
+    io.iovs.assign(iov, iov + iovcnt);
+    return io.promise.getFuture();
+}
+
+void VirtualDev::submit_queued_batch_ios() {
+    if (s_batched_ios.empty()) { return; }
+
+    // Completions of the IOs can queue more IOs on this thread, so take the queue out before issuing them
+    auto ios = std::move(s_batched_ios);
+    s_batched_ios.clear();
+
+    std::stable_sort(ios.begin(), ios.end(), [](BatchedIO const& a, BatchedIO const& b) {
+        return std::tie(a.pdev, a.is_write, a.dev_offset) < std::tie(b.pdev, b.is_write, b.dev_offset);
+    });
+
+    uint64_t const max_size = uint64_cast(HS_DYNAMIC_CONFIG(device->batch_coalesce_max_size_kb)) * 1024;
+    size_t start{0};
+    while (start < ios.size()) {
+        // Extend the run with the IOs which continue exactly where the previous one ends on the same pdev
+        auto const& first = ios[start];
+        uint64_t run_size{first.size};
+        size_t run_iovcnt{first.iovs.size()};
+        size_t end{start + 1};
+        while (end < ios.size()) {
+            auto const& next = ios[end];
+            if ((next.pdev != first.pdev) || (next.is_write != first.is_write) ||
+                (next.dev_offset != first.dev_offset + run_size) || (run_size + next.size > max_size) ||
+                (run_iovcnt + next.iovs.size() > IOV_MAX)) {
+                break;
+            }
+            run_size += next.size;
+            run_iovcnt += next.iovs.size();
+            ++end;
+        }
+
+        // Vectored IO reads the iovs at submission, so they are kept alive till completion along with the promises
+        auto iovs = std::make_shared< std::vector< iovec > >();
+        iovs->reserve(run_iovcnt);
+        auto promises = std::make_shared< std::vector< folly::Promise< std::error_code > > >();
+        promises->reserve(end - start);
+        for (auto i = start; i < end; ++i) {
+            iovs->insert(iovs->end(), ios[i].iovs.begin(), ios[i].iovs.end());
+            promises->push_back(std::move(ios[i].promise));
+        }
+        if (end - start > 1) { COUNTER_INCREMENT(m_metrics, vdev_batch_coalesced_ios, end - start - 1); }
+
+#ifdef _PRERELEASE
+        if (iomgr_flip::instance()->test_flip("vdev_batch_io_error")) {
+            for (auto& p : *promises) {
+                p.setValue(std::make_error_code(std::errc::io_error));
+            }
+            start = end;
+            continue;
+        }
+#endif
+        auto const iovcnt = s_cast< int >(iovs->size());
+        auto fut = first.is_write
+            ? first.pdev->async_writev(iovs->data(), iovcnt, uint32_cast(run_size), first.dev_offset, true)
+            : first.pdev->async_readv(iovs->data(), iovcnt, uint32_cast(run_size), first.dev_offset, true);
+        std::move(fut).thenValue([iovs, promises](std::error_code ec) {
+            for (auto& p : *promises) {
+                p.setValue(ec);
+            }
+        });
+        start = end;
+    }
+}
+
 uint64_t VirtualDev::available_blks() const {
     uint64_t avl_blks{0};
     for (auto& [_, chunk] : m_all_chunks) {
@@ -741,11 +846,42 @@ void VirtualDev::cp_flush(VDevCPContext* v_cp_ctx) {
     CP* cp = v_cp_ctx->cp();
 
     // pass down cp so that underlying components can get their customized CP context if needed;
-    m_chunk_selector->foreach_chunks([this, cp](cshared< Chunk >& chunk) {
-        HS_LOG(TRACE, device, "Flushing chunk: {}, vdev: {}", chunk->chunk_id(), m_vdev_info.name);
-        chunk->blk_allocator_mutable()->cp_flush(cp);
+    m_chunk_selector->foreach_chunks([this, cp](cshared< Chunk >& chunk) { cp_flush_chunk(chunk, cp); });
+    cp_free_blks(v_cp_ctx);
+}
+
+folly::Future< bool > VirtualDev::async_cp_flush(VDevCPContext* v_cp_ctx, iomgr::io_fiber_t fiber) {
+    uint64_t nchunks{0};
+    m_chunk_selector->foreach_chunks([&nchunks](cshared< Chunk >&) { ++nchunks; });
+
+    if ((fiber == nullptr) || (nchunks == 0)) {
+        cp_flush(v_cp_ctx);
+        return folly::makeFuture< bool >(true);
+    }
+
+    m_cp_flush_total_chunks.store(nchunks);
+    m_cp_flush_done_chunks.store(0);
+    auto fut = v_cp_ctx->get_future();
+    iomanager.run_on_forget(fiber, [this, v_cp_ctx]() {
+        CP* cp = v_cp_ctx->cp();
+        m_chunk_selector->foreach_chunks([this, cp](cshared< Chunk >& chunk) {
+            cp_flush_chunk(chunk, cp);
+            m_cp_flush_done_chunks.fetch_add(1);
+        });
+
+        // All chunks are flushed, the blks freed in this cp can now be reused
+        cp_free_blks(v_cp_ctx);
+        v_cp_ctx->complete(true);
     });
+    return fut;
+}
+
+void VirtualDev::cp_flush_chunk(cshared< Chunk >& chunk, CP* cp) {
+    HS_LOG(TRACE, device, "Flushing chunk: {}, vdev: {}", chunk->chunk_id(), m_vdev_info.name);
+    chunk->blk_allocator_mutable()->cp_flush(cp);
+}
 
+void VirtualDev::cp_free_blks(VDevCPContext* v_cp_ctx) {
     // All of the blkids which were captured in the current vdev cp context will now be freed and hence available for
     // allocation on the new CP dirty collection session which is ongoing
     for (auto const& b : v_cp_ctx->m_free_blkid_list) {
@@ -757,8 +893,12 @@ void VirtualDev::cp_flush(VDevCPContext* v_cp_ctx) {
     }
 }
 
-// sync-ops during cp_flush, so return 100;
-int VirtualDev::cp_progress_percent() { return 100; }
+int VirtualDev::cp_progress_percent() {
+    // Blocking cp_flush and an idle vdev are always done
+    auto const total = m_cp_flush_total_chunks.load();
+    if (total == 0) { return 100; }
+    return static_cast< int >(std::min(m_cp_flush_done_chunks.load() * 100 / total, uint64_t{100}));
+}
 
 void VirtualDev::recovery_completed() {
     if (m_allocator_type != blk_allocator_type_t::append) {
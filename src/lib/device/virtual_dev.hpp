@@ -51,6 +51,7 @@ public:
         REGISTER_COUNTER(vdev_high_watermark_count, "vdev total high watermark cnt");
         REGISTER_COUNTER(vdev_num_alloc_failure, "vdev blk alloc failure cnt");
         REGISTER_COUNTER(unalign_writes, "unalign write cnt");
+        REGISTER_COUNTER(vdev_batch_coalesced_ios, "vdev batch ios merged into an adjacent io");
         REGISTER_COUNTER(default_chunk_allocation_cnt, "default chunk allocation count");
         REGISTER_COUNTER(random_chunk_allocation_cnt,
                          "random chunk allocation count"); // ideally it should be zero for hdd
@@ -103,6 +104,9 @@ protected:
     bool m_auto_recovery;
     bool m_use_slab_in_blk_allocator;
 
+    std::atomic< uint64_t > m_cp_flush_total_chunks{0}; // Chunks to flush in the ongoing async_cp_flush
+    std::atomic< uint64_t > m_cp_flush_done_chunks{0};  // Chunks already flushed in the ongoing async_cp_flush
+
 public:
     VirtualDev(DeviceManager& dmgr, const vdev_info& vinfo, vdev_event_cb_t event_cb, bool is_auto_recovery,
                shared< ChunkSelector > custom_chunk_selector = nullptr);
@@ -274,15 +278,26 @@ public:
     /// @return future< bool > Future result with bool to indicate when fsync is actually executed
     folly::Future< std::error_code > queue_fsync_pdevs();
 
-    /// @brief Submit the batch of IOs previously queued as part of async read/write APIs.
+    /// @brief Submit the batch of IOs previously queued as part of async read/write APIs. Queued IOs which are adjacent
+    /// on the same pdev are merged into a single vectored IO first, see queue_batch_io()
     void submit_batch();
 
     ////////////////////// Checkpointing related methods ///////////////////////////
-    /// @brief
+    /// @brief Flush the blk allocators of all the chunks and then free the blks which were freed in this CP. This is a
+    /// blocking io call.
     ///
     /// @param cp
     void cp_flush(VDevCPContext* v_cp_ctx);
 
+    /// @brief Same as cp_flush, but runs on the given fiber and reports the flushed chunks through
+    /// cp_progress_percent. The fiber needs to be the only one on its thread, since the blk allocators persist through
+    /// the meta service, which holds a thread level mutex across the sync io.
+    ///
+    /// @param v_cp_ctx
+    /// @param fiber Fiber to run the flush on, it falls back to a blocking cp_flush if null
+    /// @return Future which is completed once all the chunks are flushed and the freed blks are released
+    folly::Future< bool > async_cp_flush(VDevCPContext* v_cp_ctx, iomgr::io_fiber_t fiber);
+
     /// @brief : percentage CP has been progressed, this api is normally used for cp watchdog;
     int cp_progress_percent();
 
@@ -321,6 +336,11 @@ public:
 
 private:
     uint64_t to_dev_offset(BlkId const& b, Chunk** chunk) const;
+    folly::Future< std::error_code > queue_batch_io(PhysicalDev* pdev, bool is_write, uint64_t dev_offset,
+                                                    const iovec* iov, int iovcnt, uint64_t size);
+    void submit_queued_batch_ios();
+    void cp_flush_chunk(cshared< Chunk >& chunk, CP* cp);
+    void cp_free_blks(VDevCPContext* v_cp_ctx);
     bool is_chunk_available(cshared< Chunk >& chunk) const;
     BlkAllocStatus alloc_blks_from_chunk(blk_count_t nblks, blk_alloc_hints const& hints, MultiBlkId& out_blkid,
                                          Chunk* chunk);
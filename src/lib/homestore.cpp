@@ -37,6 +37,7 @@
 #include "common/homestore_config.hpp"
 #include "common/homestore_assert.hpp"
 #include "common/homestore_status_mgr.hpp"
+#include "common/s3fifo_evictor.hpp"
 #include "device/physical_dev.hpp"
 #include "device/device.h"
 #include "device/virtual_dev.hpp"
@@ -276,8 +277,16 @@ void HomeStore::format_and_start(std::map< uint32_t, hs_format_params >&& format
 void HomeStore::do_start() {
     const auto& inp_params = HomeStoreStaticConfig::instance().input;
 
+    // Data block cache has its own evictor, sized out of the same cache budget
     uint64_t cache_size = resource_mgr().get_cache_size();
-    m_evictor = std::make_shared< sisl::LRUEvictor >(cache_size, HS_DYNAMIC_CONFIG(generic.cache_evictor_npartitions));
+    if (has_data_service()) { cache_size -= resource_mgr().get_data_cache_size(); }
+    if (HS_DYNAMIC_CONFIG(generic.cache_evictor_policy) == 0) {
+        m_evictor =
+            std::make_shared< sisl::LRUEvictor >(cache_size, HS_DYNAMIC_CONFIG(generic.cache_evictor_npartitions));
+    } else {
+        m_evictor = std::make_shared< S3FifoEvictor >(cache_size, HS_DYNAMIC_CONFIG(generic.cache_evictor_npartitions),
+                                                      HS_DYNAMIC_CONFIG(generic.cache_evictor_small_queue_pct));
+    }
 
     if (m_before_services_starting_cb) { m_before_services_starting_cb(); }
 
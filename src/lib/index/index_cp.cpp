@@ -20,7 +20,7 @@ folly::Future< bool > IndexCPCallbacks::cp_flush(CP* cp) {
 
 void IndexCPCallbacks::cp_cleanup(CP* cp) {}
 
-int IndexCPCallbacks::cp_progress_percent() { return 100; }
+int IndexCPCallbacks::cp_progress_percent() { return m_wb_cache->cp_progress_percent(); }
 
 /////////////////////// IndexCPContext section ///////////////////////////
 IndexCPContext::IndexCPContext(CP* cp) : VDevCPContext(cp) {}
@@ -121,6 +121,44 @@ void IndexService::start() {
     // Force taking cp after recovery done. This makes sure that the index table is in consistent state and dirty
     // buffer after recovery can be added to dirty list for flushing in the new cp
     hs()->cp_mgr().trigger_cp_flush(true /* force */);
+    start_lazy_merge();
+}
+
+void IndexService::start_lazy_merge() {
+    auto const interval_ms = HS_DYNAMIC_CONFIG(generic.index_lazy_merge_interval_ms);
+    if (interval_ms == 0) { return; }
+
+    m_lazy_merge_timer_hdl = iomanager.schedule_global_timer(
+        uint64_cast(interval_ms) * 1000 * 1000, true /* recurring */, nullptr /* cookie */,
+        iomgr::reactor_regex::all_worker,
+        [this](void*) {
+            // Merges read and write nodes synchronously, so run them on a fiber which can do blocking io
+            bool expected{false};
+            if (!m_lazy_merge_running.compare_exchange_strong(expected, true)) { return; }
+            iomanager.run_on_forget(hs()->cp_mgr().pick_blocking_io_fiber(), [this]() {
+                lazy_merge();
+                m_lazy_merge_running.store(false);
+            });
+        },
+        true /* wait_to_schedule */);
+}
+
+void IndexService::lazy_merge() {
+    if (is_stopping()) { return; }
+    std::vector< std::shared_ptr< IndexTableBase > > tables;
+    {
+        std::unique_lock lg(m_index_map_mtx);
+        for (auto const& [_, tbl] : m_index_map) {
+            tables.push_back(tbl);
+        }
+    }
+
+    // Budget of the interval is shared by the tables in turn, a table with no underfull nodes leaves it to the rest
+    uint32_t budget = HS_DYNAMIC_CONFIG(generic.index_lazy_merge_max_nodes);
+    for (auto const& tbl : tables) {
+        if ((budget == 0) || is_stopping()) { break; }
+        budget -= std::min(budget, tbl->merge_underfull_nodes(budget));
+    }
 }
 
 void IndexService::write_sb(uint32_t ordinal) {
@@ -144,10 +182,18 @@ bool IndexService::sanity_check(const uint32_t index_ordinal, const IndexBufferP
 
 void IndexService::stop() {
     start_stopping();
+    if (m_lazy_merge_timer_hdl != iomgr::null_timer_handle) {
+        iomanager.cancel_timer(m_lazy_merge_timer_hdl);
+        m_lazy_merge_timer_hdl = iomgr::null_timer_handle;
+    }
+    while (m_lazy_merge_running.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
     while (true) {
         if (!get_pending_request_num()) break;
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     }
+    if (m_wb_cache) { m_wb_cache->stop(); }
     std::unique_lock lg(m_index_map_mtx);
     for (auto& [_, table] : m_index_map)
         table->stop();
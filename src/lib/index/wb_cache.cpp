@@ -13,7 +13,10 @@
  * specific language governing permissions and limitations under the License.
  *
  *********************************************************************************/
+#include <thread>
+
 #include <sisl/fds/thread_vector.hpp>
+#include <sisl/utility/thread_factory.hpp>
 #include <homestore/btree/detail/btree_node.hpp>
 #include <homestore/index_service.hpp>
 #include <homestore/homestore.hpp>
@@ -25,6 +28,7 @@
 #include "index_cp.hpp"
 #include "device/virtual_dev.hpp"
 #include "common/resource_mgr.hpp"
+#include "common/s3fifo_evictor.hpp"
 
 #ifdef _PRERELEASE
 #include "common/crash_simulator.hpp"
@@ -49,13 +53,27 @@ IndexWBCache::IndexWBCache(const std::shared_ptr< VirtualDev >& vdev, std::pair<
                 [](const BtreeNodePtr& node) -> BlkId {
                     return static_cast< IndexBtreeNode* >(node.get())->m_idx_buf->m_blkid;
                 },
-                [](const sisl::CacheRecord& rec) -> bool {
+                [this](const sisl::CacheRecord& rec) -> bool {
                     const auto& hnode = (sisl::SingleEntryHashNode< BtreeNodePtr >&)rec;
-                    return static_cast< IndexBtreeNode* >(hnode.m_value.get())->m_idx_buf->is_clean();
+                    if (!static_cast< IndexBtreeNode* >(hnode.m_value.get())->m_idx_buf->is_clean()) { return false; }
+                    record_cache_evict(hnode.m_value);
+                    return true;
                 }},
         m_node_size{node_size},
-        m_meta_blk{sb.first} {
+        m_meta_blk{sb.first},
+        m_flush_qd{HS_DYNAMIC_CONFIG(generic.cache_max_throttle_cnt)} {
+    COUNTER_INCREMENT(m_metrics, wbcache_flush_qd, m_flush_qd.load());
+
+    // Scan resistant evictor keeps the interior nodes resident for extra rounds, one per level above the leaves
+    if (auto s3_evictor = std::dynamic_pointer_cast< S3FifoEvictor >(evictor); s3_evictor) {
+        s3_evictor->set_priority_cb([](const sisl::CacheRecord& rec) -> uint8_t {
+            const auto& hnode = (sisl::SingleEntryHashNode< BtreeNodePtr >&)rec;
+            return static_cast< uint8_t >(
+                std::min(uint32_cast(hnode.m_value->level()), HS_DYNAMIC_CONFIG(generic.cache_interior_node_priority)));
+        });
+    }
     start_flush_threads();
+    start_trickle_flush();
 
     // We need to register the consumer first before recovery, so that recovery can use the cp_ctx created to add/track
     // recovered new nodes.
@@ -92,6 +110,123 @@ void IndexWBCache::start_flush_threads() {
     }
 }
 
+void IndexWBCache::start_trickle_flush() {
+    auto const interval_ms = HS_DYNAMIC_CONFIG(generic.index_trickle_flush_interval_ms);
+    if (interval_ms == 0) { return; }
+
+    LOGINFOMOD(wbcache, "Index trickle flush is enabled with interval={} ms and budget={} MBps", interval_ms,
+               HS_DYNAMIC_CONFIG(generic.index_trickle_flush_mbps));
+    m_trickle_enabled = true;
+    m_trickle_timer_hdl = iomanager.schedule_global_timer(
+        uint64_cast(interval_ms) * 1000 * 1000, true /* recurring */, nullptr /* cookie */,
+        iomgr::reactor_regex::all_worker,
+        [this](void*) {
+            // Writes are issued synchronously, so run the flush on a fiber which can do blocking io
+            bool expected{false};
+            if (!m_trickle_running.compare_exchange_strong(expected, true)) { return; }
+            iomanager.run_on_forget(cp_mgr().pick_blocking_io_fiber(), [this]() {
+                trickle_flush();
+                m_trickle_running.store(false);
+            });
+        },
+        true /* wait_to_schedule */);
+}
+
+void IndexWBCache::stop() {
+    while (m_prefetch_pending.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (m_trickle_timer_hdl == iomgr::null_timer_handle) { return; }
+    iomanager.cancel_timer(m_trickle_timer_hdl);
+    m_trickle_timer_hdl = iomgr::null_timer_handle;
+    while (m_trickle_running.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::lock_guard lg(m_trickle_mtx);
+    m_trickle_enabled = false;
+    m_trickle_candidates.clear();
+}
+
+/*
+ * Trickle flush writes the nodes created in the current CP ahead of its flush, so that the CP has less to write.
+ *
+ * Only new nodes are written early: nothing which is persisted points to them until their parent is flushed by the CP,
+ * so writing them early does not change what recovery sees. In-place updates of existing nodes continue to be written
+ * only by the CP, as recovery relies on the CP journal being persisted before any of them reach the disk.
+ *
+ * A node is picked only after it was not modified for a whole interval, to avoid writing hot nodes over and over. Its
+ * contents are copied under the node read lock along with the write generation of the buffer, and if the buffer is
+ * not written again before the CP flush, CP skips writing it. The CP guard held across each write makes sure the CP
+ * flush does not start while a trickle write of its buffer is in flight.
+ */
+void IndexWBCache::trickle_flush() {
+    if (m_in_recovery) { return; }
+
+    std::vector< TrickleCandidate > candidates;
+    {
+        std::lock_guard lg(m_trickle_mtx);
+        candidates.swap(m_trickle_candidates);
+    }
+    if (candidates.empty()) { return; }
+
+    uint64_t const budget = uint64_cast(HS_DYNAMIC_CONFIG(generic.index_trickle_flush_mbps)) * 1024 * 1024 *
+        HS_DYNAMIC_CONFIG(generic.index_trickle_flush_interval_ms) / 1000;
+    cp_id_t const cp_id = cp_mgr().cp_guard()->id();
+
+    sisl::io_blob_safe copy_buf{m_node_size, m_vdev->align_size()};
+    std::vector< TrickleCandidate > retained;
+    uint64_t written{0};
+    for (auto& c : candidates) {
+        if (written + m_node_size > budget) {
+            retained.push_back(std::move(c));
+            continue;
+        }
+
+        // Guard is taken per node, so that a CP which is waiting to flush is held up by only one write
+        auto cpg = cp_mgr().cp_guard();
+        if (cpg->id() != cp_id) { break; } // Rest of the candidates belong to the CP which is being flushed now
+
+        auto const node = c.node;
+        IndexBufferPtr buf;
+        uint64_t gen{0};
+        bool to_write{false};
+        node->lock(locktype_t::READ);
+        buf = static_cast< IndexBtreeNode* >(node.get())->m_idx_buf;
+        if ((buf->m_created_cp_id == cp_id) && (buf->m_dirtied_cp_id == cp_id) && !buf->m_node_freed) {
+            gen = buf->m_write_gen.load();
+            if ((buf->state() == index_buf_state_t::DIRTY) && (gen == c.seen_gen)) {
+                std::memcpy(copy_buf.bytes(), buf->raw_buffer(), m_node_size);
+                to_write = true;
+            } else {
+                // Either not written yet or still being modified, check again in next round
+                c.seen_gen = gen;
+                retained.push_back(std::move(c));
+            }
+        }
+        node->unlock(locktype_t::READ);
+        if (!to_write) { continue; } // Nodes of the older CPs and freed nodes are dropped here
+
+        auto const err = m_vdev->sync_write(r_cast< const char* >(copy_buf.cbytes()), m_node_size, buf->m_blkid);
+        if (err) {
+            LOGERRORMOD(wbcache, "Trickle flush of buf {} failed, err={}, leaving it for cp", buf->to_string(),
+                        err.message());
+            continue;
+        }
+        buf->m_trickled_gen.store(gen);
+        written += m_node_size;
+        COUNTER_INCREMENT(m_metrics, wbcache_trickle_write_cnt, 1);
+    }
+
+    if (!retained.empty()) {
+        std::lock_guard lg(m_trickle_mtx);
+        m_trickle_candidates.insert(m_trickle_candidates.end(), std::make_move_iterator(retained.begin()),
+                                    std::make_move_iterator(retained.end()));
+    }
+    LOGTRACEMOD(wbcache, "Trickle flushed {} bytes of cp={}, {} nodes are pending", written, cp_id, retained.size());
+}
+
 BtreeNodePtr IndexWBCache::alloc_buf(uint32_t ordinal, node_initializer_t&& node_initializer) {
     auto cpg = cp_mgr().cp_guard();
     auto cp_ctx = r_cast< IndexCPContext* >(cpg.context(cp_consumer_t::INDEX_SVC));
@@ -115,6 +250,12 @@ BtreeNodePtr IndexWBCache::alloc_buf(uint32_t ordinal, node_initializer_t&& node
         // Add the node to the cache. Skip if we are in recovery mode.
         bool done = m_cache.insert(node);
         HS_REL_ASSERT_EQ(done, true, "Unable to add alloc'd node to cache, low memory or duplicate inserts?");
+        cancel_prefetch(idx_buf->m_blkid);
+
+        if (m_trickle_enabled) {
+            std::lock_guard lg(m_trickle_mtx);
+            m_trickle_candidates.push_back(TrickleCandidate{node, 0});
+        }
     }
 
     // The entire index is updated in the commit path, so we alloc the blk and commit them right away
@@ -136,6 +277,7 @@ void IndexWBCache::write_buf(const BtreeNodePtr& node, const IndexBufferPtr& buf
         }
     } else {
         if (node != nullptr) { m_cache.upsert(node); }
+        cancel_prefetch(buf->m_blkid);
         LOGTRACEMOD(wbcache, "add to dirty list cp {} {}", cp_ctx->id(), buf->to_string());
         r_cast< IndexCPContext* >(cp_ctx)->add_to_dirty_list(buf);
         resource_mgr().inc_dirty_buf_size(m_node_size);
@@ -147,11 +289,15 @@ void IndexWBCache::read_buf(bnodeid_t id, BtreeNodePtr& node, node_initializer_t
 
 retry:
     // Check if the blkid is already in cache, if notL load and put it into the cache
-    if (!m_in_recovery && m_cache.get(blkid, node)) { return; }
+    if (!m_in_recovery && m_cache.get(blkid, node)) {
+        record_cache_access(node, true /* hit */);
+        return;
+    }
 
     // Read the buffer from virtual device
     auto idx_buf = std::make_shared< IndexBuffer >(blkid, m_node_size, m_vdev->align_size());
     m_vdev->sync_read(r_cast< char* >(idx_buf->raw_buffer()), m_node_size, blkid);
+    if (m_in_recovery) { record_recovery_reads(1); }
 
     // Create the btree node out of buffer
     node = node_initializer(idx_buf);
@@ -163,9 +309,113 @@ retry:
             // There is a race between 2 concurrent reads from vdev and other party won the race. Re-read from cache
             goto retry;
         }
+        cancel_prefetch(blkid);
+        record_cache_access(node, false /* hit */);
+    }
+}
+
+void IndexWBCache::record_cache_access(BtreeNodePtr const& node, bool hit) {
+    switch (node->level()) {
+    case 0:
+        if (hit) {
+            COUNTER_INCREMENT(m_metrics, wbcache_hit_l0, 1);
+        } else {
+            COUNTER_INCREMENT(m_metrics, wbcache_miss_l0, 1);
+        }
+        break;
+    case 1:
+        if (hit) {
+            COUNTER_INCREMENT(m_metrics, wbcache_hit_l1, 1);
+        } else {
+            COUNTER_INCREMENT(m_metrics, wbcache_miss_l1, 1);
+        }
+        break;
+    default:
+        if (hit) {
+            COUNTER_INCREMENT(m_metrics, wbcache_hit_upper, 1);
+        } else {
+            COUNTER_INCREMENT(m_metrics, wbcache_miss_upper, 1);
+        }
+        break;
+    }
+}
+
+void IndexWBCache::record_cache_evict(BtreeNodePtr const& node) {
+    switch (node->level()) {
+    case 0:
+        COUNTER_INCREMENT(m_metrics, wbcache_evict_l0, 1);
+        break;
+    case 1:
+        COUNTER_INCREMENT(m_metrics, wbcache_evict_l1, 1);
+        break;
+    default:
+        COUNTER_INCREMENT(m_metrics, wbcache_evict_upper, 1);
+        break;
+    }
+}
+
+bool IndexWBCache::get_cached_buf(bnodeid_t id, BtreeNodePtr& node) {
+    if (m_in_recovery || !m_cache.get(BlkId{id}, node)) { return false; }
+    record_cache_access(node, true /* hit */);
+    return true;
+}
+
+void IndexWBCache::prefetch_bufs(std::vector< bnodeid_t > const& ids, node_initializer_t&& node_initializer,
+                                 std::function< void() >&& on_done) {
+    if (m_in_recovery) {
+        if (on_done) { on_done(); }
+        return;
+    }
+
+    // Initializer is shared by all the reads and on_done is called when the last of them releases it
+    auto initializer = std::shared_ptr< node_initializer_t >(
+        new node_initializer_t(std::move(node_initializer)), [on_done = std::move(on_done)](node_initializer_t* p) {
+            delete p;
+            if (on_done) { on_done(); }
+        });
+    for (auto const id : ids) {
+        auto const blkid = BlkId{id};
+
+        // Registered before looking the node up in the cache, so that whoever caches it after the lookup cancels it
+        m_prefetch_pending.fetch_add(1);
+        bool registered;
+        {
+            std::lock_guard lg(m_prefetch_mtx);
+            registered = m_prefetching.insert(id).second;
+        }
+        BtreeNodePtr node;
+        if (!registered || m_cache.get(blkid, node)) {
+            // Already cached or being prefetched by someone else
+            if (registered) { cancel_prefetch(blkid); }
+            m_prefetch_pending.fetch_sub(1);
+            continue;
+        }
+
+        auto idx_buf = std::make_shared< IndexBuffer >(blkid, m_node_size, m_vdev->align_size());
+        m_vdev->async_read(r_cast< char* >(idx_buf->raw_buffer()), m_node_size, blkid)
+            .thenValue([this, idx_buf, initializer, id](auto&& err) mutable {
+                if (err) {
+                    LOGTRACEMOD(wbcache, "Prefetch of blkid={} failed, err={}", idx_buf->m_blkid.to_string(),
+                                err.message());
+                    cancel_prefetch(idx_buf->m_blkid);
+                } else {
+                    auto node = (*initializer)(idx_buf);
+                    std::lock_guard lg(m_prefetch_mtx);
+                    // Inserted only if no one else has cached, written or freed the node since the read was issued
+                    if (m_prefetching.erase(id) != 0) { m_cache.insert(node); }
+                }
+                initializer.reset();
+                m_prefetch_pending.fetch_sub(1);
+            });
     }
 }
 
+void IndexWBCache::cancel_prefetch(BlkId const& blkid) {
+    if (m_prefetch_pending.load() == 0) { return; }
+    std::lock_guard lg(m_prefetch_mtx);
+    m_prefetching.erase(blkid.to_integer());
+}
+
 bool IndexWBCache::get_writable_buf(const BtreeNodePtr& node, CPContext* context) {
     IndexCPContext* icp_ctx = r_cast< IndexCPContext* >(context);
     auto& idx_buf = static_cast< IndexBtreeNode* >(node.get())->m_idx_buf;
@@ -438,6 +688,7 @@ void IndexWBCache::free_buf(const IndexBufferPtr& buf, CPContext* cp_ctx) {
     if (!m_in_recovery) {
         bool done = m_cache.remove(buf->m_blkid, node);
         HS_REL_ASSERT_EQ(done, true, "Race on cache removal of btree blkid?");
+        cancel_prefetch(buf->m_blkid);
     }
     buf->m_node_freed = true;
     resource_mgr().inc_free_blk(m_node_size);
@@ -452,9 +703,39 @@ void IndexWBCache::load_buf(IndexBufferPtr const& buf) {
         buf->m_bytes = hs_utils::iobuf_alloc(m_node_size, sisl::buftag::btree_node, m_vdev->align_size());
         m_vdev->sync_read(r_cast< char* >(buf->m_bytes), m_node_size, buf->blkid());
         buf->m_dirtied_cp_id = BtreeNode::get_modified_cp_id(buf->m_bytes);
+        record_recovery_reads(1);
     }
 }
 
+void IndexWBCache::load_bufs(std::map< BlkId, IndexBufferPtr > const& bufs) {
+    // Read all the nodes referenced by the journal as one batch, instead of one synchronous read after the other
+    std::vector< folly::Future< std::error_code > > futs;
+    std::vector< IndexBufferPtr > loading_bufs;
+    for (auto const& [_, buf] : bufs) {
+        if (buf->m_bytes != nullptr) { continue; }
+        buf->m_bytes = hs_utils::iobuf_alloc(m_node_size, sisl::buftag::btree_node, m_vdev->align_size());
+        futs.emplace_back(
+            m_vdev->async_read(r_cast< char* >(buf->m_bytes), m_node_size, buf->blkid(), true /* part_of_batch */));
+        loading_bufs.push_back(buf);
+    }
+    if (futs.empty()) { return; }
+    m_vdev->submit_batch();
+
+    auto const results = folly::collectAllUnsafe(futs).get();
+    for (size_t i{0}; i < results.size(); ++i) {
+        auto const err = results[i].value();
+        HS_REL_ASSERT(!err, "IO error while reading index node {} during recovery, error={}",
+                      loading_bufs[i]->to_string(), err.message());
+        loading_bufs[i]->m_dirtied_cp_id = BtreeNode::get_modified_cp_id(loading_bufs[i]->m_bytes);
+    }
+    record_recovery_reads(loading_bufs.size());
+}
+
+void IndexWBCache::record_recovery_reads(uint64_t count) {
+    m_recovery_read_cnt.fetch_add(count);
+    COUNTER_INCREMENT(m_metrics, wbcache_recovery_read_cnt, count);
+}
+
 IndexWBCache::DagMap IndexWBCache::generate_dag_buffers(std::map< BlkId, IndexBufferPtr >& bufmap) {
     std::vector< IndexBufferPtr > bufs;
     std::ranges::transform(bufmap, std::back_inserter(bufs), [](const auto& pair) { return pair.second; });
@@ -548,6 +829,7 @@ void IndexWBCache::recover(sisl::byte_view sb) {
     }
 
     m_in_recovery = true; // For entirity of this call, we should mark it as being recovered.
+    auto const recovery_start_time = Clock::now();
 
     // Recover the CP Context with the buf_map of all the buffers that were dirtied in the last cp with its
     // relationship (up/down buf links) as it was by the cp that was flushing the buffers prior to unclean shutdown.
@@ -557,6 +839,8 @@ void IndexWBCache::recover(sisl::byte_view sb) {
 
     LOGINFOMOD(wbcache, "Detected unclean shutdown, prior cp={} had to flush {} nodes, recovering... ", icp_ctx->id(),
                bufs.size());
+    load_bufs(bufs);
+    auto const load_time_us = get_elapsed_time_us(recovery_start_time);
 
 #ifdef _PRERELEASE
     auto detailed_log = [this](std::map< BlkId, IndexBufferPtr > const& bufs,
@@ -675,46 +959,18 @@ void IndexWBCache::recover(sisl::byte_view sb) {
     LOGTRACEMOD(wbcache, "After recovery: {}", to_string_dag_bufs(modified_dags, icp_ctx->id()));
 
 #endif
-    uint32_t cnt = 0;
-    LOGTRACEMOD(wbcache, "Potential parent recovered bufs (#of bufs = {})", potential_parent_recovered_bufs.size());
+    // Rest of the repair is done per index table, and the tables are repaired in parallel
+    std::map< uint32_t, RecoveryRepairs > repairs;
     for (auto const& buf : potential_parent_recovered_bufs) {
-        LOGTRACEMOD(wbcache, " {} - check stale recovered buf {}", cnt++, buf->to_string());
-    }
-    // This step is needed since there is a case where all(or some) children of an interior node is freed (after moving
-    // to a previous sibling parent) and after crash, this node has stale links to its children
-    cnt = 0;
-    std::vector< IndexBufferPtr > buffers_to_repair;
-    for (auto const& buf : potential_parent_recovered_bufs) {
-        LOGTRACEMOD(wbcache, " {} - potential parent recovered buf {}", cnt, buf->to_string());
-        parent_recover(buf);
-        if (buf->m_bytes == nullptr || r_cast< persistent_hdr_t* >(buf->m_bytes)->node_deleted) {
-            // This buffer was marked as deleted during repair, so we also need to free it
-            deleted_bufs.push_back(buf);
-        } else {
-            // This buffer was not marked as deleted during repair, so we need to repair it
-            buffers_to_repair.push_back(buf);
-        }
+        repairs[buf->m_index_ordinal].potential_parent_bufs.push_back(buf);
     }
-    // let all unfreed buffers to be repaired first. This is important to let detect and remove all stale links first
-    // and then repair them before actual repair (due to dependency of finding true siblings)
-    for (auto const& buf : buffers_to_repair) {
-        LOGTRACEMOD(wbcache, "recover and repairing unfreed non-stale link interior node buf {}", buf->to_string());
-        index_service().repair_index_node(buf->m_index_ordinal, buf);
-    }
-    // actual recover is done here in recovery path
     for (auto const& buf : pending_bufs) {
-        LOGTRACEMOD(wbcache, "recover and repairing  up_buffer buf {}", buf->to_string());
-        recover_buf(buf);
+        repairs[buf->m_index_ordinal].pending_bufs.push_back(buf);
     }
-
-    // When we prune a buffer due to zero down dependency, there is a case where the key range of the parent needs to be
-    // adjusted. This can happen when a child is merged and its right sibling is flushed before the parent is flushed.
-    // And during recovery, we prune the node and keep the deleted child and keep the parent as is.
-    // We need to call repair_links directly on them as the recovery_buf() path will not trigger it.
     for (auto const& buf : pruned_bufs_to_repair) {
-        LOGTRACEMOD(wbcache, "pruned buf {} is repaired", buf->to_string());
-        index_service().repair_index_node(buf->m_index_ordinal, buf);
+        repairs[buf->m_index_ordinal].pruned_bufs.push_back(buf);
     }
+    repair_indexes(repairs, deleted_bufs);
 
     for (auto const& buf : deleted_bufs) {
         LOGTRACEMOD(wbcache, "freeing buf after repairing (last step) {}", buf->to_string());
@@ -750,6 +1006,90 @@ void IndexWBCache::recover(sisl::byte_view sb) {
     }
     m_in_recovery = false;
     m_vdev->recovery_completed();
+
+    auto const recovery_time_ms = get_elapsed_time_us(recovery_start_time) / 1000;
+    COUNTER_INCREMENT(m_metrics, wbcache_recovery_time_ms, recovery_time_ms);
+    LOGINFOMOD(wbcache,
+               "Index recovery of prior cp={} completed in {} ms, loaded {} journal nodes in {} us, repaired {} index "
+               "tables, total nodes read during recovery={}",
+               icp_ctx->id(), recovery_time_ms, bufs.size(), load_time_us, repairs.size(),
+               m_recovery_read_cnt.load());
+}
+
+void IndexWBCache::repair_indexes(std::map< uint32_t, RecoveryRepairs >& repairs,
+                                  std::vector< IndexBufferPtr >& deleted_bufs) {
+    auto const nthreads = std::min(uint32_cast(repairs.size()), HS_DYNAMIC_CONFIG(generic.index_recovery_threads));
+    if (nthreads <= 1) {
+        for (auto& [_, r] : repairs) {
+            repair_index(r, deleted_bufs);
+        }
+        return;
+    }
+
+    // Repairs do synchronous reads and writes of the nodes, so they are run on their own threads rather than on the
+    // reactors, which are not serving any io yet.
+    std::vector< RecoveryRepairs* > work;
+    std::ranges::transform(repairs, std::back_inserter(work), [](auto& pair) { return &pair.second; });
+
+    std::atomic< size_t > next_idx{0};
+    std::mutex deleted_mtx;
+    std::vector< std::thread > threads;
+    for (uint32_t t{0}; t < nthreads; ++t) {
+        threads.emplace_back(sisl::named_thread("index_recovery" + std::to_string(t), [&]() {
+            std::vector< IndexBufferPtr > my_deleted_bufs;
+            for (auto i = next_idx.fetch_add(1); i < work.size(); i = next_idx.fetch_add(1)) {
+                repair_index(*work[i], my_deleted_bufs);
+            }
+            std::lock_guard lg(deleted_mtx);
+            deleted_bufs.insert(deleted_bufs.end(), my_deleted_bufs.begin(), my_deleted_bufs.end());
+        }));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+void IndexWBCache::repair_index(RecoveryRepairs& repairs, std::vector< IndexBufferPtr >& deleted_bufs) {
+    uint32_t cnt = 0;
+    LOGTRACEMOD(wbcache, "Potential parent recovered bufs (#of bufs = {})", repairs.potential_parent_bufs.size());
+    for (auto const& buf : repairs.potential_parent_bufs) {
+        LOGTRACEMOD(wbcache, " {} - check stale recovered buf {}", cnt++, buf->to_string());
+    }
+    // This step is needed since there is a case where all(or some) children of an interior node is freed (after moving
+    // to a previous sibling parent) and after crash, this node has stale links to its children
+    cnt = 0;
+    std::vector< IndexBufferPtr > buffers_to_repair;
+    for (auto const& buf : repairs.potential_parent_bufs) {
+        LOGTRACEMOD(wbcache, " {} - potential parent recovered buf {}", cnt, buf->to_string());
+        parent_recover(buf);
+        if (buf->m_bytes == nullptr || r_cast< persistent_hdr_t* >(buf->m_bytes)->node_deleted) {
+            // This buffer was marked as deleted during repair, so we also need to free it
+            deleted_bufs.push_back(buf);
+        } else {
+            // This buffer was not marked as deleted during repair, so we need to repair it
+            buffers_to_repair.push_back(buf);
+        }
+    }
+    // let all unfreed buffers to be repaired first. This is important to let detect and remove all stale links first
+    // and then repair them before actual repair (due to dependency of finding true siblings)
+    for (auto const& buf : buffers_to_repair) {
+        LOGTRACEMOD(wbcache, "recover and repairing unfreed non-stale link interior node buf {}", buf->to_string());
+        index_service().repair_index_node(buf->m_index_ordinal, buf);
+    }
+    // actual recover is done here in recovery path
+    for (auto const& buf : repairs.pending_bufs) {
+        LOGTRACEMOD(wbcache, "recover and repairing  up_buffer buf {}", buf->to_string());
+        recover_buf(buf);
+    }
+
+    // When we prune a buffer due to zero down dependency, there is a case where the key range of the parent needs to be
+    // adjusted. This can happen when a child is merged and its right sibling is flushed before the parent is flushed.
+    // And during recovery, we prune the node and keep the deleted child and keep the parent as is.
+    // We need to call repair_links directly on them as the recovery_buf() path will not trigger it.
+    for (auto const& buf : repairs.pruned_bufs) {
+        LOGTRACEMOD(wbcache, "pruned buf {} is repaired", buf->to_string());
+        index_service().repair_index_node(buf->m_index_ordinal, buf);
+    }
 }
 
 void IndexWBCache::parent_recover(IndexBufferPtr const& buf) {
@@ -858,10 +1198,16 @@ folly::Future< bool > IndexWBCache::async_cp_flush(IndexCPContext* cp_ctx) {
 
     cp_ctx->prepare_flush_iteration();
     m_updated_ordinals.clear();
+    m_flush_total_bufs.store(cp_ctx->m_dirty_buf_count.get());
+    m_flush_done_bufs.store(0);
+
+    // Buffers which don't wait on any other buffer are spread across the flush fibers to start with. After that every
+    // write completion issues the up buffer it unblocked and tops up the writes in flight to the queue depth.
+    auto const per_fiber_qd = std::max(1u, flush_qd() / uint32_cast(m_cp_flush_fibers.size()));
     for (auto& fiber : m_cp_flush_fibers) {
-        iomanager.run_on_forget(fiber, [this, cp_ctx]() {
+        iomanager.run_on_forget(fiber, [this, cp_ctx, per_fiber_qd]() {
             IndexBufferPtrList buf_list;
-            get_next_bufs(cp_ctx, resource_mgr().get_dirty_buf_qd(), buf_list);
+            get_next_bufs(cp_ctx, per_fiber_qd, buf_list);
 
             for (auto& buf : buf_list) {
                 do_flush_one_buf(cp_ctx, buf, true);
@@ -909,15 +1255,29 @@ void IndexWBCache::do_flush_one_buf(IndexCPContext* cp_ctx, IndexBufferPtr const
         LOGTRACEMOD(wbcache, "cp {} Not flushing buf {} as it was freed, its here for merely dependency", cp_ctx->id(),
                     buf->to_string());
         process_write_completion(cp_ctx, buf);
+    } else if ((buf->m_trickled_gen.load() != 0) && (buf->m_trickled_gen.load() == buf->m_write_gen.load())) {
+        LOGTRACEMOD(wbcache, "cp {} Not flushing buf {} as it was already trickle flushed", cp_ctx->id(),
+                    buf->to_string());
+        COUNTER_INCREMENT(m_metrics, wbcache_trickle_skip_cnt, 1);
+        // Post the completion instead of processing it inline, so a long run of trickle flushed buffers picked one
+        // after the other in the completion path doesn't recurse
+        iomanager.run_on_forget(iomanager.iofiber_self(),
+                                [this, cp_ctx, buf]() { process_write_completion(cp_ctx, buf); });
     } else {
         if (buf->m_created_cp_id == cp_ctx->id()) {
             LOGTRACEMOD(wbcache, "Flushing cp {} new node buf {} blkid {}", cp_ctx->id(), buf->to_string(),
                         buf->blkid().to_string());
         }
+        m_flush_inflight.fetch_add(1);
+        COUNTER_INCREMENT(m_metrics, wbcache_flush_inflight, 1);
+        auto const start_time = Clock::now();
         m_vdev->async_write(r_cast< const char* >(buf->raw_buffer()), m_node_size, buf->m_blkid, part_of_batch)
-            .thenValue([buf, cp_ctx](auto) {
+            .thenValue([buf, cp_ctx, start_time](auto) {
                 try {
                     auto& pthis = s_cast< IndexWBCache& >(wb_cache());
+                    pthis.m_flush_inflight.fetch_sub(1);
+                    COUNTER_DECREMENT(pthis.m_metrics, wbcache_flush_inflight, 1);
+                    pthis.adjust_flush_qd(get_elapsed_time_us(start_time));
                     pthis.process_write_completion(cp_ctx, buf);
                 } catch (const std::runtime_error& e) {
                     std::call_once(flag,
@@ -941,11 +1301,16 @@ void IndexWBCache::process_write_completion(IndexCPContext* cp_ctx, IndexBufferP
     LOGTRACEMOD(wbcache, "cp {} completed flushed for buf {} blkid {}", cp_ctx->id(), buf->to_string(),
                 buf->blkid().to_string());
     resource_mgr().dec_dirty_buf_size(m_node_size);
-    m_updated_ordinals.insert(buf->m_index_ordinal);
-    auto [next_buf, has_more] = on_buf_flush_done(cp_ctx, buf);
-    if (next_buf) {
-        do_flush_one_buf(cp_ctx, next_buf, false);
+    m_flush_done_bufs.fetch_add(1);
+    IndexBufferPtrList next_bufs;
+    auto const has_more = on_buf_flush_done(cp_ctx, buf, next_bufs);
+    if (!next_bufs.empty()) {
+        for (auto const& next_buf : next_bufs) {
+            do_flush_one_buf(cp_ctx, next_buf, true /* part_of_batch */);
+        }
+        m_vdev->submit_batch();
     } else if (!has_more) {
+        m_flush_total_bufs.store(0);
         for (const auto& ordinal : m_updated_ordinals) {
             LOGTRACEMOD(wbcache, "Updating sb for ordinal {}", ordinal);
             index_service().write_sb(ordinal);
@@ -964,35 +1329,82 @@ void IndexWBCache::process_write_completion(IndexCPContext* cp_ctx, IndexBufferP
     }
 }
 
-std::pair< IndexBufferPtr, bool > IndexWBCache::on_buf_flush_done(IndexCPContext* cp_ctx, IndexBufferPtr const& buf) {
+bool IndexWBCache::on_buf_flush_done(IndexCPContext* cp_ctx, IndexBufferPtr const& buf,
+                                     IndexBufferPtrList& next_bufs) {
     if (m_cp_flush_fibers.size() > 1) {
         std::unique_lock lg(m_flush_mtx);
-        return on_buf_flush_done_internal(cp_ctx, buf);
+        return on_buf_flush_done_internal(cp_ctx, buf, next_bufs);
     } else {
-        return on_buf_flush_done_internal(cp_ctx, buf);
+        return on_buf_flush_done_internal(cp_ctx, buf, next_bufs);
     }
 }
 
-std::pair< IndexBufferPtr, bool > IndexWBCache::on_buf_flush_done_internal(IndexCPContext* cp_ctx,
-                                                                           IndexBufferPtr const& buf) {
-    IndexBufferPtrList buf_list;
+bool IndexWBCache::on_buf_flush_done_internal(IndexCPContext* cp_ctx, IndexBufferPtr const& buf,
+                                              IndexBufferPtrList& next_bufs) {
 #ifndef NDEBUG
     {
         std::lock_guard lg(buf->m_down_buffers_mtx);
         buf->m_down_buffers.clear();
     }
 #endif
+    m_updated_ordinals.insert(buf->m_index_ordinal);
 
     if (cp_ctx->m_dirty_buf_count.decrement_testz()) {
         buf->set_state(index_buf_state_t::CLEAN);
-        return std::make_pair(nullptr, false);
+        return false;
     } else {
-        get_next_bufs_internal(cp_ctx, 1u, buf, buf_list);
+        // Always pick at least one, so that the flush keeps moving even if the queue depth shrunk meanwhile
+        auto const qd = flush_qd();
+        auto const inflight = m_flush_inflight.load();
+        get_next_bufs_internal(cp_ctx, (inflight < qd) ? (qd - inflight) : 1u, buf, next_bufs);
         buf->set_state(index_buf_state_t::CLEAN);
-        return std::make_pair((buf_list.size() ? buf_list[0] : nullptr), true);
+        return true;
     }
 }
 
+uint32_t IndexWBCache::flush_qd() const {
+    // Resource manager raises its queue depth when dirty buffers go beyond the limit, honor it as well
+    return std::max(m_flush_qd.load(), resource_mgr().get_dirty_buf_qd());
+}
+
+void IndexWBCache::adjust_flush_qd(uint64_t write_latency_us) {
+    HISTOGRAM_OBSERVE(m_metrics, wbcache_flush_write_latency, write_latency_us);
+    auto const target_us = HS_DYNAMIC_CONFIG(generic.cache_flush_target_latency_us);
+    if (target_us == 0) { return; }
+
+    auto qd = m_flush_qd.load();
+    auto const lat_sum = m_flush_lat_sum_us.fetch_add(write_latency_us) + write_latency_us;
+    if (m_flush_lat_cnt.fetch_add(1) + 1 < qd) { return; }
+
+    // End of a window of qd writes: grow by a quarter while the device keeps up with the target latency and shrink
+    // by a quarter when it doesn't
+    m_flush_lat_sum_us.store(0);
+    m_flush_lat_cnt.store(0);
+    auto const avg_us = lat_sum / qd;
+    uint32_t new_qd{qd};
+    if (avg_us < target_us) {
+        new_qd = std::min(qd + qd / 4 + 1, HS_DYNAMIC_CONFIG(generic.cache_max_flush_qd));
+    } else if (avg_us > target_us) {
+        new_qd = std::max(qd - qd / 4, HS_DYNAMIC_CONFIG(generic.cache_min_throttle_cnt));
+    }
+
+    if ((new_qd != qd) && m_flush_qd.compare_exchange_strong(qd, new_qd)) {
+        if (new_qd > qd) {
+            COUNTER_INCREMENT(m_metrics, wbcache_flush_qd, new_qd - qd);
+        } else {
+            COUNTER_DECREMENT(m_metrics, wbcache_flush_qd, qd - new_qd);
+        }
+        HS_PERIODIC_LOG(DEBUG, wbcache, "Index cp flush qd changed from {} to {}, avg write latency={} us", qd, new_qd,
+                        avg_us);
+    }
+}
+
+int IndexWBCache::cp_progress_percent() const {
+    auto const total = m_flush_total_bufs.load();
+    if (total <= 0) { return 100; }
+    return static_cast< int >(std::min(m_flush_done_bufs.load() * 100 / total, int64_t{100}));
+}
+
 void IndexWBCache::get_next_bufs(IndexCPContext* cp_ctx, uint32_t max_count, IndexBufferPtrList& bufs) {
     if (m_cp_flush_fibers.size() > 1) {
         std::unique_lock lg(m_flush_mtx);
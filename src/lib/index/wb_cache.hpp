@@ -20,6 +20,7 @@
 #include <homestore/index/wb_cache_base.hpp>
 #include <homestore/index/index_internal.hpp>
 #include <sisl/cache/simple_cache.hpp>
+#include <sisl/metrics/metrics.hpp>
 #include "index/index_cp.hpp"
 
 namespace sisl {
@@ -32,17 +33,83 @@ class Evictor;
 namespace homestore {
 class VirtualDev;
 
+// Cache metrics are tracked separately for leaves, the level right above leaves and all the levels above it, since
+// they have very different access patterns.
+class IndexWBCacheMetrics : public sisl::MetricsGroup {
+public:
+    explicit IndexWBCacheMetrics() : sisl::MetricsGroup("IndexWBCache", "IndexWBCache") {
+        REGISTER_COUNTER(wbcache_hit_l0, "Index cache hits of leaf nodes", "wbcache_hit_cnt", {"level", "0"});
+        REGISTER_COUNTER(wbcache_hit_l1, "Index cache hits of level 1 nodes", "wbcache_hit_cnt", {"level", "1"});
+        REGISTER_COUNTER(wbcache_hit_upper, "Index cache hits of level 2+ nodes", "wbcache_hit_cnt", {"level", "2+"});
+        REGISTER_COUNTER(wbcache_miss_l0, "Index cache misses of leaf nodes", "wbcache_miss_cnt", {"level", "0"});
+        REGISTER_COUNTER(wbcache_miss_l1, "Index cache misses of level 1 nodes", "wbcache_miss_cnt", {"level", "1"});
+        REGISTER_COUNTER(wbcache_miss_upper, "Index cache misses of level 2+ nodes", "wbcache_miss_cnt",
+                         {"level", "2+"});
+        REGISTER_COUNTER(wbcache_evict_l0, "Index cache evictions of leaf nodes", "wbcache_evict_cnt", {"level", "0"});
+        REGISTER_COUNTER(wbcache_evict_l1, "Index cache evictions of level 1 nodes", "wbcache_evict_cnt",
+                         {"level", "1"});
+        REGISTER_COUNTER(wbcache_evict_upper, "Index cache evictions of level 2+ nodes", "wbcache_evict_cnt",
+                         {"level", "2+"});
+        REGISTER_COUNTER(wbcache_trickle_write_cnt, "Index nodes trickle flushed ahead of the CP");
+        REGISTER_COUNTER(wbcache_trickle_skip_cnt, "Index nodes CP skipped writing since they were trickle flushed");
+        REGISTER_COUNTER(wbcache_flush_qd, "Queue depth of the index cp flush", sisl::_publish_as::publish_as_gauge);
+        REGISTER_COUNTER(wbcache_flush_inflight, "Index buffer writes in flight", sisl::_publish_as::publish_as_gauge);
+        REGISTER_HISTOGRAM(wbcache_flush_write_latency, "Latency of index buffer writes of cp flush");
+        REGISTER_COUNTER(wbcache_recovery_read_cnt, "Index nodes read from the device during recovery");
+        REGISTER_COUNTER(wbcache_recovery_time_ms, "Time taken by the index recovery",
+                         sisl::_publish_as::publish_as_gauge);
+        register_me_to_farm();
+    }
+
+    IndexWBCacheMetrics(const IndexWBCacheMetrics&) = delete;
+    IndexWBCacheMetrics(IndexWBCacheMetrics&&) noexcept = delete;
+    IndexWBCacheMetrics& operator=(const IndexWBCacheMetrics&) = delete;
+    IndexWBCacheMetrics& operator=(IndexWBCacheMetrics&&) noexcept = delete;
+    ~IndexWBCacheMetrics() { deregister_me_from_farm(); }
+};
+
 class IndexWBCache : public IndexWBCacheBase {
 private:
     std::shared_ptr< VirtualDev > m_vdev;
+    IndexWBCacheMetrics m_metrics;
     sisl::SimpleCache< BlkId, BtreeNodePtr > m_cache;
     uint32_t m_node_size;
     std::vector< iomgr::io_fiber_t > m_cp_flush_fibers;
     std::mutex m_flush_mtx;
+
+    // Cp flush queue depth, adapted to the write latency observed over every window of qd writes
+    std::atomic< uint32_t > m_flush_qd{0};
+    std::atomic< uint32_t > m_flush_inflight{0};
+    std::atomic< uint64_t > m_flush_lat_sum_us{0};
+    std::atomic< uint32_t > m_flush_lat_cnt{0};
+
+    // Progress of the cp being flushed
+    std::atomic< int64_t > m_flush_total_bufs{0};
+    std::atomic< int64_t > m_flush_done_bufs{0};
+
+    // Nodes read from the device by the recovery, which can be concurrent across index tables
+    std::atomic< uint64_t > m_recovery_read_cnt{0};
     void* m_meta_blk;
     bool m_in_recovery{false};
     std::unordered_set< uint32_t > m_updated_ordinals;
 
+    // Nodes being prefetched. A node is dropped from here as soon as anyone else caches, writes or frees it, since the
+    // prefetched buffer could be stale by then, so the prefetch inserts it into the cache only if it is still here.
+    std::mutex m_prefetch_mtx;
+    std::unordered_set< bnodeid_t > m_prefetching;
+    std::atomic< uint64_t > m_prefetch_pending{0}; // Prefetch reads in flight, waited for by stop()
+
+    // New nodes of the current CP waiting to be trickle flushed, along with the write generation seen last time
+    struct TrickleCandidate {
+        BtreeNodePtr node;
+        uint64_t seen_gen{0};
+    };
+    std::atomic< bool > m_trickle_enabled{false};
+    std::mutex m_trickle_mtx;
+    std::vector< TrickleCandidate > m_trickle_candidates;
+    iomgr::timer_handle_t m_trickle_timer_hdl{iomgr::null_timer_handle};
+    std::atomic< bool > m_trickle_running{false};
+
 public:
     IndexWBCache(const std::shared_ptr< VirtualDev >& vdev, std::pair< meta_blk*, sisl::byte_view > sb,
                  const std::shared_ptr< sisl::Evictor >& evictor, uint32_t node_size);
@@ -50,6 +117,9 @@ public:
     BtreeNodePtr alloc_buf(uint32_t ordinal, node_initializer_t&& node_initializer) override;
     void write_buf(const BtreeNodePtr& node, const IndexBufferPtr& buf, CPContext* cp_ctx) override;
     void read_buf(bnodeid_t id, BtreeNodePtr& node, node_initializer_t&& node_initializer) override;
+    bool get_cached_buf(bnodeid_t id, BtreeNodePtr& node) override;
+    void prefetch_bufs(std::vector< bnodeid_t > const& ids, node_initializer_t&& node_initializer,
+                       std::function< void() >&& on_done) override;
 
     bool get_writable_buf(const BtreeNodePtr& node, CPContext* context) override;
     void transact_bufs(uint32_t index_ordinal, IndexBufferPtr const& parent_buf, IndexBufferPtr const& child_buf,
@@ -57,9 +127,11 @@ public:
                        CPContext* cp_ctx) override;
     void free_buf(const IndexBufferPtr& buf, CPContext* cp_ctx) override;
     bool refresh_meta_buf(shared< MetaIndexBuffer >& meta_buf, CPContext* cp_ctx) override;
+    void stop() override;
 
     //////////////////// CP Related API section /////////////////////////////////
     folly::Future< bool > async_cp_flush(IndexCPContext* context);
+    int cp_progress_percent() const;
     IndexBufferPtr copy_buffer(const IndexBufferPtr& cur_buf, const CPContext* cp_ctx) const;
     void recover(sisl::byte_view sb) override;
     struct DagNode {
@@ -70,15 +142,30 @@ public:
     using DagPtr = std::shared_ptr< DagNode >;
     using DagMap = std::map< IndexBufferPtr, DagPtr >;
 
+    // Buffers of one index table to be repaired during recovery, in the order of the repair passes. Buffers of
+    // different index tables never link to each other, so each table is repaired independent of the others.
+    struct RecoveryRepairs {
+        std::vector< IndexBufferPtr > potential_parent_bufs;
+        std::vector< IndexBufferPtr > pending_bufs;
+        std::vector< IndexBufferPtr > pruned_bufs;
+    };
+
 private:
     void start_flush_threads();
+    void start_trickle_flush();
+    void trickle_flush();
+    void record_cache_access(BtreeNodePtr const& node, bool hit);
+    void record_cache_evict(BtreeNodePtr const& node);
+    void cancel_prefetch(BlkId const& blkid);
     void recover_new_nodes(sisl::byte_view sb);
     void process_write_completion(IndexCPContext* cp_ctx, IndexBufferPtr const& pbuf);
     void do_flush_one_buf(IndexCPContext* cp_ctx, IndexBufferPtr const& buf, bool part_of_batch);
     void link_buf(IndexBufferPtr const& up, IndexBufferPtr const& down, bool is_sibling_link, CPContext* cp_ctx);
 
-    std::pair< IndexBufferPtr, bool > on_buf_flush_done(IndexCPContext* cp_ctx, IndexBufferPtr const& buf);
-    std::pair< IndexBufferPtr, bool > on_buf_flush_done_internal(IndexCPContext* cp_ctx, IndexBufferPtr const& buf);
+    bool on_buf_flush_done(IndexCPContext* cp_ctx, IndexBufferPtr const& buf, IndexBufferPtrList& next_bufs);
+    bool on_buf_flush_done_internal(IndexCPContext* cp_ctx, IndexBufferPtr const& buf, IndexBufferPtrList& next_bufs);
+    uint32_t flush_qd() const;
+    void adjust_flush_qd(uint64_t write_latency_us);
 
     void get_next_bufs(IndexCPContext* cp_ctx, uint32_t max_count, IndexBufferPtrList& bufs);
     void get_next_bufs_internal(IndexCPContext* cp_ctx, uint32_t max_count, IndexBufferPtr const& prev_flushed_buf,
@@ -90,6 +177,10 @@ private:
     DagMap generate_dag_buffers(std::map< BlkId, IndexBufferPtr >& bufmap);
     bool was_node_committed(IndexBufferPtr const& buf);
     void load_buf(IndexBufferPtr const& buf);
+    void load_bufs(std::map< BlkId, IndexBufferPtr > const& bufs);
+    void record_recovery_reads(uint64_t count);
+    void repair_index(RecoveryRepairs& repairs, std::vector< IndexBufferPtr >& deleted_bufs);
+    void repair_indexes(std::map< uint32_t, RecoveryRepairs >& repairs, std::vector< IndexBufferPtr >& deleted_bufs);
     void update_up_buffer_counters(IndexBufferPtr const& buf);
     void prune_up_buffers(IndexBufferPtr const& buf, std::vector< IndexBufferPtr >& bufs_to_repair);
 };
@@ -49,6 +49,69 @@ static uint64_t extract_term(const log_buffer& log_bytes) {
     return (*r_cast< uint64_t const* >(raw_ptr));
 }
 
+void RaftTermIndex::append(ulong lsn, ulong term) {
+    std::unique_lock lk(m_mutex);
+    if (!m_runs.empty()) {
+        if (lsn <= m_last_lsn) {
+            // Entries from lsn onwards are being overwritten
+            do_truncate_after(lsn - 1);
+        } else if (lsn != m_last_lsn + 1) {
+            // There is a hole, we don't know the terms in between, so restart the index from here
+            m_runs.clear();
+        }
+    }
+
+    if (m_runs.empty() || (m_runs.back().second != term)) { m_runs.emplace_back(lsn, term); }
+    m_last_lsn = lsn;
+}
+
+void RaftTermIndex::truncate_after(ulong lsn) {
+    std::unique_lock lk(m_mutex);
+    do_truncate_after(lsn);
+}
+
+void RaftTermIndex::do_truncate_after(ulong lsn) {
+    while (!m_runs.empty() && (m_runs.back().first > lsn)) {
+        m_runs.pop_back();
+    }
+    if (!m_runs.empty()) { m_last_lsn = std::min(m_last_lsn, lsn); }
+}
+
+void RaftTermIndex::compact_upto(ulong lsn) {
+    std::unique_lock lk(m_mutex);
+    if (m_runs.empty()) { return; }
+    if (lsn >= m_last_lsn) {
+        m_runs.clear();
+        return;
+    }
+
+    // Drop all the runs which are entirely compacted and trim the one which is partially compacted
+    while ((m_runs.size() > 1) && (m_runs[1].first <= lsn + 1)) {
+        m_runs.pop_front();
+    }
+    if (m_runs.front().first <= lsn) { m_runs.front().first = lsn + 1; }
+}
+
+std::optional< ulong > RaftTermIndex::term_at(ulong lsn) const {
+    std::shared_lock lk(m_mutex);
+    if (m_runs.empty() || (lsn < m_runs.front().first) || (lsn > m_last_lsn)) { return std::nullopt; }
+
+    auto it = std::upper_bound(m_runs.begin(), m_runs.end(), lsn,
+                               [](ulong l, auto const& run) { return l < run.first; });
+    return std::prev(it)->second;
+}
+
+std::optional< ulong > RaftTermIndex::last_lsn() const {
+    std::shared_lock lk(m_mutex);
+    if (m_runs.empty()) { return std::nullopt; }
+    return m_last_lsn;
+}
+
+void RaftTermIndex::reset() {
+    std::unique_lock lk(m_mutex);
+    m_runs.clear();
+}
+
 #if 0
 // Since truncate_lsn can not accross compact_lsn passed down by raft server
 // and compact will truncate logs upto compact_lsn, we don't need to re-truncate in this function now.
@@ -103,7 +166,13 @@ HomeRaftLogStore::HomeRaftLogStore(logdev_id_t logdev_id, logstore_id_t logstore
         LOGDEBUGMOD(replication, "Opening existing home log_dev={} log_store={}", m_logdev_id, logstore_id);
         logstore_service().open_logdev(m_logdev_id, flush_mode_t::EXPLICIT);
         m_log_store_future = logstore_service()
-                                 .open_log_store(m_logdev_id, logstore_id, true, log_found_cb, log_replay_done_cb)
+                                 .open_log_store(
+                                     m_logdev_id, logstore_id, true,
+                                     [this, log_found_cb](store_lsn_t lsn, log_buffer buf, void* ctx) {
+                                         on_log_replayed(lsn, buf);
+                                         if (log_found_cb) { log_found_cb(lsn, buf, ctx); }
+                                     },
+                                     log_replay_done_cb)
                                  .thenValue([this](auto log_store) {
                                      m_log_store = std::move(log_store);
                                      DEBUG_ASSERT_EQ(m_logstore_id, m_log_store->get_store_id(),
@@ -113,6 +182,25 @@ HomeRaftLogStore::HomeRaftLogStore(logdev_id_t logdev_id, logstore_id_t logstore
     }
 }
 
+void HomeRaftLogStore::on_log_replayed(store_lsn_t lsn, log_buffer const& buf) {
+    ulong const repl_lsn = to_repl_lsn(lsn);
+    auto const prev_last_lsn = m_term_index.last_lsn();
+    m_term_index.append(repl_lsn, extract_term(buf));
+
+    // Keep the latest replayed entries cached as well, so that last_entry() doesn't need a device read post recovery
+    auto position_in_cache = repl_lsn % m_log_entry_cache.size();
+    {
+        std::unique_lock lk(m_mutex);
+        if (prev_last_lsn && (*prev_last_lsn >= repl_lsn)) {
+            // replaying over rolled back entries, remove them from cache
+            for (size_t i{0}; i < m_log_entry_cache.size(); ++i) {
+                if (m_log_entry_cache[i].first > repl_lsn) { m_log_entry_cache[i] = std::make_pair(0, nullptr); }
+            }
+        }
+        m_log_entry_cache[position_in_cache] = std::make_pair(repl_lsn, to_nuraft_log_entry(buf));
+    }
+}
+
 void HomeRaftLogStore::remove_store() {
     REPL_STORE_LOG(DEBUG, "Logstore is being physically removed");
     logstore_service().remove_log_store(m_logdev_id, m_logstore_id);
@@ -169,6 +257,7 @@ ulong HomeRaftLogStore::append(nuraft::ptr< nuraft::log_entry >& entry) {
         m_log_store->append_async(sisl::io_blob{buf->data_begin(), uint32_cast(buf->size()), false /* is_aligned */},
                                   nullptr /* cookie */, [buf](int64_t, sisl::io_blob&, logdev_key, void*) {});
     ulong lsn = to_repl_lsn(next_seq);
+    m_term_index.append(lsn, entry->get_term());
 
     auto position_in_cache = lsn % m_log_entry_cache.size();
     {
@@ -189,6 +278,7 @@ void HomeRaftLogStore::write_at(ulong index, nuraft::ptr< nuraft::log_entry >& e
 
     m_log_store->append_async(sisl::io_blob{buf->data_begin(), uint32_cast(buf->size()), false /* is_aligned */},
                               nullptr /* cookie */, [buf](int64_t, sisl::io_blob&, logdev_key, void*) {});
+    m_term_index.append(index, entry->get_term());
 
     auto position_in_cache = index % m_log_entry_cache.size();
     {
@@ -271,6 +361,8 @@ nuraft::ptr< nuraft::log_entry > HomeRaftLogStore::entry_at(ulong index) {
 }
 
 ulong HomeRaftLogStore::term_at(ulong index) {
+    if (auto const term = m_term_index.term_at(index); term) { return *term; }
+
     auto positio_in_cache = index % m_log_entry_cache.size();
     {
         std::shared_lock lk(m_mutex);
@@ -331,6 +423,7 @@ void HomeRaftLogStore::apply_pack(ulong index, nuraft::buffer& pack) {
     if (index < slot) {
         // We are asked to apply/insert data behind next slot, so we must rollback before index and then append
         m_log_store->rollback(to_store_lsn(index) - 1);
+        m_term_index.truncate_after(index - 1);
     } else if (index > slot) {
         // We are asked to apply/insert data after next slot, so we need to fill in with dummy entries upto the slot
         // before append the entries
@@ -367,6 +460,7 @@ bool HomeRaftLogStore::compact(ulong compact_lsn) {
         REPL_STORE_LOG(DEBUG, "Compact with log holes from {} to={}", cur_max_lsn + 1, to_store_lsn(compact_lsn));
     }
     m_log_store->truncate(to_store_lsn(compact_lsn), false);
+    m_term_index.compact_upto(compact_lsn);
     return true;
 }
 
@@ -385,6 +479,7 @@ void HomeRaftLogStore::purge_all_logs() {
     REPL_STORE_LOG(INFO, "Store={} LogDev={}: Purging all logs in the log store, last_lsn={}", m_logstore_id,
                    m_logdev_id, last_lsn);
     m_log_store->truncate(last_lsn, false /* in_memory_truncate_only */);
+    m_term_index.reset();
 }
 
 void HomeRaftLogStore::wait_for_log_store_ready() { m_log_store_future.wait(); }
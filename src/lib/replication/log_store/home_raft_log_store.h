@@ -17,6 +17,10 @@
 #include <homestore/replication/repl_decls.h>
 #include <homestore/logstore_service.hpp>
 
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+
 #if defined __clang__ or defined __GNUC__
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -32,6 +36,39 @@ namespace homestore {
 using raft_buf_ptr_t = nuraft::ptr< nuraft::buffer >;
 using raft_cluster_config_ptr_t = nuraft::ptr< nuraft::cluster_config >;
 
+/**
+ * Compact in-memory index of the terms of the log entries in the log store. Consecutive entries with the same term are
+ * kept as a single run of (first lsn, term), so the index stays tiny irrespective of the number of entries and a term
+ * lookup is a binary search over the runs, without reading the entry from the device.
+ */
+class RaftTermIndex {
+public:
+    /// @brief Record the term of the entry at lsn. Any entries at or beyond lsn are overwritten. If lsn is not
+    /// contiguous to the last indexed entry, index is restarted from lsn.
+    void append(ulong lsn, ulong term);
+
+    /// @brief Forget all the entries beyond lsn (used on rollback)
+    void truncate_after(ulong lsn);
+
+    /// @brief Forget all the entries upto and including lsn (used on compaction)
+    void compact_upto(ulong lsn);
+
+    /// @brief Term of the entry at lsn, if the entry is indexed
+    std::optional< ulong > term_at(ulong lsn) const;
+
+    /// @brief Last indexed lsn, if anything is indexed
+    std::optional< ulong > last_lsn() const;
+
+    void reset();
+
+private:
+    void do_truncate_after(ulong lsn);
+
+    mutable std::shared_mutex m_mutex;
+    std::deque< std::pair< ulong /* first_lsn */, ulong /* term */ > > m_runs;
+    ulong m_last_lsn{0}; // Last indexed lsn, valid only if m_runs is not empty
+};
+
 class HomeRaftLogStore : public nuraft::log_store {
 public:
     HomeRaftLogStore(logdev_id_t logdev_id = UINT32_MAX, homestore::logstore_id_t logstore_id = UINT32_MAX,
@@ -225,6 +262,8 @@ public:
     void set_last_durable_lsn(repl_lsn_t lsn);
 
 private:
+    void on_log_replayed(store_lsn_t lsn, log_buffer const& buf);
+
     logstore_id_t m_logstore_id;
     logdev_id_t m_logdev_id;
     shared< HomeLogStore > m_log_store;
@@ -235,6 +274,9 @@ private:
     // raft log entry cache related members
     std::shared_mutex m_mutex;
     std::vector< std::pair< ulong, nuraft::ptr< nuraft::log_entry > > > m_log_entry_cache;
+
+    // terms of all the entries in the store, rebuilt on log replay
+    RaftTermIndex m_term_index;
 };
 
 // helper methods
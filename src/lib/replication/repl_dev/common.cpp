@@ -213,6 +213,28 @@ bool repl_req_ctx::save_fetched_data(sisl::GenericClientResponse const& fetched_
     return true;
 }
 
+bool repl_req_ctx::save_pushed_data(intrusive< sisl::GenericRpcData > const& pushed_data,
+                                    sisl::io_blob_safe&& decoded_data) {
+    if (!add_state_if_not_already(repl_req_state_t::DATA_RECEIVED)) { return false; }
+
+    m_buf_for_unaligned_data = std::move(decoded_data);
+    m_pushed_data = pushed_data;
+    m_data = m_buf_for_unaligned_data.cbytes();
+    m_data_received_promise.setValue();
+    return true;
+}
+
+bool repl_req_ctx::save_fetched_data(sisl::GenericClientResponse const& fetched_data,
+                                     sisl::io_blob_safe&& decoded_data) {
+    if (!add_state_if_not_already(repl_req_state_t::DATA_RECEIVED)) { return false; }
+
+    m_buf_for_unaligned_data = std::move(decoded_data);
+    m_fetched_data = fetched_data;
+    m_data = m_buf_for_unaligned_data.cbytes();
+    m_data_received_promise.setValue();
+    return true;
+}
+
 void repl_req_ctx::add_state(repl_req_state_t s) { m_state.fetch_or(uint32_cast(s)); }
 
 bool repl_req_ctx::add_state_if_not_already(repl_req_state_t s) {
@@ -29,6 +29,13 @@
 namespace homestore {
 std::atomic< uint64_t > RaftReplDev::s_next_group_ordinal{1};
 
+// FetchData response with compressed payloads, kept alive until the response is sent out
+struct compressed_fetch_response {
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector< std::unique_ptr< uint8_t[] > > bufs;
+    nuraft_mesg::io_blob_list_t pkts;
+};
+
 RaftReplDev::RaftReplDev(RaftReplService& svc, superblk< raft_repl_dev_superblk >&& rd_sb, bool load_existing) :
         m_repl_svc{svc},
         m_msg_mgr{svc.msg_manager()},
@@ -1080,13 +1087,23 @@ void RaftReplDev::async_alloc_write(sisl::blob const& header, sisl::blob const&
 void RaftReplDev::push_data_to_all_followers(repl_req_ptr_t rreq, sisl::sg_list const& data) {
     auto& builder = rreq->create_fb_builder();
 
+    // Compressed payload, if any, has to be kept alive until all the pushes are completed
+    auto const codec = data_channel_codec();
+    std::unique_ptr< uint8_t[] > compressed_buf;
+    auto const compressed_size = compress_data(codec, data, compressed_buf);
+
     // Prepare the rpc request packet with all repl_reqs details
     builder.FinishSizePrefixed(CreatePushDataRequest(
         builder, rreq->traceID(), server_id(), rreq->term(), rreq->dsn(),
         builder.CreateVector(rreq->header().cbytes(), rreq->header().size()),
-        builder.CreateVector(rreq->key().cbytes(), rreq->key().size()), data.size, get_time_since_epoch_ms()));
+        builder.CreateVector(rreq->key().cbytes(), rreq->key().size()), data.size, get_time_since_epoch_ms(),
+        compressed_size ? static_cast< uint8_t >(codec) : 0, compressed_size));
 
-    rreq->m_pkts = sisl::io_blob::sg_list_to_ioblob_list(data);
+    if (compressed_size) {
+        rreq->m_pkts = sisl::io_blob_list_t{sisl::io_blob{compressed_buf.get(), compressed_size, false}};
+    } else {
+        rreq->m_pkts = sisl::io_blob::sg_list_to_ioblob_list(data);
+    }
     rreq->m_pkts.insert(rreq->m_pkts.begin(), sisl::io_blob{builder.GetBufferPointer(), builder.GetSize(), false});
 
     /*RD_LOGI("Data Channel: Pushing data to all followers: rreq=[{}] data=[{}]", rreq->to_string(),
@@ -1101,7 +1118,7 @@ void RaftReplDev::push_data_to_all_followers(repl_req_ptr_t rreq, sisl::sg_list
                             ->data_service_request_unidirectional(peer, PUSH_DATA, rreq->m_pkts)
                             .via(&folly::InlineExecutor::instance()));
     }
-    folly::collectAllUnsafe(calls).thenValue([this, rreq](auto&& v_res) {
+    folly::collectAllUnsafe(calls).thenValue([this, rreq, compressed_buf = std::move(compressed_buf)](auto&& v_res) {
         for (auto const& res : v_res) {
             if (sisl_likely(res.value())) {
                 auto r = res.value();
@@ -1131,10 +1148,13 @@ void RaftReplDev::on_push_data_received(intrusive< sisl::GenericRpcData >& rpc_d
     auto const fb_size =
         flatbuffers::ReadScalar< flatbuffers::uoffset_t >(incoming_buf.cbytes()) + sizeof(flatbuffers::uoffset_t);
     auto push_req = GetSizePrefixedPushDataRequest(incoming_buf.cbytes());
-    if (fb_size + push_req->data_size() != incoming_buf.size()) {
+    auto const codec = hs_compressor::to_codec(push_req->compression());
+    auto const wire_size = (codec == compression_codec_t::NONE) ? push_req->data_size() : push_req->compressed_size();
+    if (fb_size + wire_size != incoming_buf.size()) {
         RD_LOGW(NO_TRACE_ID,
-                "Data Channel: PushData received with size mismatch, header size {}, data size {}, received size {}",
-                fb_size, push_req->data_size(), incoming_buf.size());
+                "Data Channel: PushData received with size mismatch, header size {}, data size {}, wire size {}, "
+                "received size {}",
+                fb_size, push_req->data_size(), wire_size, incoming_buf.size());
         rpc_data->send_response();
         return;
     }
@@ -1170,7 +1190,23 @@ void RaftReplDev::on_push_data_received(intrusive< sisl::GenericRpcData >& rpc_d
         return;
     }
 
-    if (!rreq->save_pushed_data(rpc_data, incoming_buf.cbytes() + fb_size, push_req->data_size())) {
+    bool saved{false};
+    if (codec != compression_codec_t::NONE) {
+        auto decoded = decompress_data(codec, incoming_buf.cbytes() + fb_size, wire_size, push_req->data_size());
+        if (decoded.size() == 0) {
+            RD_LOGE(rkey.traceID,
+                    "Data Channel: Unable to decompress pushed data, codec={}, will let raft channel trigger a fetch. "
+                    "rkey={}",
+                    enum_name(codec), rkey.to_string());
+            rpc_data->send_response();
+            return;
+        }
+        saved = rreq->save_pushed_data(rpc_data, std::move(decoded));
+    } else {
+        saved = rreq->save_pushed_data(rpc_data, incoming_buf.cbytes() + fb_size, push_req->data_size());
+    }
+
+    if (!saved) {
         RD_LOGT(rkey.traceID, "Data Channel: Data already received for rreq=[{}], ignoring this data",
                 rreq->to_string());
         rpc_data->send_response();
@@ -1443,7 +1479,9 @@ void RaftReplDev::fetch_data_from_remote(std::vector< repl_req_ptr_t > rreqs) {
     }
 
     builder->FinishSizePrefixed(
-        CreateFetchData(*builder, CreateFetchDataRequest(*builder, builder->CreateVector(entries))));
+        CreateFetchData(*builder,
+                        CreateFetchDataRequest(*builder, builder->CreateVector(entries),
+                                               hs_compressor::supported_codecs_mask() /* accept_compression */)));
 
     COUNTER_INCREMENT(m_metrics, fetch_rreq_cnt, 1);
     COUNTER_INCREMENT(m_metrics, fetch_total_entries_cnt, rreqs.size());
@@ -1543,7 +1581,7 @@ void RaftReplDev::on_fetch_data_received(intrusive< sisl::GenericRpcData >& rpc_
     }
 
     folly::collectAllUnsafe(futs).thenValue(
-        [this, rpc_data = std::move(rpc_data), sgs_vec = std::move(sgs_vec)](auto&& vf) {
+        [this, rpc_data = std::move(rpc_data), sgs_vec = std::move(sgs_vec), fetch_req](auto&& vf) {
             for (auto const& err_c : vf) {
                 const auto& err = err_c.value();
                 if (err) {
@@ -1565,14 +1603,22 @@ void RaftReplDev::on_fetch_data_received(intrusive< sisl::GenericRpcData >& rpc_
 
             RD_LOGT(NO_TRACE_ID, "Data Channel: FetchData data read completed for {} buffers", sgs_vec.size());
 
-            // now prepare the io_blob_list to response back to requester;
+            // now prepare the io_blob_list to response back to requester. If requester can decode it, compressed
+            // payloads are sent prefixed with a FetchDataResponse describing each of them.
             nuraft_mesg::io_blob_list_t pkts = sisl::io_blob_list_t{};
-            for (auto const& sgs : sgs_vec) {
-                auto const ret = sisl::io_blob::sg_list_to_ioblob_list(sgs);
-                pkts.insert(pkts.end(), ret.begin(), ret.end());
+            auto compressed_resp = std::make_shared< compressed_fetch_response >();
+            if (compress_fetch_response(fetch_req->request(), sgs_vec, *compressed_resp)) {
+                pkts = std::move(compressed_resp->pkts);
+            } else {
+                compressed_resp.reset();
+                for (auto const& sgs : sgs_vec) {
+                    auto const ret = sisl::io_blob::sg_list_to_ioblob_list(sgs);
+                    pkts.insert(pkts.end(), ret.begin(), ret.end());
+                }
             }
 
-            rpc_data->set_comp_cb([sgs_vec = std::move(sgs_vec)](boost::intrusive_ptr< sisl::GenericRpcData >&) {
+            rpc_data->set_comp_cb([sgs_vec = std::move(sgs_vec), compressed_resp = std::move(compressed_resp)](
+                                      boost::intrusive_ptr< sisl::GenericRpcData >&) {
                 for (auto const& sgs : sgs_vec) {
                     for (auto const& iov : sgs.iovs) {
                         iomanager.iobuf_free(reinterpret_cast< uint8_t* >(iov.iov_base));
@@ -1599,10 +1645,53 @@ void RaftReplDev::handle_fetch_data_response(sisl::GenericClientResponse respons
 
     RD_LOGD(NO_TRACE_ID, "Data Channel: FetchData completed for {} requests", rreqs.size());
 
+    uint64_t raw_size{0};
     for (auto const& rreq : rreqs) {
+        raw_size += rreq->remote_blkid().blkid.blk_count() * get_blk_size();
+    }
+
+    // Responder which compressed any of the payloads prefixes them with a FetchDataResponse flagged with
+    // compressed_payload, otherwise the response is just the raw data of all the requests back to back. Response is
+    // from a peer, so it is validated as a whole before any of it is consumed. Upon mismatch, the rreqs are left
+    // without data and fetched again upon the data receive timeout.
+    FetchDataResponse const* fetch_resp = parse_compressed_fetch_response(raw_data, total_size, rreqs);
+    if (fetch_resp) {
+        auto const fb_size =
+            flatbuffers::ReadScalar< flatbuffers::uoffset_t >(raw_data) + sizeof(flatbuffers::uoffset_t);
+        raw_data += fb_size;
+        total_size -= fb_size;
+    } else if (total_size != raw_size) {
+        RD_LOGE(NO_TRACE_ID, "Data Channel: FetchData response size={} doesn't match the requested size={}, ignoring it",
+                total_size, raw_size);
+        COUNTER_INCREMENT(m_metrics, fetch_err_cnt, 1);
+        return;
+    }
+
+    for (uint32_t i{0}; i < rreqs.size(); ++i) {
+        auto const& rreq = rreqs[i];
         auto const data_size = rreq->remote_blkid().blkid.blk_count() * get_blk_size();
+        auto wire_size = data_size;
+
+        bool saved{false};
+        auto const entry = fetch_resp ? fetch_resp->entries()->Get(i) : nullptr;
+        if (entry && (entry->compression() != static_cast< uint8_t >(compression_codec_t::NONE))) {
+            wire_size = entry->compressed_size();
+            auto decoded =
+                decompress_data(hs_compressor::to_codec(entry->compression()), raw_data, wire_size, data_size);
+            if (decoded.size() == 0) {
+                // Leave the rreq without data, it will be fetched again upon the data receive timeout
+                RD_LOGE(rreq->traceID(), "Data Channel: Unable to decompress fetched data for rreq=[{}]",
+                        rreq->to_compact_string());
+                raw_data += wire_size;
+                total_size -= wire_size;
+                continue;
+            }
+            saved = rreq->save_fetched_data(response, std::move(decoded));
+        } else {
+            saved = rreq->save_fetched_data(response, raw_data, data_size);
+        }
 
-        if (!rreq->save_fetched_data(response, raw_data, data_size)) {
+        if (!saved) {
             RD_DBG_ASSERT(rreq->local_blkid().is_valid(), "Invalid blkid for rreq={}", rreq->to_string());
             auto const local_size = rreq->local_blkid().blk_count() * get_blk_size();
             RD_DBG_ASSERT_EQ(data_size, local_size, "Data size mismatch for rreq={} remote size: {}, local size: {}",
@@ -1645,13 +1734,145 @@ void RaftReplDev::handle_fetch_data_response(sisl::GenericClientResponse respons
                     "Data Channel: Data fetched from remote: rreq=[{}], data_size: {}, total_size: {}, local_blkid: {}",
                     rreq->to_compact_string(), data_size, total_size, rreq->local_blkid().to_string());
         }
-        raw_data += data_size;
-        total_size -= data_size;
+        raw_data += wire_size;
+        total_size -= wire_size;
     }
 
     RD_DBG_ASSERT_EQ(total_size, 0, "Total size mismatch, some data is not consumed");
 }
 
+FetchDataResponse const* RaftReplDev::parse_compressed_fetch_response(uint8_t const* raw_data, uint64_t total_size,
+                                                                       std::vector< repl_req_ptr_t > const& rreqs) const {
+    if (total_size <= sizeof(flatbuffers::uoffset_t)) { return nullptr; }
+    auto const fb_size = uint64_t{flatbuffers::ReadScalar< flatbuffers::uoffset_t >(raw_data)} +
+        sizeof(flatbuffers::uoffset_t);
+    if (fb_size >= total_size) { return nullptr; }
+
+    flatbuffers::Verifier verifier(raw_data, fb_size);
+    if (!VerifySizePrefixedFetchDataBuffer(verifier)) { return nullptr; }
+    auto const fetch_resp = GetSizePrefixedFetchData(raw_data)->response();
+    if ((fetch_resp == nullptr) || !fetch_resp->compressed_payload()) { return nullptr; }
+
+    // Header is well formed and claims to describe the data, from here on any mismatch is a malformed response
+    if ((fetch_resp->entries() == nullptr) || (fetch_resp->entries()->size() != rreqs.size())) {
+        RD_LOGE(NO_TRACE_ID, "Data Channel: FetchData compressed response has {} entries, expected {}",
+                fetch_resp->entries() ? fetch_resp->entries()->size() : 0, rreqs.size());
+        return nullptr;
+    }
+    uint64_t wire_size{0};
+    for (uint32_t i{0}; i < rreqs.size(); ++i) {
+        auto const entry = fetch_resp->entries()->Get(i);
+        auto const data_size = rreqs[i]->remote_blkid().blkid.blk_count() * get_blk_size();
+        if (entry->data_size() != data_size) {
+            RD_LOGE(NO_TRACE_ID, "Data Channel: FetchData compressed response entry={} size={} expected={}", i,
+                    entry->data_size(), data_size);
+            return nullptr;
+        }
+        wire_size += (entry->compression() != static_cast< uint8_t >(compression_codec_t::NONE))
+            ? entry->compressed_size()
+            : data_size;
+    }
+    if (fb_size + wire_size != total_size) {
+        RD_LOGE(NO_TRACE_ID, "Data Channel: FetchData compressed response size={} doesn't match header={} + data={}",
+                total_size, fb_size, wire_size);
+        return nullptr;
+    }
+    return fetch_resp;
+}
+
+compression_codec_t RaftReplDev::data_channel_codec() const {
+    return hs_compressor::to_codec(HS_DYNAMIC_CONFIG(consensus.data_channel_compression));
+}
+
+uint32_t RaftReplDev::compress_data(compression_codec_t codec, sisl::sg_list const& data,
+                                    std::unique_ptr< uint8_t[] >& out) {
+    if ((codec == compression_codec_t::NONE) ||
+        (data.size < HS_DYNAMIC_CONFIG(consensus.data_channel_compress_min_size))) {
+        return 0;
+    }
+
+    // Sample the payload first, so that already compressed or encrypted data doesn't cost a full compression pass
+    if (!hs_compressor::is_compressible(data, HS_DYNAMIC_CONFIG(consensus.data_channel_compress_sample_size),
+                                        HS_DYNAMIC_CONFIG(consensus.data_channel_compress_min_saving_pct))) {
+        COUNTER_INCREMENT(m_metrics, data_compress_skip_cnt, 1);
+        return 0;
+    }
+
+    // Output is capped at the original size, there is no point in sending a compressed payload which is not smaller
+    auto const start_time = Clock::now();
+    out.reset(new uint8_t[data.size]);
+    auto const compressed_size = hs_compressor::compress(codec, data, out.get(), data.size,
+                                                         HS_DYNAMIC_CONFIG(consensus.data_channel_compression_level));
+    HISTOGRAM_OBSERVE(m_metrics, data_compress_latency_us, get_elapsed_time_us(start_time));
+    if ((compressed_size == 0) || (compressed_size >= data.size)) {
+        out.reset();
+        COUNTER_INCREMENT(m_metrics, data_compress_skip_cnt, 1);
+        return 0;
+    }
+
+    COUNTER_INCREMENT(m_metrics, data_compress_cnt, 1);
+    COUNTER_INCREMENT(m_metrics, data_compress_in_bytes, data.size);
+    COUNTER_INCREMENT(m_metrics, data_compress_out_bytes, compressed_size);
+    HISTOGRAM_OBSERVE(m_metrics, data_compress_ratio_pct, compressed_size * 100 / data.size);
+    return uint32_cast(compressed_size);
+}
+
+sisl::io_blob_safe RaftReplDev::decompress_data(compression_codec_t codec, uint8_t const* src, uint32_t src_size,
+                                                uint32_t data_size) {
+    // Decompress straight into an aligned buffer, which is what gets written to the data service
+    auto const start_time = Clock::now();
+    sisl::io_blob_safe decoded(data_size, data_service().get_align_size());
+    if ((codec == compression_codec_t::NONE) ||
+        !hs_compressor::decompress(codec, src, src_size, decoded.bytes(), data_size)) {
+        COUNTER_INCREMENT(m_metrics, data_decompress_err_cnt, 1);
+        return sisl::io_blob_safe{};
+    }
+    HISTOGRAM_OBSERVE(m_metrics, data_decompress_latency_us, get_elapsed_time_us(start_time));
+    return decoded;
+}
+
+bool RaftReplDev::compress_fetch_response(FetchDataRequest const* fetch_req,
+                                          std::vector< sisl::sg_list > const& sgs_vec,
+                                          compressed_fetch_response& resp) {
+    auto const codec = data_channel_codec();
+    if ((codec == compression_codec_t::NONE) ||
+        !(fetch_req->accept_compression() & (1u << static_cast< uint8_t >(codec)))) {
+        return false;
+    }
+
+    std::vector< ::flatbuffers::Offset< ResponseEntry > > entries;
+    nuraft_mesg::io_blob_list_t data_pkts;
+    entries.reserve(sgs_vec.size());
+
+    for (uint32_t i{0}; i < sgs_vec.size(); ++i) {
+        auto const& sgs = sgs_vec[i];
+        auto const req = fetch_req->entries()->Get(i);
+
+        std::unique_ptr< uint8_t[] > out;
+        auto const compressed_size = compress_data(codec, sgs, out);
+        if (compressed_size) {
+            data_pkts.emplace_back(out.get(), compressed_size, false);
+            resp.bufs.emplace_back(std::move(out));
+        } else {
+            auto const ret = sisl::io_blob::sg_list_to_ioblob_list(sgs);
+            data_pkts.insert(data_pkts.end(), ret.begin(), ret.end());
+        }
+        entries.push_back(CreateResponseEntry(resp.builder, req->lsn(), req->dsn(), req->raft_term(),
+                                              uint32_cast(sgs.size),
+                                              compressed_size ? static_cast< uint8_t >(codec) : 0, compressed_size));
+    }
+    if (resp.bufs.empty()) { return false; }
+
+    resp.builder.FinishSizePrefixed(
+        CreateFetchData(resp.builder, 0 /* request */,
+                        CreateFetchDataResponse(resp.builder, server_id(), resp.builder.CreateVector(entries),
+                                                true /* compressed_payload */)));
+
+    resp.pkts.emplace_back(resp.builder.GetBufferPointer(), resp.builder.GetSize(), false);
+    resp.pkts.insert(resp.pkts.end(), data_pkts.begin(), data_pkts.end());
+    return true;
+}
+
 void RaftReplDev::commit_blk(repl_req_ptr_t rreq) {
     if (rreq->local_blkid().is_valid()) {
         if (data_service().commit_blk(rreq->local_blkid()) != BlkAllocStatus::SUCCESS) {
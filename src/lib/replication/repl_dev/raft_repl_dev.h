@@ -13,6 +13,7 @@
 #include "replication/repl_dev/common.h"
 #include "replication/repl_dev/raft_state_machine.h"
 #include "replication/log_store/repl_log_store.h"
+#include "common/compression.hpp"
 
 namespace homestore {
 
@@ -77,6 +78,30 @@ public:
         REGISTER_COUNTER(fetch_total_entries_cnt, "total fetch total entries count", "fetch_total_entries_cnt",
                          {"op", "fetch"});
 
+        REGISTER_COUNTER(snp_read_ahead_hit_cnt, "snapshot objs served from read ahead", "snp_read_ahead_cnt",
+                         {"result", "hit"});
+        REGISTER_COUNTER(snp_read_ahead_miss_cnt, "snapshot objs read on demand", "snp_read_ahead_cnt",
+                         {"result", "miss"});
+
+        // Data channel compression metrics, ratio is the compressed size in percentage of the original size
+        REGISTER_COUNTER(data_compress_cnt, "data channel payloads sent compressed", "data_channel_compress_cnt",
+                         {"result", "compressed"});
+        REGISTER_COUNTER(data_compress_skip_cnt, "data channel payloads sent as is since they were incompressible",
+                         "data_channel_compress_cnt", {"result", "skipped"});
+        REGISTER_COUNTER(data_compress_in_bytes, "data channel bytes before compression", "data_channel_compress_bytes",
+                         {"op", "in"});
+        REGISTER_COUNTER(data_compress_out_bytes, "data channel bytes after compression", "data_channel_compress_bytes",
+                         {"op", "out"});
+        REGISTER_COUNTER(data_decompress_err_cnt, "data channel payloads failed to decompress");
+        REGISTER_HISTOGRAM(data_compress_ratio_pct, "data channel compressed size percentage of the original",
+                           HistogramBucketsType(PercentileBuckets));
+        REGISTER_HISTOGRAM(data_compress_latency_us, "data channel compression cpu time in us",
+                           "data_channel_compression_latency", {"op", "compress"},
+                           HistogramBucketsType(OpLatecyBuckets));
+        REGISTER_HISTOGRAM(data_decompress_latency_us, "data channel decompression cpu time in us",
+                           "data_channel_compression_latency", {"op", "decompress"},
+                           HistogramBucketsType(OpLatecyBuckets));
+
         // TODO: do we want to put this under _PRERELEASE only?
         REGISTER_COUNTER(total_read_cnt, "total write count", "total_write_cnt", {"op", "read"}); // placeholder
         REGISTER_COUNTER(total_write_cnt, "total read count", "total_read_cnt", {"op", "write"});
@@ -132,6 +157,9 @@ public:
 
 class RaftReplService;
 class CP;
+struct FetchDataRequest;
+struct FetchDataResponse;
+struct compressed_fetch_response;
 struct ReplDevCPContext {
     repl_lsn_t cp_lsn;
     repl_lsn_t compacted_to_lsn;
@@ -483,6 +511,14 @@ private:
     void on_fetch_data_received(intrusive< sisl::GenericRpcData >& rpc_data);
     void fetch_data_from_remote(std::vector< repl_req_ptr_t > rreqs);
     void handle_fetch_data_response(sisl::GenericClientResponse response, std::vector< repl_req_ptr_t > rreqs);
+    compression_codec_t data_channel_codec() const;
+    uint32_t compress_data(compression_codec_t codec, sisl::sg_list const& data, std::unique_ptr< uint8_t[] >& out);
+    sisl::io_blob_safe decompress_data(compression_codec_t codec, uint8_t const* src, uint32_t src_size,
+                                       uint32_t data_size);
+    bool compress_fetch_response(FetchDataRequest const* fetch_req, std::vector< sisl::sg_list > const& sgs_vec,
+                                 compressed_fetch_response& resp);
+    FetchDataResponse const* parse_compressed_fetch_response(uint8_t const* raw_data, uint64_t total_size,
+                                                             std::vector< repl_req_ptr_t > const& rreqs) const;
     bool is_resync_mode();
     repl_data_rpc_error_code nuraft_to_hs_error(nuraft::cmd_result_code const& nuraft_err);
     nuraft_mesg::destination_t hs_to_nuraft_dest(repl_dest_t dest);
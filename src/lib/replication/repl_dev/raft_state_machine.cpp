@@ -361,33 +361,163 @@ int RaftStateMachine::read_logical_snp_obj(nuraft::snapshot& s, void*& user_ctx,
     // For Nuraft baseline resync, we separate the process into two layers: HomeStore layer and Application layer.
     // We use the highest bit of the obj_id to indicate the message type: 0 is for HS, 1 is for Application.
     if (is_hs_snp_obj(obj_id)) {
-        // This is the preserved msg for homestore to resync data
+        // This is the preserved msg for homestore to resync data. It is the first message of every session, so any
+        // read ahead left over from an earlier session with the same user_ctx is no longer valid.
+        stop_snp_read_ahead(user_ctx);
         m_rd.create_snp_resync_data(data_out);
         is_last_obj = false;
         return 0;
     }
-    auto snp_ctx = std::make_shared< nuraft_snapshot_context >(s);
+
+    snp_read_result res;
+    if (HS_DYNAMIC_CONFIG(consensus.snapshot_io_max_inflight_objs) > 1) {
+        res = read_snp_obj_with_read_ahead(s, user_ctx, obj_id);
+    } else {
+        res = read_snp_obj(std::make_shared< nuraft_snapshot_context >(s), user_ctx, obj_id);
+    }
+    if (res.ret < 0) return res.ret;
+
+    is_last_obj = res.is_last_obj;
+
+    // We are doing a copy here.
+    data_out = nuraft::buffer::alloc(res.blob.size());
+    nuraft::buffer_serializer bs(data_out);
+    bs.put_raw(res.blob.cbytes(), res.blob.size());
+    return res.ret;
+}
+
+RaftStateMachine::snp_read_result RaftStateMachine::read_snp_obj(shared< snapshot_context > const& snp_ctx,
+                                                                 void*& user_ctx, uint64_t obj_id) {
     auto snp_data = std::make_shared< snapshot_obj >(user_ctx);
     snp_data->offset = obj_id;
-    snp_data->is_last_obj = is_last_obj;
 
     // Listener will read the snapshot data and modify user_ctx through the reference
-    int ret = m_rd.m_listener->read_snapshot_obj(snp_ctx, snp_data);
-    if (ret < 0) return ret;
+    snp_read_result res;
+    res.ret = m_rd.m_listener->read_snapshot_obj(snp_ctx, snp_data);
+    res.blob = std::move(snp_data->blob);
+    res.is_last_obj = snp_data->is_last_obj;
+    res.next_offset = snp_data->next_offset;
+    return res;
+}
 
-    is_last_obj = snp_data->is_last_obj;
+RaftStateMachine::snp_read_result RaftStateMachine::read_snp_obj_with_read_ahead(nuraft::snapshot& s,
+                                                                                 void*& user_ctx, uint64_t obj_id) {
+    auto ctx = get_snp_read_ahead_ctx(s, user_ctx);
 
-    // We are doing a copy here.
-    data_out = nuraft::buffer::alloc(snp_data->blob.size());
-    nuraft::buffer_serializer bs(data_out);
-    bs.put_raw(snp_data->blob.cbytes(), snp_data->blob.size());
-    return ret;
+    std::unique_lock lg(ctx->mtx);
+    if ((ctx->objs.count(obj_id) == 0) && (ctx->next_obj_id != obj_id)) {
+        // Follower is asking for an object other than what we are reading ahead, stop after the current read
+        ctx->next_obj_id = 0;
+    }
+    ctx->cv.wait(lg, [&ctx, obj_id]() { return (ctx->objs.count(obj_id) != 0) || !ctx->running; });
+
+    snp_read_result res;
+    if (auto it = ctx->objs.find(obj_id); it != ctx->objs.end()) {
+        res = std::move(it->second);
+        ctx->buffered_bytes -= res.blob.size();
+        ctx->objs.erase(it);
+        COUNTER_INCREMENT(m_rd.metrics(), snp_read_ahead_hit_cnt, 1);
+    } else {
+        // Read ahead is not running at this point, so it is safe to use user_ctx from this thread.
+        ctx->objs.clear();
+        ctx->buffered_bytes = 0;
+        lg.unlock();
+        res = read_snp_obj(ctx->snp_ctx, user_ctx, obj_id);
+        lg.lock();
+        ctx->next_obj_id = ((res.ret < 0) || res.is_last_obj) ? 0 : res.next_offset;
+        COUNTER_INCREMENT(m_rd.metrics(), snp_read_ahead_miss_cnt, 1);
+    }
+
+    if (!ctx->running && can_read_ahead(*ctx)) {
+        ctx->running = true;
+        lg.unlock();
+        schedule_snp_read_ahead(ctx);
+    }
+    return res;
+}
+
+shared< RaftStateMachine::snp_read_ahead_ctx > RaftStateMachine::get_snp_read_ahead_ctx(nuraft::snapshot& s,
+                                                                                      void*& user_ctx) {
+    std::unique_lock lg(m_snp_read_ahead_mtx);
+    auto& ctx = m_snp_read_aheads[&user_ctx];
+    if ((ctx == nullptr) || (ctx->snp_lsn != s.get_last_log_idx())) {
+        RD_DBG_ASSERT((ctx == nullptr) || !ctx->running, "Read ahead of older snapshot still running");
+        ctx = std::make_shared< snp_read_ahead_ctx >();
+        ctx->snp_ctx = std::make_shared< nuraft_snapshot_context >(s);
+        ctx->user_ctx = &user_ctx;
+        ctx->snp_lsn = s.get_last_log_idx();
+    }
+    return ctx;
+}
+
+void RaftStateMachine::stop_snp_read_ahead(void*& user_ctx) {
+    shared< snp_read_ahead_ctx > ctx;
+    {
+        std::unique_lock lg(m_snp_read_ahead_mtx);
+        auto it = m_snp_read_aheads.find(&user_ctx);
+        if (it == m_snp_read_aheads.end()) { return; }
+        ctx = std::move(it->second);
+        m_snp_read_aheads.erase(it);
+    }
+
+    // Wait for the outstanding read to complete, since it could be using user_ctx
+    std::unique_lock lg(ctx->mtx);
+    ctx->next_obj_id = 0;
+    ctx->cv.wait(lg, [&ctx]() { return !ctx->running; });
+    ctx->objs.clear();
+    ctx->buffered_bytes = 0;
+}
+
+bool RaftStateMachine::can_read_ahead(snp_read_ahead_ctx const& ctx) const {
+    return (ctx.next_obj_id != 0) && (ctx.objs.size() < HS_DYNAMIC_CONFIG(consensus.snapshot_io_max_inflight_objs)) &&
+        (ctx.buffered_bytes < HS_DYNAMIC_CONFIG(consensus.snapshot_io_mem_budget_mb) * 1024ul * 1024ul);
+}
+
+void RaftStateMachine::schedule_snp_read_ahead(shared< snp_read_ahead_ctx > const& ctx) {
+    m_rd.m_repl_svc.snapshot_io_executor()->add([this, ctx]() { do_snp_read_ahead(ctx); });
+}
+
+void RaftStateMachine::do_snp_read_ahead(shared< snp_read_ahead_ctx > ctx) {
+    // Objects of a session have to be read one after other, since each read can modify user_ctx which the next read
+    // depends on. The parallelism comes from the follower transferring and writing the earlier objects meanwhile.
+    std::unique_lock lg(ctx->mtx);
+    while (can_read_ahead(*ctx)) {
+        auto const obj_id = ctx->next_obj_id;
+        lg.unlock();
+        auto res = read_snp_obj(ctx->snp_ctx, *ctx->user_ctx, obj_id);
+        lg.lock();
+
+        RD_LOGT(NO_TRACE_ID, "Read ahead snapshot obj_id={} size={} ret={} is_last={} next_obj_id={}", obj_id,
+                res.blob.size(), res.ret, res.is_last_obj, res.next_offset);
+        // next_obj_id is reset to 0 in case follower asked for something else while we were reading
+        if (ctx->next_obj_id == obj_id) {
+            ctx->next_obj_id = ((res.ret < 0) || res.is_last_obj) ? 0 : res.next_offset;
+        }
+        ctx->buffered_bytes += res.blob.size();
+        ctx->objs.insert_or_assign(obj_id, std::move(res));
+        ctx->cv.notify_all();
+    }
+    ctx->running = false;
+    ctx->cv.notify_all();
+}
+
+void RaftStateMachine::wait_for_snp_writes(uint32_t max_pending_objs, uint64_t max_pending_bytes) {
+    std::unique_lock lg(m_snp_write_mtx);
+    while (!m_snp_pending_writes.empty() &&
+           ((m_snp_pending_writes.size() > max_pending_objs) || (m_snp_pending_write_bytes > max_pending_bytes))) {
+        auto [sz, fut] = std::move(m_snp_pending_writes.front());
+        m_snp_pending_writes.pop_front();
+        m_snp_pending_write_bytes -= sz;
+        std::move(fut).get();
+    }
 }
 
 void RaftStateMachine::save_logical_snp_obj(nuraft::snapshot& s, ulong& obj_id, nuraft::buffer& data, bool is_first_obj,
                                             bool is_last_obj) {
     if (is_hs_snp_obj(obj_id)) {
-        // Homestore preserved msg
+        // Homestore preserved msg, which starts a new session. Writes pending from an earlier session (if any) should
+        // land before we start over.
+        wait_for_snp_writes(0, 0);
         if (m_rd.save_snp_resync_data(data, s)) {
             obj_id = snp_obj_id_type_app;
             LOGDEBUG("save_snp_resync_data success, next obj_id={}", obj_id);
@@ -406,7 +536,23 @@ void RaftStateMachine::save_logical_snp_obj(nuraft::snapshot& s, ulong& obj_id,
     std::memcpy(blob.bytes(), data.data_begin(), data.size());
     snp_data->blob = std::move(blob);
 
-    m_rd.m_listener->write_snapshot_obj(snp_ctx, snp_data);
+    auto const max_inflight = HS_DYNAMIC_CONFIG(consensus.snapshot_io_max_inflight_objs);
+    if (max_inflight > 1) {
+        // Listener sets the next obj_id before returning, so we can move on to the next object while this write is
+        // in progress. Keep atmost max_inflight objects (bounded by memory budget) outstanding.
+        auto const obj_size = data.size();
+        auto fut = m_rd.m_listener->async_write_snapshot_obj(snp_ctx, snp_data);
+        {
+            std::unique_lock lg(m_snp_write_mtx);
+            m_snp_pending_writes.emplace_back(obj_size, std::move(fut));
+            m_snp_pending_write_bytes += obj_size;
+        }
+        wait_for_snp_writes(is_last_obj ? 0 : max_inflight - 1,
+                            is_last_obj ? 0 : HS_DYNAMIC_CONFIG(consensus.snapshot_io_mem_budget_mb) * 1024ul * 1024ul);
+    } else {
+        m_rd.m_listener->write_snapshot_obj(snp_ctx, snp_data);
+    }
+
     if (is_last_obj) {
         // Nuraft will compact and truncate all logs when processeing the last obj.
         // Update the truncation upper limit here to ensure all stale logs are truncated.
@@ -444,7 +590,10 @@ nuraft::ptr< nuraft::snapshot > RaftStateMachine::last_snapshot() {
     return s->nuraft_snapshot();
 }
 
-void RaftStateMachine::free_user_snp_ctx(void*& user_snp_ctx) { m_rd.m_listener->free_user_snp_ctx(user_snp_ctx); }
+void RaftStateMachine::free_user_snp_ctx(void*& user_snp_ctx) {
+    stop_snp_read_ahead(user_snp_ctx);
+    m_rd.m_listener->free_user_snp_ctx(user_snp_ctx);
+}
 
 std::string RaftStateMachine::identify_str() const { return m_rd.identify_str(); }
 
@@ -1,6 +1,11 @@
 #pragma once
 
 #include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
 #include <functional>
 #include <iomgr/iomgr.hpp>
 #include <folly/concurrency/ConcurrentHashMap.h>
@@ -89,6 +94,27 @@ using AsyncNotifier = folly::Promise< folly::Unit >;
 class RaftReplDev;
 class RaftStateMachine : public nuraft::state_machine {
 private:
+    struct snp_read_result {
+        int ret{0};
+        sisl::io_blob_safe blob;
+        bool is_last_obj{false};
+        uint64_t next_offset{0};
+    };
+
+    // Read ahead state of one baseline resync session on the leader. nuraft keeps a user_ctx per follower session and
+    // passes it by reference on every read, so its address identifies the session.
+    struct snp_read_ahead_ctx {
+        std::mutex mtx;
+        std::condition_variable cv;
+        shared< snapshot_context > snp_ctx;
+        void** user_ctx{nullptr};
+        uint64_t snp_lsn{0};
+        uint64_t next_obj_id{0}; // Object to read ahead next, 0 if follower's next ask is not known
+        bool running{false};     // Is read ahead running on the snapshot io executor
+        uint64_t buffered_bytes{0};
+        std::map< uint64_t, snp_read_result > objs; // Objects read ahead and not yet asked by follower
+    };
+
     folly::ConcurrentHashMap< int64_t /*lsn*/, repl_req_ptr_t > m_lsn_req_map;
     RaftReplDev& m_rd;
     nuraft::ptr< nuraft::buffer > m_success_ptr; // Preallocate the success return to raft
@@ -96,6 +122,13 @@ private:
     bool m_resync_mode{false};
     int64_t next_batch_size_hint{0};
 
+    std::mutex m_snp_read_ahead_mtx;
+    std::unordered_map< void**, shared< snp_read_ahead_ctx > > m_snp_read_aheads;
+
+    std::mutex m_snp_write_mtx;
+    std::deque< std::pair< uint64_t, folly::Future< folly::Unit > > > m_snp_pending_writes; // <obj size, write future>
+    uint64_t m_snp_pending_write_bytes{0};
+
 public:
     RaftStateMachine(RaftReplDev& rd);
     ~RaftStateMachine() override = default;
@@ -142,6 +175,15 @@ public:
 
 private:
     void after_precommit_in_leader(const nuraft::raft_server::req_ext_cb_params& params);
+
+    snp_read_result read_snp_obj(shared< snapshot_context > const& snp_ctx, void*& user_ctx, uint64_t obj_id);
+    snp_read_result read_snp_obj_with_read_ahead(nuraft::snapshot& s, void*& user_ctx, uint64_t obj_id);
+    shared< snp_read_ahead_ctx > get_snp_read_ahead_ctx(nuraft::snapshot& s, void*& user_ctx);
+    void stop_snp_read_ahead(void*& user_ctx);
+    void schedule_snp_read_ahead(shared< snp_read_ahead_ctx > const& ctx);
+    void do_snp_read_ahead(shared< snp_read_ahead_ctx > ctx);
+    bool can_read_ahead(snp_read_ahead_ctx const& ctx) const;
+    void wait_for_snp_writes(uint32_t max_pending_objs, uint64_t max_pending_bytes);
 };
 
 } // namespace homestore
@@ -50,6 +50,11 @@ void SoloReplDev::async_alloc_write(sisl::blob const& header, sisl::blob const&
     HS_REL_ASSERT_EQ(status, ReplServiceError::OK, "Error in allocating local blks");
     // If it is header only entry, directly write to the journal
     if (rreq->has_linked_data() && !rreq->has_state(repl_req_state_t::DATA_WRITTEN)) {
+        if (is_group_commit_enabled()) {
+            enqueue_data_write(std::move(rreq), value);
+            return;
+        }
+
         // Write the data
         data_service().async_write(value, rreq->local_blkids()).thenValue([this, rreq = std::move(rreq)](auto&& err) {
             HS_REL_ASSERT(!err, "Error in writing data"); // TODO: Find a way to return error to the Listener
@@ -74,6 +79,11 @@ void SoloReplDev::destroy() {
 }
 
 void SoloReplDev::write_journal(repl_req_ptr_t rreq) {
+    if (is_group_commit_enabled()) {
+        enqueue_journal_write(std::move(rreq));
+        return;
+    }
+
     rreq->create_journal_entry(false /* raft_buf */, 1);
 
     m_data_journal->append_async(
@@ -93,6 +103,136 @@ void SoloReplDev::write_journal(repl_req_ptr_t rreq) {
         });
 }
 
+bool SoloReplDev::is_group_commit_enabled() const {
+    return HS_DYNAMIC_CONFIG(generic.solo_repl_dev_max_batch_size) > 1;
+}
+
+void SoloReplDev::run_batch_later(std::function< void() > batch_fn) {
+    // Running it behind whatever is already queued on this reactor lets the requests issued or completed in the
+    // meantime join the batch.
+    if (iomanager.am_i_io_reactor()) {
+        iomanager.run_on_forget(iomanager.iofiber_self(), std::move(batch_fn));
+    } else {
+        iomanager.run_on_forget(iomgr::reactor_regex::random_worker, std::move(batch_fn));
+    }
+}
+
+void SoloReplDev::enqueue_data_write(repl_req_ptr_t rreq, sisl::sg_list const& value) {
+    bool flush_now{false};
+    bool schedule{false};
+    {
+        std::unique_lock lg(m_batch_mtx);
+        m_pending_data_writes.emplace_back(std::move(rreq), value);
+        if (m_pending_data_writes.size() >= HS_DYNAMIC_CONFIG(generic.solo_repl_dev_max_batch_size)) {
+            flush_now = true;
+        } else if (!m_data_batch_scheduled) {
+            m_data_batch_scheduled = schedule = true;
+        }
+    }
+
+    if (flush_now) {
+        flush_data_batch();
+    } else if (schedule) {
+        run_batch_later([this]() { flush_data_batch(); });
+    }
+}
+
+void SoloReplDev::flush_data_batch() {
+    std::vector< std::pair< repl_req_ptr_t, sisl::sg_list > > batch;
+    {
+        std::unique_lock lg(m_batch_mtx);
+        batch.swap(m_pending_data_writes);
+        m_data_batch_scheduled = false;
+    }
+    if (batch.empty()) { return; }
+
+    HS_LOG(DEBUG, solorepl, "dev={} submitting data write batch of {} reqs", boost::uuids::to_string(group_id()),
+           batch.size());
+    for (auto& [rreq, value] : batch) {
+        data_service()
+            .async_write(value, rreq->local_blkids(), true /* part_of_batch */)
+            .thenValue([this, rreq = std::move(rreq)](auto&& err) mutable {
+                HS_REL_ASSERT(!err, "Error in writing data"); // TODO: Find a way to return error to the Listener
+                enqueue_journal_write(std::move(rreq));
+            });
+    }
+    data_service().submit_io_batch();
+}
+
+void SoloReplDev::enqueue_journal_write(repl_req_ptr_t rreq) {
+    bool flush_now{false};
+    bool schedule{false};
+    {
+        std::unique_lock lg(m_batch_mtx);
+        m_pending_journal_writes.emplace_back(std::move(rreq));
+        if (m_pending_journal_writes.size() >= HS_DYNAMIC_CONFIG(generic.solo_repl_dev_max_batch_size)) {
+            flush_now = true;
+        } else if (!m_journal_batch_scheduled) {
+            m_journal_batch_scheduled = schedule = true;
+        }
+    }
+
+    if (flush_now) {
+        flush_journal_batch();
+    } else if (schedule) {
+        run_batch_later([this]() { flush_journal_batch(); });
+    }
+}
+
+void SoloReplDev::flush_journal_batch() {
+    struct journal_batch {
+        std::vector< repl_req_ptr_t > rreqs;
+        std::atomic< size_t > pending{0};
+    };
+
+    auto batch = std::make_shared< journal_batch >();
+    {
+        std::unique_lock lg(m_batch_mtx);
+        batch->rreqs.swap(m_pending_journal_writes);
+        m_journal_batch_scheduled = false;
+    }
+    if (batch->rreqs.empty()) { return; }
+
+    // Append all the records and flush them together, the batch is committed once the last of them is durable
+    batch->pending.store(batch->rreqs.size());
+    for (auto& rreq : batch->rreqs) {
+        rreq->create_journal_entry(false /* raft_buf */, 1);
+        m_data_journal->append_async(
+            sisl::io_blob{rreq->raw_journal_buf(), rreq->journal_entry_size(), false /* is_aligned */},
+            nullptr /* cookie */,
+            [this, batch, rreq = rreq.get()](int64_t lsn, sisl::io_blob&, homestore::logdev_key, void*) {
+                rreq->set_lsn(lsn);
+                if (batch->pending.fetch_sub(1) == 1) { commit_batch(batch->rreqs); }
+            });
+    }
+    m_data_journal->flush();
+}
+
+void SoloReplDev::commit_batch(std::vector< repl_req_ptr_t > const& rreqs) {
+    HS_LOG(DEBUG, solorepl, "dev={} committing journal batch of {} reqs lsn=[{}-{}]",
+           boost::uuids::to_string(group_id()), rreqs.size(), rreqs.front()->lsn(), rreqs.back()->lsn());
+
+    repl_lsn_t max_lsn{-1};
+    for (auto const& rreq : rreqs) {
+        m_listener->on_pre_commit(rreq->lsn(), rreq->header(), rreq->key(), rreq);
+        max_lsn = std::max(max_lsn, rreq->lsn());
+    }
+
+    auto cur_lsn = m_commit_upto.load();
+    while ((cur_lsn < max_lsn) && !m_commit_upto.compare_exchange_weak(cur_lsn, max_lsn)) {}
+
+    for (auto const& rreq : rreqs) {
+        for (const auto& blkid : rreq->local_blkids()) {
+            data_service().commit_blk(blkid);
+        }
+    }
+
+    for (auto const& rreq : rreqs) {
+        m_listener->on_commit(rreq->lsn(), rreq->header(), rreq->key(), rreq->local_blkids(), rreq);
+        decr_pending_request_num();
+    }
+}
+
 std::error_code SoloReplDev::alloc_blks(uint32_t data_size, const blk_alloc_hints& hints,
                                         std::vector< MultiBlkId >& out_blkids) {
     if (is_stopping()) { return std::make_error_code(std::errc::operation_canceled); }
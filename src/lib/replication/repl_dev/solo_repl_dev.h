@@ -14,6 +14,8 @@
  *********************************************************************************/
 #pragma once
 
+#include <functional>
+#include <mutex>
 #include <boost/smart_ptr/intrusive_ref_counter.hpp>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/uuid/nil_generator.hpp>
@@ -50,6 +52,14 @@ private:
     std::atomic< bool > m_is_recovered{false};
     std::atomic< bool > m_paused{false};
 
+    // Group commit: requests waiting for the next data write batch or the next journal batch. A batch is picked up
+    // later on the same reactor, so that all the requests issued or completed in the meantime are part of it.
+    std::mutex m_batch_mtx;
+    std::vector< std::pair< repl_req_ptr_t, sisl::sg_list > > m_pending_data_writes;
+    std::vector< repl_req_ptr_t > m_pending_journal_writes;
+    bool m_data_batch_scheduled{false};
+    bool m_journal_batch_scheduled{false};
+
 public:
     SoloReplDev(superblk< solo_repl_dev_superblk >&& rd_sb, bool load_existing);
     virtual ~SoloReplDev() = default;
@@ -144,6 +154,13 @@ public:
 
 private:
     void write_journal(repl_req_ptr_t rreq);
+    bool is_group_commit_enabled() const;
+    void run_batch_later(std::function< void() > batch_fn);
+    void enqueue_data_write(repl_req_ptr_t rreq, sisl::sg_list const& value);
+    void enqueue_journal_write(repl_req_ptr_t rreq);
+    void flush_data_batch();
+    void flush_journal_batch();
+    void commit_batch(std::vector< repl_req_ptr_t > const& rreqs);
     void on_log_found(logstore_seq_num_t lsn, log_buffer buf, void* ctx);
 };
 
@@ -17,6 +17,7 @@
 #include <chrono>
 
 #include <boost/uuid/string_generator.hpp>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <homestore/blkdata_service.hpp>
 #include <homestore/logstore_service.hpp>
 #include "common/homestore_config.hpp"
@@ -135,6 +136,11 @@ void RaftReplService::start() {
     r_params.return_method_ = nuraft::raft_params::async_handler;
     m_msg_mgr->register_mgr_type(params.default_group_type_, r_params);
 
+    // Threads on which the snapshot objects are read ahead on the leader during baseline resync
+    m_snp_io_executor = std::make_unique< folly::CPUThreadPoolExecutor >(
+        std::max(HS_DYNAMIC_CONFIG(consensus.snapshot_io_max_inflight_objs), 1u),
+        std::make_shared< folly::NamedThreadFactory >("raft_snp_io"));
+
     // Step 3: Load all the repl devs from the cached superblks. This step creates the ReplDev instances and adds to
     // list. It is still not joined the Raft group yet
     for (auto const& [buf, mblk] : m_sb_bufs) {
@@ -240,6 +246,7 @@ void RaftReplService::stop() {
     // 3 Cancel all scheduler tasks.
     // after m_msg_mgr is reset , no further data will hit data service and no futher log will hit log store.
     m_msg_mgr.reset();
+    if (m_snp_io_executor) { m_snp_io_executor->join(); }
 
     hs()->logstore_service().stop();
     hs()->data_service().stop();
@@ -25,6 +25,7 @@
 #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
 #include <folly/futures/Future.h>
 #pragma GCC diagnostic pop
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <nuraft_mesg/nuraft_mesg.hpp>
 #include <sisl/fds/buffer.hpp>
 #include <sisl/logging/logging.h>
@@ -60,6 +61,7 @@ private:
     iomgr::io_fiber_t m_reaper_fiber;
     std::atomic< int32_t > restart_counter{0};
     std::mutex raft_restart_mutex;
+    std::unique_ptr< folly::CPUThreadPoolExecutor > m_snp_io_executor; // Reads ahead snapshot objects in baseline resync
 
 public:
     RaftReplService(cshared< ReplApplication >& repl_app);
@@ -74,6 +76,7 @@ public:
                                                                     nuraft_mesg::group_id_t const& group_id) override;
     nuraft_mesg::Manager& msg_manager() { return *m_msg_mgr; }
     void add_to_fetch_queue(cshared< RaftReplDev >& rdev, std::vector< repl_req_ptr_t > rreqs);
+    folly::Executor* snapshot_io_executor() { return m_snp_io_executor.get(); }
 
 protected:
     ///////////////////// Overrides of GenericReplService ////////////////////
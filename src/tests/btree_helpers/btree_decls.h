@@ -50,6 +50,14 @@ struct VarObjSizeBtree {
     static constexpr btree_node_type interior_node_type = btree_node_type::VAR_OBJECT;
 };
 
+struct VarPrefixBtree {
+    using BtreeType = IndexTable< TestVarLenKey, TestVarLenValue >;
+    using KeyType = TestVarLenKey;
+    using ValueType = TestVarLenValue;
+    static constexpr btree_node_type leaf_node_type = btree_node_type::VAR_PREFIX;
+    static constexpr btree_node_type interior_node_type = btree_node_type::VAR_PREFIX;
+};
+
 struct PrefixIntervalBtree {
     using BtreeType = IndexTable< TestIntervalKey, TestIntervalValue >;
     using KeyType = TestIntervalKey;
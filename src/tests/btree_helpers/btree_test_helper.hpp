@@ -64,6 +64,7 @@ struct BtreeTestHelper {
         m_operations["range_put"] = std::bind(&BtreeTestHelper::range_put_random, this);
         m_operations["range_remove"] = std::bind(&BtreeTestHelper::range_remove_existing_random, this);
         m_operations["query"] = std::bind(&BtreeTestHelper::query_random, this);
+        m_operations["get"] = std::bind(&BtreeTestHelper::get_random, this);
     }
 
     void TearDown() {}
@@ -188,6 +189,39 @@ public:
         m_shadow_map.force_put(k, value);
     }
 
+    void multi_put(std::vector< uint64_t > const& ks, btree_put_type put_type) {
+        std::vector< K > keys;
+        std::vector< V > values;
+        keys.reserve(ks.size());
+        values.reserve(ks.size());
+        for (auto const k : ks) {
+            keys.emplace_back(k);
+            values.emplace_back(V::generate_rand());
+        }
+
+        std::vector< const K* > pkeys;
+        std::vector< const BtreeValue* > pvalues;
+        for (size_t i{0}; i < ks.size(); ++i) {
+            pkeys.push_back(&keys[i]);
+            pvalues.push_back(&values[i]);
+        }
+
+        auto mreq = BtreeMultiPutRequest< K >{std::move(pkeys), std::move(pvalues), put_type};
+        mreq.enable_route_tracing();
+        ASSERT_EQ(m_bt->put(mreq), btree_status_t::success) << "multi_put of " << ks.size() << " keys failed";
+        ASSERT_EQ(mreq.is_done(), true) << "multi_put returned with keys pending";
+
+        for (size_t i{0}; i < ks.size(); ++i) {
+            bool const done = (mreq.status(i) == btree_status_t::success);
+            if (put_type == btree_put_type::INSERT) {
+                ASSERT_EQ(done, !m_shadow_map.exists(keys[i])) << "multi_put status mismatch for key=" << ks[i];
+            } else if (put_type == btree_put_type::UPDATE) {
+                ASSERT_EQ(done, m_shadow_map.exists(keys[i])) << "multi_put status mismatch for key=" << ks[i];
+            }
+            if (done) { m_shadow_map.force_put(keys[i], values[i]); }
+        }
+    }
+
     void range_put(uint32_t start_k, uint32_t end_k, V const& value, bool update) {
         K start_key = K{start_k};
         K end_key = K{end_k};
@@ -248,6 +282,33 @@ public:
         remove_one(start_k);
     }
 
+    void multi_remove(std::vector< uint64_t > const& ks) {
+        std::vector< K > keys;
+        std::vector< V > out_values(ks.size());
+        keys.reserve(ks.size());
+        for (auto const k : ks) {
+            keys.emplace_back(k);
+        }
+
+        std::vector< const K* > pkeys;
+        std::vector< BtreeValue* > pout_values;
+        for (size_t i{0}; i < ks.size(); ++i) {
+            pkeys.push_back(&keys[i]);
+            pout_values.push_back(&out_values[i]);
+        }
+
+        auto mreq = BtreeMultiRemoveRequest< K >{std::move(pkeys), std::move(pout_values)};
+        mreq.enable_route_tracing();
+        ASSERT_EQ(m_bt->remove(mreq), btree_status_t::success) << "multi_remove of " << ks.size() << " keys failed";
+        ASSERT_EQ(mreq.is_done(), true) << "multi_remove returned with keys pending";
+
+        for (size_t i{0}; i < ks.size(); ++i) {
+            bool const removed = (mreq.status(i) == btree_status_t::success);
+            ASSERT_EQ(removed, m_shadow_map.exists(keys[i])) << "multi_remove status mismatch for key=" << ks[i];
+            if (removed) { m_shadow_map.remove_and_check(keys[i], out_values[i]); }
+        }
+    }
+
     void range_remove_existing(uint32_t start_k, uint32_t count) {
         auto [start_key, end_key] = m_shadow_map.pick_existing_range(K{start_k}, count);
         do_range_remove(start_k, end_key.key(), true /* removing_all_existing */);
@@ -379,6 +440,57 @@ public:
         }
     }
 
+    void do_cursor_scan(uint32_t start_k, uint32_t end_k) {
+        m_shadow_map.guard().lock();
+        std::vector< std::pair< K, V > > expected;
+        for (auto it = m_shadow_map.map_const().lower_bound(K{start_k});
+             (it != m_shadow_map.map_const().end()) && (it->first.compare(K{end_k}) <= 0); ++it) {
+            expected.emplace_back(*it);
+        }
+        m_shadow_map.guard().unlock();
+
+        {
+            auto cur = m_bt->cursor(BtreeKeyRange< K >{K{start_k}, true, K{end_k}, true});
+            size_t idx{0};
+            for (; cur.is_valid(); cur.next(), ++idx) {
+                ASSERT_LT(idx, expected.size()) << "Cursor returned more entries than expected";
+                ASSERT_EQ(cur.key().key(), expected[idx].first.key()) << "Cursor forward key mismatch idx=" << idx;
+                ASSERT_EQ(cur.value(), expected[idx].second) << "Cursor forward value mismatch idx=" << idx;
+            }
+            ASSERT_EQ(idx, expected.size()) << "Cursor forward scan missed entries";
+            ASSERT_EQ(cur.status(), btree_status_t::success);
+        }
+
+        {
+            BtreeCursor< K, V > cur{m_bt.get(), BtreeKeyRange< K >{K{start_k}, true, K{end_k}, true}};
+            size_t n{expected.size()};
+            for (cur.seek_to_last(); cur.is_valid(); cur.prev()) {
+                ASSERT_GT(n, 0u) << "Cursor returned more entries than expected in reverse";
+                --n;
+                ASSERT_EQ(cur.key().key(), expected[n].first.key()) << "Cursor reverse key mismatch idx=" << n;
+            }
+            ASSERT_EQ(n, 0u) << "Cursor reverse scan missed entries";
+        }
+
+        {
+            BtreeCursor< K, V > cur{m_bt.get(), BtreeKeyRange< K >{K{start_k}, true, K{end_k}, true}};
+            std::uniform_int_distribution< uint32_t > dist{start_k, end_k};
+            for (uint32_t i{0}; i < 10; ++i) {
+                auto const k = dist(m_re);
+                K const key{k};
+                auto const it = std::lower_bound(expected.begin(), expected.end(), key,
+                                                 [](auto const& e, K const& x) { return e.first.compare(x) < 0; });
+                ASSERT_EQ(cur.seek(key), (it != expected.end())) << "Cursor seek mismatch for key=" << k;
+                if (it != expected.end()) { ASSERT_EQ(cur.key().key(), it->first.key()); }
+
+                auto const pit = std::upper_bound(expected.begin(), expected.end(), key,
+                                                  [](K const& x, auto const& e) { return x.compare(e.first) < 0; });
+                ASSERT_EQ(cur.seek_for_prev(key), (pit != expected.begin())) << "Cursor seek_for_prev mismatch";
+                if (pit != expected.begin()) { ASSERT_EQ(cur.key().key(), std::prev(pit)->first.key()); }
+            }
+        }
+    }
+
     void query_random() {
         static thread_local std::uniform_int_distribution< uint32_t > s_rand_range_generator{1, 100};
 
@@ -415,6 +527,12 @@ public:
         }
     }
 
+    void get_random() {
+        auto const [start_k, end_k] = m_shadow_map.pick_random_non_working_keys(1);
+        get_specific(start_k);
+        m_shadow_map.remove_keys_from_working(start_k, end_k);
+    }
+
     void get_any(uint32_t start_k, uint32_t end_k) const {
         auto out_k = std::make_unique< K >();
         auto out_v = std::make_unique< V >();
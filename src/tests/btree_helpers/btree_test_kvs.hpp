@@ -79,6 +79,8 @@ private:
     uint64_t m_key{0};
 
 public:
+    using integral_key_t = uint64_t;
+
     TestFixedKey() = default;
     TestFixedKey(uint64_t k) : m_key{k} {}
     TestFixedKey(const TestFixedKey& other) : TestFixedKey(other.serialize(), true) {}
@@ -263,6 +265,74 @@ public:
     }
 };
 
+// Same keys as TestVarLenKey, but ordered by their serialized bytes and holding the bytes themselves, so that a
+// VAR_PREFIX btree can keep truncated separators for it. A truncated separator can be shorter than the preamble, in
+// which case its key() is meaningless, but such keys only ever live in the interior nodes.
+class TestBytewiseKey : public BtreeKey {
+private:
+    std::string m_data;
+
+public:
+    using bytewise_key_t = std::true_type;
+
+    TestBytewiseKey() = default;
+    TestBytewiseKey(uint64_t k) : TestBytewiseKey(TestVarLenKey{k}.serialize(), true) {}
+    TestBytewiseKey(const BtreeKey& other) : TestBytewiseKey(other.serialize(), true) {}
+    TestBytewiseKey(const TestBytewiseKey& other) = default;
+    TestBytewiseKey(TestBytewiseKey&& other) = default;
+    TestBytewiseKey& operator=(const TestBytewiseKey& other) = default;
+    TestBytewiseKey& operator=(TestBytewiseKey&& other) = default;
+
+    TestBytewiseKey(const sisl::blob& b, bool copy) : BtreeKey() { deserialize(b, copy); }
+    virtual ~TestBytewiseKey() = default;
+
+    sisl::blob serialize() const override {
+        return sisl::blob{r_cast< const uint8_t* >(m_data.data()), uint32_cast(m_data.size())};
+    }
+    uint32_t serialized_size() const override { return uint32_cast(m_data.size()); }
+    static bool is_fixed_size() { return false; }
+    static uint32_t get_fixed_size() {
+        assert(0);
+        return 0;
+    }
+
+    void deserialize(const sisl::blob& b, bool copy) override {
+        m_data.assign(r_cast< const char* >(b.cbytes()), b.size());
+    }
+
+    static uint32_t get_max_size() { return g_max_keysize + 8; }
+
+    int compare(const BtreeKey& o) const override {
+        auto const ret = m_data.compare(s_cast< const TestBytewiseKey& >(o).m_data);
+        return (ret < 0) ? -1 : ((ret > 0) ? 1 : 0);
+    }
+
+    std::string to_string() const { return fmt::format("{}-{}", key(), m_data.substr(0, 8)); }
+
+    friend std::ostream& operator<<(std::ostream& os, const TestBytewiseKey& k) {
+        os << k.to_string();
+        return os;
+    }
+
+    friend std::istream& operator>>(std::istream& is, TestBytewiseKey& k) {
+        uint64_t key;
+        is >> key;
+        k = TestBytewiseKey{key};
+        return is;
+    }
+
+    bool operator<(const TestBytewiseKey& o) const { return (compare(o) < 0); }
+    bool operator==(const TestBytewiseKey& other) const { return (compare(other) == 0); }
+
+    uint64_t key() const { return m_data.empty() ? 0 : std::stoull(m_data.substr(0, 8), nullptr, 16); }
+    uint64_t start_key(const BtreeKeyRange< TestBytewiseKey >& range) const {
+        return s_cast< const TestBytewiseKey& >(range.start_key()).key();
+    }
+    uint64_t end_key(const BtreeKeyRange< TestBytewiseKey >& range) const {
+        return s_cast< const TestBytewiseKey& >(range.end_key()).key();
+    }
+};
+
 class TestIntervalKey : public BtreeIntervalKey {
 private:
 #pragma pack(1)
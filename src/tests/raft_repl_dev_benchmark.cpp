@@ -0,0 +1,382 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+/*
+ * End to end benchmark of replicated writes through RaftReplDev. Replica 0 spawns the remaining replicas (same as
+ * test_raft_repl_dev), all of them talk over localhost and use file backed devices unless --replica_dev_list is given.
+ * Only the leader issues writes, the followers just follow along and wait for the commits.
+ *
+ * Example: raft_repl_dev_benchmark --replicas 5 --num_io 100000 --qdepth 64 --write_size_mix 4:70 64:25 1024:5
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <iomgr/io_environment.hpp>
+#include <sisl/logging/logging.h>
+#include <sisl/options/options.h>
+#include <homestore/homestore.hpp>
+#include <homestore/replication_service.hpp>
+#include <homestore/replication/repl_dev.h>
+#include "common/homestore_config.hpp"
+#include "test_common/hs_repl_test_common.hpp"
+
+using namespace homestore;
+
+SISL_LOGGING_INIT(HOMESTORE_LOG_MODS, nuraft_mesg, nuraft)
+SISL_OPTIONS_ENABLE(logging, raft_repl_dev_benchmark, iomgr, config, test_common_setup, test_repl_common_setup)
+
+SISL_OPTION_GROUP(raft_repl_dev_benchmark,
+                  (block_size, "", "block_size", "block size to io",
+                   ::cxxopts::value< uint32_t >()->default_value("4096"), "number"),
+                  (write_size_mix, "", "write_size_mix", "mix of write sizes, each entry is <size_kb>:<percent>",
+                   ::cxxopts::value< std::vector< std::string > >()->default_value({"4:60", "64:30", "512:10"}),
+                   "mix [...]"),
+                  (lag_sample_interval_ms, "", "lag_sample_interval_ms",
+                   "interval at which leader samples follower replication lag",
+                   ::cxxopts::value< uint32_t >()->default_value("100"), "number"));
+
+static std::unique_ptr< test_common::HSReplTestHelper > g_helper;
+
+class BenchReplicatedDB : public homestore::ReplDevListener {
+public:
+    struct bench_req : public repl_req_ctx {
+        struct journal_header {
+            uint64_t data_size;
+            uint64_t id;
+        };
+        journal_header jheader;
+        sisl::sg_list write_sgs;
+        Clock::time_point issue_time;
+
+        sisl::blob header_blob() { return sisl::blob(uintptr_cast(&jheader), sizeof(journal_header)); }
+        sisl::blob key_blob() { return sisl::blob{uintptr_cast(&jheader.id), sizeof(uint64_t)}; }
+
+        bench_req() { write_sgs.size = 0; }
+        ~bench_req() {
+            for (auto const& iov : write_sgs.iovs) {
+                iomanager.iobuf_free(uintptr_cast(iov.iov_base));
+            }
+        }
+    };
+
+    struct bench_result {
+        uint64_t num_writes{0};
+        uint64_t total_bytes{0};
+        uint64_t num_errors{0};
+        uint64_t num_fetches{0};
+        uint64_t p50_us{0};
+        uint64_t p99_us{0};
+        uint64_t p999_us{0};
+        uint64_t max_follower_lag{0};
+        double avg_follower_lag{0};
+        double elapsed_secs{0};
+    };
+
+    BenchReplicatedDB() {
+        auto const blk_size = SISL_OPTIONS["block_size"].as< uint32_t >();
+        for (auto const& m : SISL_OPTIONS["write_size_mix"].as< std::vector< std::string > >()) {
+            auto const pos = m.find(':');
+            RELEASE_ASSERT(pos != std::string::npos, "Invalid write_size_mix entry={}, expected <size_kb>:<percent>",
+                           m);
+            auto const size = sisl::round_up(std::stoull(m.substr(0, pos)) * 1024, blk_size);
+            m_cum_pct += std::stoul(m.substr(pos + 1));
+            m_size_mix.emplace_back(size, m_cum_pct);
+        }
+        RELEASE_ASSERT(m_cum_pct > 0, "write_size_mix should have atleast one non-zero percent entry");
+    }
+    virtual ~BenchReplicatedDB() = default;
+
+    void on_commit(int64_t lsn, sisl::blob const& header, sisl::blob const& key,
+                   std::vector< MultiBlkId > const& blkids, cintrusive< repl_req_ctx >& ctx) override {
+        m_commit_count.fetch_add(1, std::memory_order_relaxed);
+        if (ctx && ctx->is_proposer()) {
+            auto req = static_cast< bench_req const* >(ctx.get());
+            auto const lat_us = get_elapsed_time_us(req->issue_time);
+            {
+                std::unique_lock lg(m_lat_mtx);
+                m_latencies_us.push_back(lat_us);
+            }
+            m_bytes_written.fetch_add(req->jheader.data_size, std::memory_order_relaxed);
+            g_helper->runner().next_task();
+        }
+    }
+
+    bool on_pre_commit(int64_t lsn, const sisl::blob& header, const sisl::blob& key,
+                       cintrusive< repl_req_ctx >& ctx) override {
+        return true;
+    }
+
+    void on_rollback(int64_t lsn, const sisl::blob& header, const sisl::blob& key,
+                     cintrusive< repl_req_ctx >& ctx) override {}
+
+    void on_restart() override {}
+
+    void on_error(ReplServiceError error, const sisl::blob& header, const sisl::blob& key,
+                  cintrusive< repl_req_ctx >& ctx) override {
+        LOGWARN("[Replica={}] Received error={} on bench write", g_helper->replica_num(), enum_name(error));
+        m_error_count.fetch_add(1, std::memory_order_relaxed);
+        if (ctx && ctx->is_proposer()) { g_helper->runner().next_task(); }
+    }
+
+    void notify_committed_lsn(int64_t lsn) override {}
+    void on_config_rollback(int64_t lsn) override {}
+    void on_no_space_left(repl_lsn_t lsn, sisl::blob const& header) override {
+        LOGWARN("[Replica={}] Received no_space_left at lsn={}, increase dev_size_mb or reduce num_io",
+                g_helper->replica_num(), lsn);
+        repl_dev()->reset_latch_lsn();
+    }
+
+    // Fetch data requests are served by the leader, so counting them here gives the number of writes for which
+    // followers had to fall back to pulling the data instead of receiving it through push.
+    folly::Future< std::error_code > on_fetch_data(const int64_t lsn, const sisl::blob& header,
+                                                   const MultiBlkId& blkid, sisl::sg_list& sgs) override {
+        m_fetch_count.fetch_add(1, std::memory_order_relaxed);
+        return ReplDevListener::on_fetch_data(lsn, header, blkid, sgs);
+    }
+
+    AsyncReplResult<> create_snapshot(shared< snapshot_context > context) override {
+        std::lock_guard< std::mutex > lock(m_snapshot_lock);
+        m_last_snapshot = context;
+        return make_async_success<>();
+    }
+
+    // Benchmark does not maintain any state which needs to be resynced, so snapshot is always empty
+    int read_snapshot_obj(shared< snapshot_context > context, shared< snapshot_obj > snp_data) override {
+        snp_data->is_last_obj = true;
+        return 0;
+    }
+    void write_snapshot_obj(shared< snapshot_context > context, shared< snapshot_obj > snp_data) override {}
+
+    bool apply_snapshot(shared< snapshot_context > context) override {
+        std::lock_guard< std::mutex > lock(m_snapshot_lock);
+        m_last_snapshot = context;
+        return true;
+    }
+
+    shared< snapshot_context > last_snapshot() override {
+        std::lock_guard< std::mutex > lock(m_snapshot_lock);
+        return m_last_snapshot;
+    }
+
+    void free_user_snp_ctx(void*& user_snp_ctx) override {}
+
+    ReplResult< blk_alloc_hints > get_blk_alloc_hints(sisl::blob const& header, uint32_t data_size,
+                                                      cintrusive< homestore::repl_req_ctx >& hs_ctx) override {
+        return blk_alloc_hints{};
+    }
+
+    void on_start_replace_member(const std::string& task_id, const replica_member_info& member_out,
+                                 const replica_member_info& member_in, trace_id_t tid) override {}
+    void on_complete_replace_member(const std::string& task_id, const replica_member_info& member_out,
+                                    const replica_member_info& member_in, trace_id_t tid) override {}
+    void on_clean_replace_member_task(const std::string& task_id, const replica_member_info& member_out,
+                                      const replica_member_info& member_in, trace_id_t tid) override {}
+    void on_remove_member(const replica_id_t& member, trace_id_t tid) override {}
+    void on_destroy(const group_id_t& group_id) override { g_helper->unregister_listener(group_id); }
+
+    bool is_leader() {
+        while (repl_dev()->get_leader_id().is_nil()) {
+            LOGINFO("Waiting for leader to be elected");
+            std::this_thread::sleep_for(std::chrono::milliseconds{500});
+        }
+        return (repl_dev()->get_leader_id() == g_helper->my_replica_id());
+    }
+
+    void run_iteration(uint64_t num_writes) {
+        g_helper->sync_for_test_start();
+        m_expected_commits += num_writes;
+
+        if (is_leader()) {
+            while (!repl_dev()->is_ready_for_traffic()) {
+                LOGINFO("Leader is not yet ready for traffic, waiting");
+                std::this_thread::sleep_for(std::chrono::milliseconds{500});
+            }
+
+            std::atomic< bool > writes_done{false};
+            std::thread lag_sampler([this, &writes_done]() {
+                auto const interval = SISL_OPTIONS["lag_sample_interval_ms"].as< uint32_t >();
+                while (!writes_done.load()) {
+                    sample_follower_lag();
+                    std::this_thread::sleep_for(std::chrono::milliseconds{interval});
+                }
+            });
+
+            auto const start_time = Clock::now();
+            g_helper->runner().set_num_tasks(num_writes);
+            g_helper->runner().set_task([this]() { issue_write(); });
+            g_helper->runner().execute().get();
+            m_elapsed_us += get_elapsed_time_us(start_time);
+
+            writes_done.store(true);
+            lag_sampler.join();
+        }
+
+        // Wait for every replica (including leader) to see all the commits before moving on to next iteration
+        while (m_commit_count.load() < m_expected_commits) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        g_helper->sync_for_verify_start();
+    }
+
+    bench_result result() {
+        bench_result res;
+        {
+            std::unique_lock lg(m_lat_mtx);
+            std::sort(m_latencies_us.begin(), m_latencies_us.end());
+            res.num_writes = m_latencies_us.size();
+            res.p50_us = percentile(0.50);
+            res.p99_us = percentile(0.99);
+            res.p999_us = percentile(0.999);
+            res.max_follower_lag = m_max_lag;
+            res.avg_follower_lag = m_lag_samples ? (double)m_total_lag / m_lag_samples : 0.0;
+        }
+        res.total_bytes = m_bytes_written.load();
+        res.num_errors = m_error_count.load();
+        res.num_fetches = m_fetch_count.load();
+        res.elapsed_secs = m_elapsed_us / 1000000.0;
+        return res;
+    }
+
+private:
+    void issue_write() {
+        static thread_local std::default_random_engine s_re{std::random_device{}()};
+        std::uniform_int_distribution< uint32_t > pct_gen{0, m_cum_pct - 1};
+        auto const pct = pct_gen(s_re);
+        auto it = std::find_if(m_size_mix.begin(), m_size_mix.end(), [pct](auto const& e) { return pct < e.second; });
+
+        auto req = intrusive< bench_req >(new bench_req());
+        req->jheader.data_size = it->first;
+        req->jheader.id = m_next_id.fetch_add(1, std::memory_order_relaxed);
+        req->write_sgs = test_common::HSTestHelper::create_sgs(req->jheader.data_size,
+                                                               SISL_OPTIONS["block_size"].as< uint32_t >(),
+                                                               req->jheader.id);
+        req->issue_time = Clock::now();
+        repl_dev()->async_alloc_write(req->header_blob(), req->key_blob(), req->write_sgs, req);
+    }
+
+    void sample_follower_lag() {
+        auto const last_lsn = repl_dev()->get_last_append_lsn();
+        auto const peers = repl_dev()->get_replication_status();
+
+        std::unique_lock lg(m_lat_mtx);
+        for (auto const& p : peers) {
+            if (p.id_ == g_helper->my_replica_id()) { continue; }
+            auto const lag = (last_lsn > int64_cast(p.replication_idx_)) ? (last_lsn - p.replication_idx_) : 0;
+            m_max_lag = std::max(m_max_lag, uint64_cast(lag));
+            m_total_lag += lag;
+            ++m_lag_samples;
+        }
+    }
+
+    uint64_t percentile(double p) const {
+        if (m_latencies_us.empty()) { return 0; }
+        auto const idx = std::min(m_latencies_us.size() - 1, size_t(p * m_latencies_us.size()));
+        return m_latencies_us[idx];
+    }
+
+private:
+    std::vector< std::pair< uint64_t, uint32_t > > m_size_mix; // <size in bytes, cumulative percent>
+    uint32_t m_cum_pct{0};
+    std::atomic< uint64_t > m_next_id{1};
+
+    std::atomic< uint64_t > m_commit_count{0};
+    uint64_t m_expected_commits{0};
+    std::atomic< uint64_t > m_bytes_written{0};
+    std::atomic< uint64_t > m_error_count{0};
+    std::atomic< uint64_t > m_fetch_count{0};
+    uint64_t m_elapsed_us{0};
+
+    std::mutex m_lat_mtx;
+    std::vector< uint64_t > m_latencies_us;
+    uint64_t m_max_lag{0};
+    uint64_t m_total_lag{0};
+    uint64_t m_lag_samples{0};
+
+    std::shared_ptr< snapshot_context > m_last_snapshot{nullptr};
+    std::mutex m_snapshot_lock;
+};
+
+static std::shared_ptr< BenchReplicatedDB > g_db;
+
+static void replicated_write(benchmark::State& state) {
+    for (auto _ : state) {
+        g_db->run_iteration(SISL_OPTIONS["num_io"].as< uint64_t >());
+    }
+
+    auto const res = g_db->result();
+    state.counters["replicas"] = SISL_OPTIONS["replicas"].as< uint32_t >();
+    state.counters["qdepth"] = SISL_OPTIONS["qdepth"].as< uint32_t >();
+    state.counters["writes"] = res.num_writes;
+    state.counters["errors"] = res.num_errors;
+    state.counters["p50_us"] = res.p50_us;
+    state.counters["p99_us"] = res.p99_us;
+    state.counters["p999_us"] = res.p999_us;
+    state.counters["bytes_per_sec"] = (res.elapsed_secs > 0) ? res.total_bytes / res.elapsed_secs : 0.0;
+    state.counters["writes_per_sec"] = (res.elapsed_secs > 0) ? res.num_writes / res.elapsed_secs : 0.0;
+    state.counters["follower_lag_max"] = res.max_follower_lag;
+    state.counters["follower_lag_avg"] = res.avg_follower_lag;
+    state.counters["fetch_data_pct"] = res.num_writes ? (100.0 * res.num_fetches) / res.num_writes : 0.0;
+}
+
+BENCHMARK(replicated_write)->UseRealTime()->Iterations(1)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char* argv[]) {
+    int parsed_argc = argc;
+    char** orig_argv = argv;
+
+    // Save the args for replica use
+    std::vector< std::string > args;
+    for (int i = 0; i < argc; ++i) {
+        args.emplace_back(argv[i]);
+    }
+
+    ::benchmark::Initialize(&parsed_argc, argv);
+    SISL_OPTIONS_LOAD(parsed_argc, argv, logging, raft_repl_dev_benchmark, iomgr, config, test_common_setup,
+                      test_repl_common_setup);
+
+    // Keep the leader fixed to replica 0 for the whole run and avoid any background activity (like snapshot
+    // truncation, implicit flushes) not triggered by the write path itself.
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.consensus.leadership_expiry_ms = -1;
+        s.generic.repl_dev_cleanup_interval_sec = 1;
+        s.resource_limits.resource_audit_timer_ms = 0;
+    });
+    HS_SETTINGS_FACTORY().save();
+
+    FLAGS_folly_global_cpu_executor_threads = 4;
+    g_helper = std::make_unique< test_common::HSReplTestHelper >("raft_repl_dev_benchmark", args, orig_argv);
+    g_helper->setup(SISL_OPTIONS["replicas"].as< uint32_t >());
+
+    g_db = std::make_shared< BenchReplicatedDB >();
+    g_helper->register_listener(g_db);
+
+    ::benchmark::RunSpecifiedBenchmarks();
+
+    LOGINFO("Metrics: {}", sisl::MetricsFarm::getInstance().get_result_in_json()["RaftReplDev"].dump(4));
+    g_helper->sync_for_cleanup_start();
+    if (g_db->is_leader()) {
+        auto err = hs()->repl_service().remove_repl_dev(g_db->repl_dev()->group_id()).get();
+        RELEASE_ASSERT(err == ReplServiceError::OK, "Error in destroying the group err={}", enum_name(err));
+    }
+    g_helper->teardown();
+    g_helper.reset();
+    return 0;
+}
@@ -0,0 +1,193 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+/*
+ * Benchmark of writes through SoloReplDev, comparing the per request journal path (batch size 0) against the group
+ * commit path at various batch sizes.
+ *
+ * Example: solo_repl_dev_benchmark --num_io 100000 --qdepth 64 --io_size 4096
+ */
+#include <atomic>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+#include <iomgr/io_environment.hpp>
+#include <sisl/logging/logging.h>
+#include <sisl/options/options.h>
+#include <homestore/homestore.hpp>
+#include <homestore/replication_service.hpp>
+#include <homestore/replication/repl_dev.h>
+#include "common/homestore_config.hpp"
+#include "common/homestore_utils.hpp"
+#include "test_common/homestore_test_common.hpp"
+
+using namespace homestore;
+
+SISL_LOGGING_INIT(HOMESTORE_LOG_MODS)
+SISL_OPTIONS_ENABLE(logging, solo_repl_dev_benchmark, iomgr, test_common_setup)
+
+SISL_OPTION_GROUP(solo_repl_dev_benchmark,
+                  (io_size, "", "io_size", "size of each write, 0 for header only writes",
+                   ::cxxopts::value< uint32_t >()->default_value("4096"), "number"));
+
+struct bench_req : public repl_req_ctx {
+    struct journal_header {
+        uint64_t data_size;
+        uint64_t id;
+    };
+    journal_header jheader;
+    sisl::sg_list write_sgs;
+
+    bench_req() { write_sgs.size = 0; }
+    ~bench_req() {
+        for (auto const& iov : write_sgs.iovs) {
+            iomanager.iobuf_free(uintptr_cast(iov.iov_base));
+        }
+    }
+};
+
+class BenchListener : public ReplDevListener {
+public:
+    void on_commit(int64_t lsn, sisl::blob const& header, sisl::blob const& key,
+                   std::vector< MultiBlkId > const& blkids, cintrusive< repl_req_ctx >& ctx) override {
+        if (ctx == nullptr) { return; } // Replay of the previous iteration's entries after restart
+        m_commit_count.fetch_add(1);
+        if (m_runner) { m_runner->next_task(); }
+    }
+
+    bool on_pre_commit(int64_t lsn, const sisl::blob& header, const sisl::blob& key,
+                       cintrusive< repl_req_ctx >& ctx) override {
+        return true;
+    }
+    void on_rollback(int64_t lsn, const sisl::blob& header, const sisl::blob& key,
+                     cintrusive< repl_req_ctx >& ctx) override {}
+    AsyncReplResult<> create_snapshot(shared< snapshot_context > context) override { return make_async_success<>(); }
+    int read_snapshot_obj(shared< snapshot_context > context, shared< snapshot_obj > snp_data) override { return 0; }
+    void write_snapshot_obj(shared< snapshot_context > context, shared< snapshot_obj > snp_data) override {}
+    bool apply_snapshot(shared< snapshot_context > context) override { return true; }
+    shared< snapshot_context > last_snapshot() override { return nullptr; }
+    void free_user_snp_ctx(void*& user_snp_ctx) override {}
+    ReplResult< blk_alloc_hints > get_blk_alloc_hints(sisl::blob const& header, uint32_t data_size,
+                                                      cintrusive< homestore::repl_req_ctx >& hs_ctx) override {
+        return blk_alloc_hints{};
+    }
+    void on_restart() override {}
+    void on_error(ReplServiceError error, const sisl::blob& header, const sisl::blob& key,
+                  cintrusive< repl_req_ctx >& ctx) override {
+        LOGERROR("Received error={} on repl_dev", enum_name(error));
+    }
+    void on_start_replace_member(const std::string& task_id, const replica_member_info& member_out,
+                                 const replica_member_info& member_in, trace_id_t tid) override {}
+    void on_complete_replace_member(const std::string& task_id, const replica_member_info& member_out,
+                                    const replica_member_info& member_in, trace_id_t tid) override {}
+    void on_clean_replace_member_task(const std::string& task_id, const replica_member_info& member_out,
+                                      const replica_member_info& member_in, trace_id_t tid) override {}
+    void on_remove_member(const replica_id_t& member, trace_id_t tid) override {}
+    void on_destroy(const group_id_t& group_id) override {}
+    void notify_committed_lsn(int64_t lsn) override {}
+    void on_config_rollback(int64_t lsn) override {}
+    void on_no_space_left(repl_lsn_t lsn, sisl::blob const& header) override {}
+
+    void set_runner(test_common::Runner* runner) { m_runner = runner; }
+    uint64_t commit_count() const { return m_commit_count.load(); }
+
+private:
+    std::atomic< uint64_t > m_commit_count{0};
+    test_common::Runner* m_runner{nullptr};
+};
+
+static std::shared_ptr< BenchListener > g_listener = std::make_shared< BenchListener >();
+
+class BenchApplication : public ReplApplication {
+public:
+    repl_impl_type get_impl_type() const override { return repl_impl_type::solo; }
+    bool need_timeline_consistency() const { return true; }
+    shared< ReplDevListener > create_repl_dev_listener(uuid_t) override { return g_listener; }
+    void destroy_repl_dev_listener(uuid_t) override {}
+    void on_repl_devs_init_completed() {}
+    std::pair< std::string, uint16_t > lookup_peer(uuid_t uuid) const override { return std::make_pair("", 0u); }
+    replica_id_t get_my_repl_id() const override { return hs_utils::gen_random_uuid(); }
+    uint32_t get_my_repl_svc_port() const override { return 0; }
+};
+
+static test_common::HSTestHelper g_helper;
+static shared< ReplDev > g_repl_dev;
+
+static void issue_write(uint64_t id) {
+    auto const io_size = SISL_OPTIONS["io_size"].as< uint32_t >();
+    auto req = intrusive< bench_req >(new bench_req());
+    req->jheader.data_size = io_size;
+    req->jheader.id = id;
+    if (io_size != 0) { req->write_sgs = test_common::HSTestHelper::create_sgs(io_size, io_size, id); }
+
+    g_repl_dev->async_alloc_write(sisl::blob{uintptr_cast(&req->jheader), sizeof(bench_req::journal_header)},
+                                  sisl::blob{uintptr_cast(&req->jheader.id), sizeof(uint64_t)}, req->write_sgs, req);
+}
+
+static void solo_repl_write(benchmark::State& state) {
+    auto const batch_size = uint32_cast(state.range(0));
+    HS_SETTINGS_FACTORY().modifiable_settings(
+        [batch_size](auto& s) { s.generic.solo_repl_dev_max_batch_size = batch_size; });
+    HS_SETTINGS_FACTORY().save();
+
+    auto const num_io = SISL_OPTIONS["num_io"].as< uint64_t >();
+    auto const start_count = g_listener->commit_count();
+    for (auto _ : state) {
+        test_common::Runner runner{num_io, SISL_OPTIONS["qdepth"].as< uint32_t >()};
+        std::atomic< uint64_t > next_id{0};
+        g_listener->set_runner(&runner);
+        runner.set_task([&next_id]() { issue_write(next_id.fetch_add(1)); });
+        runner.execute().get();
+        g_listener->set_runner(nullptr);
+    }
+
+    auto const writes = g_listener->commit_count() - start_count;
+    state.counters["batch_size"] = batch_size;
+    state.counters["qdepth"] = SISL_OPTIONS["qdepth"].as< uint32_t >();
+    state.counters["writes_per_sec"] = benchmark::Counter(writes, benchmark::Counter::kIsRate);
+    state.counters["bytes_per_sec"] =
+        benchmark::Counter(writes * SISL_OPTIONS["io_size"].as< uint32_t >(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(solo_repl_write)
+    ->Arg(0)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(64)
+    ->Arg(256)
+    ->UseRealTime()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char* argv[]) {
+    int parsed_argc = argc;
+    ::benchmark::Initialize(&parsed_argc, argv);
+    SISL_OPTIONS_LOAD(parsed_argc, argv, logging, solo_repl_dev_benchmark, iomgr, test_common_setup);
+    sisl::logging::SetLogger("solo_repl_dev_benchmark");
+    spdlog::set_pattern("[%D %T%z] [%^%l%$] [%n] [%t] %v");
+
+    g_helper.start_homestore(
+        "solo_repl_dev_benchmark",
+        {{HS_SERVICE::META, {.size_pct = 5.0}},
+         {HS_SERVICE::REPLICATION, {.size_pct = 60.0, .repl_app = std::make_unique< BenchApplication >()}},
+         {HS_SERVICE::LOG,
+          {.size_pct = 22.0, .chunk_size = 32 * 1024 * 1024, .vdev_size_type = vdev_size_type_t::VDEV_SIZE_DYNAMIC}}});
+    g_repl_dev = hs()->repl_service().create_repl_dev(hs_utils::gen_random_uuid(), {}).get().value();
+
+    ::benchmark::RunSpecifiedBenchmarks();
+
+    g_repl_dev.reset();
+    g_helper.shutdown_homestore();
+    return 0;
+}
@@ -358,6 +358,41 @@ TEST_F(BlkReadTrackerTest, TestInsRmWithWaiterOverlapMultiReads2) {
     get_inst()->remove(c);
 }
 
+/*
+ * Alignment: 8
+ * 1. read: {{4, 6}, {40, 2}, {80, 8}, 2} inserted in one go, covers base ids {0, 8, 2}, {8, 8, 2}, {40, 8, 2}, {80, 8, 2}
+ * 2. free: {{42, 4}, {84, 2}, 2} // overlaps the read on base ids {40, 8, 2}, {80, 8, 2}
+ * 3. read completes, removed in one go // free cb should be triggered
+ * */
+TEST_F(BlkReadTrackerTest, TestBatchedInsRmWithWaiter) {
+    auto align = 8ul;
+    LOGINFO("Step 1: set entries per record to {}.", align);
+    get_inst()->set_entries_per_record(align);
+
+    MultiBlkId read_bid{4, 6, 2};
+    read_bid.add(40, 2, 2);
+    read_bid.add(80, 8, 2);
+    LOGINFO("Step 2: read on blkid: {}.", read_bid.to_string());
+    get_inst()->insert(read_bid);
+
+    MultiBlkId free_bid{42, 4, 2};
+    free_bid.add(84, 2, 2);
+    bool called{false};
+    LOGINFO("Step 3: free blkid: {}.", free_bid.to_string());
+    get_inst()->wait_on(free_bid, [&free_bid, &called]() {
+        LOGMSG_ASSERT_EQ(called, false, "not expecting wait_on callback to be called more than once!");
+        called = true;
+        LOGINFO("wait_on callback triggered on blkid: {}", free_bid.to_string());
+    });
+    assert(!called);
+
+    LOGINFO("Step 4: read completes on blkid: {}.", read_bid.to_string());
+    get_inst()->remove(read_bid);
+
+    LOGINFO("Step 5: assert that callback is triggered by read complete.");
+    assert(called);
+}
+
 //////////////////////////// Multi-thread test cases //////////////////////////////
 
 /*
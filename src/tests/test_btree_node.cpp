@@ -57,6 +57,12 @@ struct VarObjSizeNodeTest {
     using ValueType = TestVarLenValue;
 };
 
+struct VarPrefixNodeTest {
+    using NodeType = VarPrefixNode< TestVarLenKey, TestVarLenValue >;
+    using KeyType = TestVarLenKey;
+    using ValueType = TestVarLenValue;
+};
+
 struct PrefixIntervalBtreeTest {
     using NodeType = FixedPrefixNode< TestIntervalKey, TestIntervalValue >;
     using KeyType = TestIntervalKey;
@@ -330,7 +336,7 @@ private:
 };
 
 using NodeTypes = testing::Types< FixedLenNodeTest, VarKeySizeNodeTest, VarValueSizeNodeTest, VarObjSizeNodeTest,
-                                  PrefixIntervalBtreeTest >;
+                                  VarPrefixNodeTest, PrefixIntervalBtreeTest >;
 TYPED_TEST_SUITE(NodeTest, NodeTypes);
 
 TYPED_TEST(NodeTest, SequentialInsert) {
@@ -499,6 +505,39 @@ TYPED_TEST(NodeTest, Move) {
     this->validate_key_order();
 }
 
+TYPED_TEST(NodeTest, CopyReencodedPrefix) {
+    if (this->m_node1->get_node_type() != btree_node_type::VAR_PREFIX) { return; }
+
+    LOGINFO("Step 1: Fill up a node with keys sharing a long prefix and move them all to the right node");
+    for (uint32_t k{0x1000}; (k < g_max_keys) && this->has_room(); ++k) {
+        this->put(k, btree_put_type::INSERT);
+    }
+    this->m_node1->move_out_to_right_by_entries(this->m_cfg, *this->m_node2, this->m_node1->total_entries());
+    auto const nright = this->m_node2->total_entries();
+
+    LOGINFO("Step 2: Put keys with a shorter common prefix in the left node, copied in keys now take more room");
+    for (uint32_t k{0}; k < 16; ++k) {
+        this->put(k, btree_put_type::INSERT);
+    }
+
+    LOGINFO("Step 3: Copy by size doesn't grow the node past the size asked for");
+    auto const size_before = this->m_node1->occupied_size();
+    auto ncopied = this->m_node1->copy_by_size(this->m_cfg, *this->m_node2, 0, 256);
+    ASSERT_LE(this->m_node1->occupied_size(), size_before + 256) << "Copy by size went past the size asked for";
+    if (ncopied != 0) { this->m_node2->remove(0, ncopied - 1); }
+
+    LOGINFO("Step 4: Copy by entries copies only as many entries as fit once reencoded");
+    auto const nleft = this->m_node2->total_entries();
+    auto const n = this->m_node1->copy_by_entries(this->m_cfg, *this->m_node2, 0, std::numeric_limits< uint32_t >::max());
+    ASSERT_LE(this->m_node1->occupied_size(), g_node_size) << "Copy by entries has overflown the node";
+    ASSERT_LE(n, nleft);
+    if (n != 0) { this->m_node2->remove(0, n - 1); }
+    ASSERT_EQ(ncopied + n + this->m_node2->total_entries(), nright) << "Entries are lost or duplicated by copy";
+    this->print();
+    this->validate_get_all();
+    this->validate_key_order();
+}
+
 SISL_OPTIONS_ENABLE(logging, test_btree_node)
 SISL_OPTION_GROUP(test_btree_node,
                   (num_iters, "", "num_iters", "number of iterations for rand ops",
@@ -17,7 +17,6 @@
  */
 
 #pragma once
-#include "raft_repl_test_base.hpp"
 
 #include <mutex>
 #include <condition_variable>
@@ -30,6 +29,8 @@
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include <boost/interprocess/sync/interprocess_condition.hpp>
 #include <boost/uuid/string_generator.hpp>
+#include <folly/init/Init.h>
+#include <gtest/gtest.h>
 
 #include <sisl/logging/logging.h>
 #include <sisl/options/options.h>
@@ -262,6 +262,9 @@ public:
         std::memcpy(blob.bytes(), kv_snapshot_obj.data(), kv_snapshot_obj_size);
         snp_data->blob = std::move(blob);
         snp_data->is_last_obj = false;
+        // Follower resumes from the lsn after the last one sent, hint it so that leader can read ahead
+        snp_data->next_offset = kv_snapshot_obj.back().value.lsn_ + 1;
+        set_resync_msg_type_bit(snp_data->next_offset);
         LOGINFOMOD(replication, "[Replica={}] Read logical snapshot callback obj_id={} term={} idx={} num_items={}",
                    g_helper->replica_num(), snp_data->offset, s->get_last_log_term(), s->get_last_log_idx(),
                    kv_snapshot_obj.size());
@@ -300,24 +303,9 @@ public:
         if (kv_snapshot_obj_size == 0) return;
 
         size_t num_items = kv_snapshot_obj_size / sizeof(KeyValuePair);
-        std::unique_lock lk(db_mtx_);
-        auto ptr = r_cast< const KeyValuePair* >(snp_data->blob.bytes());
-        for (size_t i = 0; i < num_items; i++) {
-            auto key = ptr->key;
-            auto value = ptr->value;
-            LOGTRACEMOD(replication, "[Replica={}] Save logical snapshot got lsn={} data_size={} data_pattern={}",
-                        g_helper->replica_num(), value.lsn_, value.data_size_, value.data_pattern_);
-
-            // Write to data service and inmem map.
-            MultiBlkId out_blkids;
-            if (value.data_size_ != 0) {
-                snapshot_obj_write(value.data_size_, value.data_pattern_, out_blkids);
-                value.blkid_ = out_blkids;
-            }
-            inmem_db_.insert_or_assign(key, value);
-            last_committed_lsn = value.lsn_;
-            ++commit_count_;
-            ptr++;
+        {
+            std::unique_lock lk(db_mtx_);
+            save_snapshot_kvs(r_cast< const KeyValuePair* >(snp_data->blob.bytes()), num_items);
         }
 
         snp_data->offset = last_committed_lsn + 1;
@@ -328,6 +316,41 @@ public:
                    snp_data->is_last_obj, num_items);
     }
 
+    folly::Future< folly::Unit > async_write_snapshot_obj(shared< snapshot_context > context,
+                                                          shared< snapshot_obj > snp_data) override {
+        if (!async_snp_write_ || RaftStateMachine::is_hs_snp_obj(snp_data->offset) ||
+            (get_next_lsn(snp_data->offset) == 0) || (snp_data->blob.size() == 0)) {
+            write_snapshot_obj(std::move(context), std::move(snp_data));
+            return folly::makeFuture< folly::Unit >(folly::Unit{});
+        }
+
+        // Pick the next obj_id from the last item of this object right away and save the items in background, so that
+        // the state machine has several objects in flight.
+        auto blob = std::make_shared< sisl::io_blob_safe >(std::move(snp_data->blob));
+        size_t const num_items = blob->size() / sizeof(KeyValuePair);
+        auto const* kvs = r_cast< const KeyValuePair* >(blob->cbytes());
+        snp_data->offset = kvs[num_items - 1].value.lsn_ + 1;
+        set_resync_msg_type_bit(snp_data->offset);
+        LOGINFOMOD(replication, "[Replica={}] Async save logical snapshot obj next obj_id={} num_items={}",
+                   g_helper->replica_num(), snp_data->offset, num_items);
+
+        folly::Promise< folly::Unit > promise;
+        auto fut = promise.getFuture();
+        folly::getGlobalCPUExecutor()->add([this, blob, num_items, p = std::move(promise)]() mutable {
+            {
+                std::unique_lock lk(db_mtx_);
+                save_snapshot_kvs(r_cast< const KeyValuePair* >(blob->cbytes()), num_items);
+            }
+            async_snp_write_cnt_.fetch_add(1);
+            p.setValue(folly::Unit{});
+        });
+        return fut;
+    }
+
+    // Baseline resync on this replica writes the snapshot objects asynchronously, see async_write_snapshot_obj
+    void set_async_snapshot_write(bool on) { async_snp_write_ = on; }
+    uint64_t async_snapshot_write_count() const { return async_snp_write_cnt_.load(); }
+
     bool apply_snapshot(shared< snapshot_context > context) override {
         std::lock_guard< std::mutex > lock(m_snapshot_lock);
         auto s = std::dynamic_pointer_cast< nuraft_snapshot_context >(context)->nuraft_snapshot();
@@ -486,6 +509,29 @@ public:
         return zombie_;
     }
 
+private:
+    // Caller holds db_mtx_
+    void save_snapshot_kvs(const KeyValuePair* ptr, size_t num_items) {
+        for (size_t i = 0; i < num_items; i++) {
+            auto key = ptr->key;
+            auto value = ptr->value;
+            LOGTRACEMOD(replication, "[Replica={}] Save logical snapshot got lsn={} data_size={} data_pattern={}",
+                        g_helper->replica_num(), value.lsn_, value.data_size_, value.data_pattern_);
+
+            // Write to data service and inmem map.
+            MultiBlkId out_blkids;
+            if (value.data_size_ != 0) {
+                snapshot_obj_write(value.data_size_, value.data_pattern_, out_blkids);
+                value.blkid_ = out_blkids;
+            }
+            inmem_db_.insert_or_assign(key, value);
+            // Objects written asynchronously can complete out of order
+            last_committed_lsn = std::max(last_committed_lsn, static_cast< uint64_t >(value.lsn_));
+            ++commit_count_;
+            ptr++;
+        }
+    }
+
 private:
     std::map< Key, Value > inmem_db_;
     std::map< int64_t, Value > lsn_index_;
@@ -495,6 +541,8 @@ private:
     std::shared_ptr< snapshot_context > m_last_snapshot{nullptr};
     std::mutex m_snapshot_lock;
     bool zombie_{false};
+    bool async_snp_write_{false};
+    std::atomic< uint64_t > async_snp_write_cnt_{0};
 };
 
 class RaftReplDevTestBase : public testing::Test {
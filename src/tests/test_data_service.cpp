@@ -18,6 +18,8 @@
 #include <filesystem>
 #include <random>
 #include <unordered_set>
+#include <map>
+#include <cstring>
 #include <farmhash.h>
 
 #include <gtest/gtest.h>
@@ -25,6 +27,7 @@
 #include <sisl/logging/logging.h>
 #include <sisl/options/options.h>
 #include <sisl/fds/buffer.hpp>
+#include <sisl/metrics/metrics.hpp>
 #include <gtest/gtest.h>
 #include <iomgr/iomgr_flip.hpp>
 #include <folly/concurrency/ConcurrentHashMap.h>
@@ -97,6 +100,20 @@ public:
 
     void free(sisl::sg_list& sg) { test_common::HSTestHelper::free(sg); }
 
+    // Counter of a metrics group summed over its instances, looked up by its description
+    static int64_t metrics_counter(std::string const& group_name, std::string const& desc) {
+        auto const j = sisl::MetricsFarm::getInstance().get_result_in_json();
+        int64_t total{0};
+        if (!j.contains(group_name)) { return total; }
+        for (auto const& [inst, group] : j[group_name].items()) {
+            if (!group.contains("Counters")) { continue; }
+            for (auto const& [name, val] : group["Counters"].items()) {
+                if (name.find(desc) != std::string::npos) { total += val.get< int64_t >(); }
+            }
+        }
+        return total;
+    }
+
     // free_blk after read completes
     void write_read_free_blk(uint64_t io_size) {
         auto sg_write_ptr = std::make_shared< sisl::sg_list >();
@@ -241,6 +258,109 @@ public:
             });
     }
 
+    // write compressible data, which should take fewer blks than its size, then read it back with its size
+    static void fill_compressible(sisl::sg_list& sg, const uint64_t io_size) {
+        struct iovec iov;
+        iov.iov_len = io_size;
+        iov.iov_base = iomanager.iobuf_alloc(512, io_size);
+        auto* ptr = r_cast< uint64_t* >(iov.iov_base);
+        for (uint64_t i = 0; i < io_size / sizeof(uint64_t); ++i) {
+            ptr[i] = i / 64; // runs of the same value compress well with any codec
+        }
+        sg.iovs.push_back(iov);
+        sg.size = io_size;
+    }
+
+    void write_compressed_io_verify(const uint64_t io_size,
+                                    std::shared_ptr< MultiBlkId > test_blkid_ptr = std::make_shared< MultiBlkId >()) {
+        auto sg_write_ptr = std::make_shared< sisl::sg_list >();
+        auto sg_read_ptr = std::make_shared< sisl::sg_list >();
+        fill_compressible(*sg_write_ptr, io_size);
+
+        auto fut = inst().async_alloc_write(*sg_write_ptr, blk_alloc_hints{}, *test_blkid_ptr);
+        inst().commit_blk(*test_blkid_ptr);
+        std::move(fut)
+            .thenValue([this, sg_write_ptr, sg_read_ptr, test_blkid_ptr, io_size](auto&& err) {
+                RELEASE_ASSERT(!err, "Write error");
+                RELEASE_ASSERT_LT(test_blkid_ptr->blk_count() * inst().get_blk_size(), io_size,
+                                  "Compressible data is expected to be stored in fewer blks");
+
+                struct iovec iov;
+                iov.iov_len = io_size;
+                iov.iov_base = iomanager.iobuf_alloc(512, io_size);
+                sg_read_ptr->iovs.push_back(iov);
+                sg_read_ptr->size = io_size;
+
+                LOGINFO("Step 2: async read on compressed blkid: {}", test_blkid_ptr->to_string());
+                return inst().async_read(*test_blkid_ptr, *sg_read_ptr, sg_read_ptr->size);
+            })
+            .thenValue([this, sg_write_ptr, sg_read_ptr](auto&& err) mutable {
+                RELEASE_ASSERT(!err, "Read error");
+
+                const auto equal = test_common::HSTestHelper::compare(*sg_read_ptr, *sg_write_ptr);
+                RELEASE_ASSERT(equal, "Read after compressed write data mismatch");
+
+                LOGINFO("Read completed;");
+                free(*sg_write_ptr);
+                free(*sg_read_ptr);
+
+                this->finish_and_notify();
+            });
+    }
+
+    // read back the blkid written by write_compressed_io_verify
+    void read_compressed_io_verify(const uint64_t io_size, MultiBlkId const& blkid) {
+        auto sg_expected_ptr = std::make_shared< sisl::sg_list >();
+        auto sg_read_ptr = std::make_shared< sisl::sg_list >();
+        fill_compressible(*sg_expected_ptr, io_size);
+
+        struct iovec iov;
+        iov.iov_len = io_size;
+        iov.iov_base = iomanager.iobuf_alloc(512, io_size);
+        sg_read_ptr->iovs.push_back(iov);
+        sg_read_ptr->size = io_size;
+
+        LOGINFO("async read on compressed blkid: {}", blkid.to_string());
+        inst()
+            .async_read(blkid, *sg_read_ptr, sg_read_ptr->size)
+            .thenValue([this, sg_expected_ptr, sg_read_ptr](auto&& err) {
+                RELEASE_ASSERT(!err, "Read error");
+
+                const auto equal = test_common::HSTestHelper::compare(*sg_read_ptr, *sg_expected_ptr);
+                RELEASE_ASSERT(equal, "Read of compressed blkid data mismatch");
+
+                LOGINFO("Read completed;");
+                free(*sg_expected_ptr);
+                free(*sg_read_ptr);
+
+                this->finish_and_notify();
+            });
+    }
+
+    // read the blks of the blkid written by write_compressed_io_verify as they are, which has to fail
+    void read_partial_compressed_io_verify(MultiBlkId const& blkid) {
+        auto sg_read_ptr = std::make_shared< sisl::sg_list >();
+        uint64_t const read_size = blkid.blk_count() * inst().get_blk_size();
+        struct iovec iov;
+        iov.iov_len = read_size;
+        iov.iov_base = iomanager.iobuf_alloc(512, read_size);
+        sg_read_ptr->iovs.push_back(iov);
+        sg_read_ptr->size = read_size;
+
+        LOGINFO("async read of {} Bytes on compressed blkid: {}", read_size, blkid.to_string());
+        inst()
+            .async_read(blkid, *sg_read_ptr, sg_read_ptr->size)
+            .thenValue([this, sg_read_ptr](auto&& err) {
+                RELEASE_ASSERT(err == std::make_error_code(std::errc::invalid_argument),
+                               "Partial read of compressed blkid is expected to fail, err={}", err.message());
+
+                LOGINFO("Read failed as expected;");
+                free(*sg_read_ptr);
+
+                this->finish_and_notify();
+            });
+    }
+
     void write_and_restart_with_missing_data_drive(const uint64_t io_size) {
         vdev_info vinfo;
         auto data_vdev = inst().open_vdev(vinfo, true);
@@ -424,6 +544,7 @@ public:
     void wait_for_all_io_complete() {
         std::unique_lock lk(m_mtx);
         m_cv.wait(lk, [this] { return this->m_io_job_done; });
+        m_io_job_done = false; // ready for the next io job
     }
 
     ////////////////////////// Load Test APIS ////////////////////////////////
@@ -811,6 +932,41 @@ private:
 #endif
     }
 
+    void add_batch_io_error() {
+#ifdef _PRERELEASE
+        flip::FlipClient* fc = iomgr_flip::client_instance();
+
+        flip::FlipFrequency freq;
+        freq.set_count(1);
+        freq.set_percent(100);
+
+        // Fail the first io issued by the next batch submit
+        flip::FlipCondition null_cond;
+        fc->inject_noreturn_flip("vdev_batch_io_error", {null_cond}, freq);
+#endif
+    }
+
+    // Issue single blk ios as part of one batch. The vdev queues them per thread till the batch is submitted, so they
+    // are all issued and submitted on the same reactor.
+    std::vector< std::error_code > batch_io(std::vector< std::pair< BlkId, uint8_t* > > const& ios, bool is_write) {
+        std::vector< folly::Future< std::error_code > > futs;
+        iomanager.run_on_wait(iomgr::reactor_regex::random_worker, [this, &ios, is_write, &futs]() {
+            for (auto const& [bid, buf] : ios) {
+                futs.emplace_back(is_write ? inst().async_write(r_cast< char const* >(buf), inst().get_blk_size(),
+                                                                MultiBlkId{bid}, true /* part_of_batch */)
+                                           : inst().async_read(MultiBlkId{bid}, buf, inst().get_blk_size(),
+                                                               true /* part_of_batch */));
+            }
+            inst().submit_io_batch();
+        });
+
+        std::vector< std::error_code > errs;
+        for (auto& f : futs) {
+            errs.push_back(std::move(f).get());
+        }
+        return errs;
+    }
+
 private:
     std::mutex m_mtx;
     std::condition_variable m_cv;
@@ -908,6 +1064,255 @@ TEST_F(BlkDataServiceTest, TestWriteThenReadVerify) {
     LOGINFO("Step 4: I/O completed, do shutdown.");
 }
 
+TEST_F(BlkDataServiceTest, TestReadFromDataCache) {
+    LOGINFO("Step 1: Give part of the cache to the data cache and restart homestore to enable it.");
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.resource_limits.data_cache_size_percent = 20;
+        s.generic.data_cache_write_through = false;
+    });
+    HS_SETTINGS_FACTORY().save();
+    m_helper.restart_homestore();
+
+    static constexpr char const* hit_desc{"Reads of a blkid served from the data cache"};
+    static constexpr char const* miss_desc{"Reads of a blkid which had to go to the device"};
+    auto const hits_before = metrics_counter("BlkDataCache", hit_desc);
+    auto const misses_before = metrics_counter("BlkDataCache", miss_desc);
+
+    auto io_size = 16 * Ki;
+    LOGINFO("Step 2: Write then read {} Bytes, read misses the data cache and adds the blks to it.", io_size);
+    iomanager.run_on_forget(iomgr::reactor_regex::random_worker, [this, io_size]() { this->write_io_verify(io_size); });
+    wait_for_all_io_complete();
+    ASSERT_EQ(metrics_counter("BlkDataCache", hit_desc), hits_before)
+        << "Read of freshly written blks hit the data cache";
+    auto const misses_after_read = metrics_counter("BlkDataCache", miss_desc);
+    ASSERT_GT(misses_after_read, misses_before) << "Read of freshly written blks did not miss the data cache";
+
+    LOGINFO("Step 3: Write through the data cache then read {} Bytes, which is served from the cache.", io_size);
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) { s.generic.data_cache_write_through = true; });
+    HS_SETTINGS_FACTORY().save();
+    iomanager.run_on_forget(iomgr::reactor_regex::random_worker, [this, io_size]() { this->write_io_verify(io_size); });
+    wait_for_all_io_complete();
+    auto const hits_after_write_through = metrics_counter("BlkDataCache", hit_desc);
+    ASSERT_GT(hits_after_write_through, hits_before) << "Read after write through was not served from the data cache";
+    ASSERT_EQ(metrics_counter("BlkDataCache", miss_desc), misses_after_read)
+        << "Read after write through went to the device";
+
+    LOGINFO("Step 4: Write, read then free the blks, which drops them from the data cache.");
+    iomanager.run_on_forget(iomgr::reactor_regex::random_worker,
+                            [this, io_size]() { this->write_read_free_blk(io_size); });
+    wait_for_all_io_complete();
+    ASSERT_GT(metrics_counter("BlkDataCache", hit_desc), hits_after_write_through)
+        << "Read before free missed the data cache";
+
+    LOGINFO("Step 5: I/O completed, reset the settings and do shutdown.");
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.resource_limits.data_cache_size_percent = 0;
+        s.generic.data_cache_write_through = false;
+    });
+    HS_SETTINGS_FACTORY().save();
+}
+
+#ifdef _PRERELEASE
+TEST_F(BlkDataServiceTest, TestDataCacheReadRacingWrite) {
+    LOGINFO("Step 1: Give part of the cache to the data cache and restart homestore to enable it.");
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.resource_limits.data_cache_size_percent = 20;
+        s.generic.data_cache_write_through = false;
+    });
+    HS_SETTINGS_FACTORY().save();
+    m_helper.restart_homestore();
+
+    auto const blk_size = inst().get_blk_size();
+    MultiBlkId blkid;
+    ASSERT_EQ(inst().alloc_blks(blk_size, blk_alloc_hints{}, blkid), BlkAllocStatus::SUCCESS);
+    auto* old_buf = iomanager.iobuf_alloc(512, blk_size);
+    auto* new_buf = iomanager.iobuf_alloc(512, blk_size);
+    auto* rbuf = iomanager.iobuf_alloc(512, blk_size);
+    std::memset(old_buf, 'o', blk_size);
+    std::memset(new_buf, 'n', blk_size);
+
+    // Issued on a worker and waited for here, since the worker is the one completing it
+    auto do_io = [](auto&& io_fn) {
+        auto fut = folly::makeFuture< std::error_code >(std::error_code{});
+        iomanager.run_on_wait(iomgr::reactor_regex::random_worker, [&fut, &io_fn]() { fut = io_fn(); });
+        return std::move(fut).get();
+    };
+
+    LOGINFO("Step 2: Write the blk, which is not cached since the cache is not write through.");
+    ASSERT_FALSE(do_io([&]() { return inst().async_write(r_cast< char const* >(old_buf), blk_size, blkid); }))
+        << "Write error";
+
+    LOGINFO("Step 3: Delay a read of the blk, which misses the cache, and overwrite the blk while it is in flight.");
+    add_read_delay();
+    auto read_fut = folly::makeFuture< std::error_code >(std::error_code{});
+    auto write_fut = folly::makeFuture< std::error_code >(std::error_code{});
+    iomanager.run_on_wait(iomgr::reactor_regex::random_worker, [&]() {
+        read_fut = inst().async_read(blkid, rbuf, blk_size);
+        write_fut = inst().async_write(r_cast< char const* >(new_buf), blk_size, blkid);
+    });
+    ASSERT_FALSE(std::move(write_fut).get()) << "Write error";
+    ASSERT_FALSE(std::move(read_fut).get()) << "Read error";
+
+    LOGINFO("Step 4: Read of the blk after both completed returns the new data, not what the racing read got.");
+    std::memset(rbuf, 0, blk_size);
+    ASSERT_FALSE(do_io([&]() { return inst().async_read(blkid, rbuf, blk_size); })) << "Read error";
+    ASSERT_EQ(std::memcmp(rbuf, new_buf, blk_size), 0) << "Read after the racing read returned stale data";
+
+    LOGINFO("Step 5: I/O completed, reset the settings and do shutdown.");
+    iomanager.iobuf_free(old_buf);
+    iomanager.iobuf_free(new_buf);
+    iomanager.iobuf_free(rbuf);
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.resource_limits.data_cache_size_percent = 0;
+        s.generic.data_cache_write_through = false;
+    });
+    HS_SETTINGS_FACTORY().save();
+}
+#endif
+
+TEST_F(BlkDataServiceTest, TestCompressedWriteRead) {
+    LOGINFO("Step 1: Turn on data compression.");
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) { s.generic.data_compression = 1; });
+    HS_SETTINGS_FACTORY().save();
+
+    auto io_size = 64 * Ki;
+    auto compressed_blkid = std::make_shared< MultiBlkId >();
+    LOGINFO("Step 2: Write compressible {} Bytes then read and verify them.", io_size);
+    iomanager.run_on_forget(iomgr::reactor_regex::random_worker, [this, io_size, compressed_blkid]() {
+        this->write_compressed_io_verify(io_size, compressed_blkid);
+    });
+    wait_for_all_io_complete();
+
+    LOGINFO("Step 3: Turn off data compression, the blkid written compressed is still read and decompressed.");
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) { s.generic.data_compression = 0; });
+    HS_SETTINGS_FACTORY().save();
+    iomanager.run_on_forget(iomgr::reactor_regex::random_worker, [this, io_size, compressed_blkid]() {
+        this->read_compressed_io_verify(io_size, *compressed_blkid);
+    });
+    wait_for_all_io_complete();
+
+    LOGINFO("Step 4: Read the blkid written compressed with less than its original size, which has to fail.");
+    iomanager.run_on_forget(iomgr::reactor_regex::random_worker, [this, compressed_blkid]() {
+        this->read_partial_compressed_io_verify(*compressed_blkid);
+    });
+    wait_for_all_io_complete();
+
+    LOGINFO("Step 5: With data compression off, the raw data written now is read as is.");
+    iomanager.run_on_forget(iomgr::reactor_regex::random_worker, [this, io_size]() { this->write_io_verify(io_size); });
+    wait_for_all_io_complete();
+
+    LOGINFO("Step 6: I/O completed, do shutdown.");
+}
+
+TEST_F(BlkDataServiceTest, TestBatchCoalescedIO) {
+    static constexpr char const* coalesced_desc{"vdev batch ios merged into an adjacent io"};
+    ASSERT_NE(HS_DYNAMIC_CONFIG(device->batch_coalesce_max_size_kb), 0u) << "Batch coalescing is expected to be on";
+    auto const blk_size = inst().get_blk_size();
+
+    LOGINFO("Step 1: Allocate 8 contiguous blks, of which blks 0-2 are adjacent and blks 5 and 7 stand alone.");
+    MultiBlkId range;
+    ASSERT_EQ(inst().alloc_blks(8 * blk_size, blk_alloc_hints{}, range), BlkAllocStatus::SUCCESS);
+    ASSERT_EQ(range.num_pieces(), 1);
+    auto const first = range.to_single_blkid();
+    auto blk_at = [&first](blk_num_t i) { return BlkId{first.blk_num() + i, 1, first.chunk_num()}; };
+
+    // Issued out of order, so the vdev has to sort them before coalescing
+    std::vector< blk_num_t > const blks{2, 5, 0, 7, 1};
+    std::map< blk_num_t, uint8_t* > wbufs;
+    std::map< blk_num_t, uint8_t* > rbufs;
+    for (auto const b : blks) {
+        wbufs[b] = iomanager.iobuf_alloc(512, blk_size);
+        std::memset(wbufs[b], 'a' + b, blk_size);
+        rbufs[b] = iomanager.iobuf_alloc(512, blk_size);
+    }
+    auto ios_of = [&blk_at](std::vector< blk_num_t > const& bs, std::map< blk_num_t, uint8_t* > const& bufs) {
+        std::vector< std::pair< BlkId, uint8_t* > > ios;
+        for (auto const b : bs) {
+            ios.emplace_back(blk_at(b), bufs.at(b));
+        }
+        return ios;
+    };
+    auto verify_reads = [&](std::vector< blk_num_t > const& bs) {
+        for (auto const b : bs) {
+            ASSERT_EQ(std::memcmp(rbufs[b], wbufs[b], blk_size), 0) << "Data mismatch on blk " << b;
+        }
+    };
+
+    LOGINFO("Step 2: Batched writes of blks 0-2 are coalesced into one io, the other two are issued on their own.");
+    auto coalesced = metrics_counter("VirtualDev", coalesced_desc);
+    for (auto const& err : batch_io(ios_of(blks, wbufs), true /* is_write */)) {
+        ASSERT_FALSE(err) << "Batched write failed: " << err.message();
+    }
+    ASSERT_EQ(metrics_counter("VirtualDev", coalesced_desc), coalesced + 2);
+
+    LOGINFO("Step 3: Batched reads of the same blks are coalesced the same way and each returns its own data.");
+    coalesced = metrics_counter("VirtualDev", coalesced_desc);
+    for (auto const& err : batch_io(ios_of(blks, rbufs), false /* is_write */)) {
+        ASSERT_FALSE(err) << "Batched read failed: " << err.message();
+    }
+    ASSERT_EQ(metrics_counter("VirtualDev", coalesced_desc), coalesced + 2);
+    verify_reads(blks);
+
+#ifdef _PRERELEASE
+    LOGINFO("Step 4: Fail the coalesced write of blks 0-1, which fails both of them but not the write of blk 5.");
+    for (auto const b : std::vector< blk_num_t >{0, 1, 5}) {
+        std::memset(wbufs[b], 'A' + b, blk_size);
+    }
+    add_batch_io_error();
+    coalesced = metrics_counter("VirtualDev", coalesced_desc);
+    auto const errs = batch_io(ios_of({0, 1, 5}, wbufs), true /* is_write */);
+    ASSERT_EQ(metrics_counter("VirtualDev", coalesced_desc), coalesced + 1);
+    ASSERT_EQ(errs[0], std::make_error_code(std::errc::io_error)) << "Write of blk 0 did not fail";
+    ASSERT_EQ(errs[1], std::make_error_code(std::errc::io_error)) << "Write of blk 1 did not fail";
+    ASSERT_FALSE(errs[2]) << "Write of blk 5 failed: " << errs[2].message();
+
+    LOGINFO("Step 5: Blks 0-1 still hold the data of the first write and blk 5 the new one.");
+    for (auto const& err : batch_io(ios_of({0, 1, 5}, rbufs), false /* is_write */)) {
+        ASSERT_FALSE(err) << "Batched read failed: " << err.message();
+    }
+    ASSERT_EQ(std::memcmp(rbufs[5], wbufs[5], blk_size), 0) << "Data mismatch on blk 5";
+    for (auto const b : std::vector< blk_num_t >{0, 1}) {
+        std::memset(wbufs[b], 'a' + b, blk_size);
+    }
+    verify_reads({0, 1});
+#endif
+
+    LOGINFO("Step 6: Free the blks and the buffers.");
+    ASSERT_FALSE(inst().async_free_blk(range).get());
+    for (auto const b : blks) {
+        iomanager.iobuf_free(wbufs[b]);
+        iomanager.iobuf_free(rbufs[b]);
+    }
+}
+
+TEST_F(BlkDataServiceTest, TestCPFlushInDedicatedThread) {
+    ASSERT_TRUE(HS_DYNAMIC_CONFIG(generic.data_cp_flush_in_dedicated_thread))
+        << "Data cp flush is expected to be on its dedicated thread";
+    vdev_info vinfo;
+    auto data_vdev = inst().open_vdev(vinfo, true);
+    auto const blk_size = inst().get_blk_size();
+    static constexpr uint32_t nblks{16};
+
+    for (uint32_t round{0}; round < 3; ++round) {
+        LOGINFO("Step 1.{}: Allocate and commit {} blks, then flush them in a cp.", round, nblks);
+        MultiBlkId blkid;
+        ASSERT_EQ(inst().alloc_blks(nblks * blk_size, blk_alloc_hints{}, blkid), BlkAllocStatus::SUCCESS);
+        inst().commit_blk(blkid);
+        test_common::HSTestHelper::trigger_cp(true /* wait */);
+        ASSERT_EQ(data_vdev->cp_progress_percent(), 100);
+        auto const avail_blks = data_vdev->available_blks();
+
+        LOGINFO("Step 2.{}: Free the blks, which are held back till the cp covering the free is flushed.", round);
+        ASSERT_FALSE(inst().async_free_blk(blkid).get());
+        ASSERT_EQ(data_vdev->available_blks(), avail_blks) << "Freed blks were released before the cp flush";
+
+        LOGINFO("Step 3.{}: Flush a cp on the data cp flush thread, which releases the freed blks.", round);
+        test_common::HSTestHelper::trigger_cp(true /* wait */);
+        ASSERT_EQ(data_vdev->cp_progress_percent(), 100);
+        ASSERT_EQ(data_vdev->available_blks(), avail_blks + nblks) << "Freed blks were not released by the cp flush";
+    }
+}
+
 // Free_blk test, no read involved;
 TEST_F(BlkDataServiceTest, TestWriteThenFreeBlk) {
     // start io in worker thread;
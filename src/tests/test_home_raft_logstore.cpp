@@ -123,6 +123,7 @@ public:
         // Do invidivual get validation
         for (uint64_t lsn = m_start_lsn; lsn < uint64_cast(m_next_lsn); ++lsn) {
             validate_log(m_rls->entry_at(lsn), lsn);
+            ASSERT_EQ(m_rls->term_at(lsn), expected_term(lsn)) << "term_at mismatch at lsn=" << lsn;
         }
 
         // Do bulk get validation as well.
@@ -143,12 +144,16 @@ private:
         return nuraft::cs_new< nuraft::log_entry >(term, buf);
     }
 
-    void validate_log(const nuraft::ptr< nuraft::log_entry >& le, int64_t lsn) {
-        uint64_t expected_term;
+    uint64_t expected_term(int64_t lsn) {
+        uint64_t term;
         std::stringstream ss;
         ss << std::hex << m_shadow_log[lsn - 1].substr(0, 8);
-        ss >> expected_term;
-        ASSERT_EQ(le->get_term(), expected_term) << "Term mismatch at lsn=" << lsn;
+        ss >> term;
+        return term;
+    }
+
+    void validate_log(const nuraft::ptr< nuraft::log_entry >& le, int64_t lsn) {
+        ASSERT_EQ(le->get_term(), expected_term(lsn)) << "Term mismatch at lsn=" << lsn;
 
         nuraft::buffer& buf = le->get_buf();
         buf.pos(0);
@@ -19,6 +19,7 @@
 #include <sisl/utility/enum.hpp>
 #include "common/homestore_config.hpp"
 #include "common/resource_mgr.hpp"
+#include "index/wb_cache.hpp"
 #include "test_common/homestore_test_common.hpp"
 #include "test_common/range_scheduler.hpp"
 #include "btree_helpers/btree_test_helper.hpp"
@@ -62,6 +63,22 @@ void log_obj_life_counter() {
     LOGINFO("Object Life Counter\n:{}", str);
 }
 
+// Sum of a counter (or gauge) across all the instances of the metrics group, looked up by its description
+static int64_t metrics_counter(std::string const& group_name, std::string const& desc) {
+    auto const j = sisl::MetricsFarm::getInstance().get_result_in_json();
+    int64_t total{0};
+    if (!j.contains(group_name)) { return total; }
+    for (auto const& [inst, group] : j[group_name].items()) {
+        for (auto const& section : {"Counters", "Gauges"}) {
+            if (!group.contains(section)) { continue; }
+            for (auto const& [name, val] : group[section].items()) {
+                if (name.find(desc) != std::string::npos) { total += val.get< int64_t >(); }
+            }
+        }
+    }
+    return total;
+}
+
 template < typename TestType >
 struct BtreeTest : public BtreeTestHelper< TestType >, public ::testing::Test {
     using T = TestType;
@@ -136,8 +153,8 @@ struct BtreeTest : public BtreeTestHelper< TestType >, public ::testing::Test {
     test_common::HSTestHelper m_helper;
 };
 
-using BtreeTypes =
-    testing::Types< FixedLenBtree, PrefixIntervalBtree, VarKeySizeBtree, VarValueSizeBtree, VarObjSizeBtree >;
+using BtreeTypes = testing::Types< FixedLenBtree, PrefixIntervalBtree, VarKeySizeBtree, VarValueSizeBtree,
+                                   VarObjSizeBtree, VarPrefixBtree >;
 
 TYPED_TEST_SUITE(BtreeTest, BtreeTypes);
 
@@ -228,6 +245,36 @@ TYPED_TEST(BtreeTest, TriggerCacheEviction) {
     LOGINFO("TriggerCacheEviction test end");
 }
 
+TYPED_TEST(BtreeTest, PrefetchInFlightShutdown) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Do insert for {} entries and flush them", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+
+    // Queries on a cold cache read ahead the nodes, shutdown and destroy can't wait on those reads through the
+    // request itself, so they have to be waited for on their own
+    LOGINFO("Step 2: Restart and shutdown with read ahead in flight");
+    this->restart_homestore();
+    this->query_all_paginate(10);
+    this->restart_homestore();
+    this->get_all();
+
+    LOGINFO("Step 3: Destroy the table with read ahead in flight");
+    this->restart_homestore();
+    this->query_all_paginate(10);
+    hs()->index_service().remove_index_table(this->m_bt);
+    ASSERT_EQ(this->m_bt->destroy(), btree_status_t::success);
+    this->m_bt.reset();
+    this->m_shadow_map.range_erase(0, num_entries - 1);
+
+    auto uuid = boost::uuids::random_generator()();
+    auto parent_uuid = boost::uuids::random_generator()();
+    this->m_bt = std::make_shared< typename TypeParam::BtreeType >(uuid, parent_uuid, 0, this->m_cfg);
+    hs()->index_service().add_index_table(this->m_bt);
+}
+
 TYPED_TEST(BtreeTest, SequentialRemove) {
     LOGINFO("SequentialRemove test start");
     // Forward sequential insert
@@ -284,6 +331,70 @@ TYPED_TEST(BtreeTest, RandomRemove) {
     this->get_all();
 }
 
+TYPED_TEST(BtreeTest, MultiPutRemove) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    static constexpr uint32_t batch_size = 128;
+
+    std::vector< uint64_t > vec(num_entries);
+    iota(vec.begin(), vec.end(), 0);
+    std::random_device rd;
+    std::mt19937 g(rd());
+    std::shuffle(vec.begin(), vec.end(), g);
+
+    LOGINFO("Step 1: Do multi put insert of first half of {} entries in batches of {}", num_entries, batch_size);
+    for (uint32_t i{0}; i < num_entries / 2; i += batch_size) {
+        auto const end = std::min(i + batch_size, num_entries / 2);
+        this->multi_put(std::vector< uint64_t >(vec.begin() + i, vec.begin() + end), btree_put_type::INSERT);
+    }
+    this->get_all();
+
+    LOGINFO("Step 2: Do multi put insert of all entries, only the second half should succeed");
+    for (uint32_t i{0}; i < num_entries; i += batch_size) {
+        auto const end = std::min(i + batch_size, num_entries);
+        this->multi_put(std::vector< uint64_t >(vec.begin() + i, vec.begin() + end), btree_put_type::INSERT);
+    }
+    this->get_all();
+
+    LOGINFO("Step 3: Do multi put update of random batches");
+    std::shuffle(vec.begin(), vec.end(), g);
+    for (uint32_t i{0}; i < num_entries; i += batch_size * 4) {
+        auto const end = std::min(i + batch_size, num_entries);
+        this->multi_put(std::vector< uint64_t >(vec.begin() + i, vec.begin() + end), btree_put_type::UPDATE);
+    }
+
+    LOGINFO("Step 4: Do multi remove of all entries along with non existing keys");
+    std::shuffle(vec.begin(), vec.end(), g);
+    for (uint32_t i{0}; i < num_entries; i += batch_size) {
+        auto const end = std::min(i + batch_size, num_entries);
+        std::vector< uint64_t > keys(vec.begin() + i, vec.begin() + end);
+        keys.push_back(num_entries + i);
+        this->multi_remove(keys);
+    }
+    this->get_all();
+}
+
+TYPED_TEST(BtreeTest, CursorScan) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+
+    LOGINFO("Step 1: Insert every other key upto {}", num_entries);
+    for (uint32_t i{0}; i < num_entries; i += 2) {
+        this->put(i, btree_put_type::INSERT);
+    }
+
+    LOGINFO("Step 2: Scan the whole tree and few sub ranges forward, backward and with seeks");
+    this->do_cursor_scan(0, num_entries - 1);
+    this->do_cursor_scan(1, num_entries / 3);
+    this->do_cursor_scan(num_entries / 2, num_entries / 2 + 1);
+    this->do_cursor_scan(num_entries + 1, num_entries + 100);
+
+    LOGINFO("Step 3: Remove a contiguous chunk of keys so that some leaves go empty and scan across them");
+    for (uint32_t i{num_entries / 4}; i < num_entries / 2; ++i) {
+        this->remove_one(i, false /* care_success */);
+    }
+    this->do_cursor_scan(0, num_entries - 1);
+    this->do_cursor_scan(num_entries / 4, num_entries / 2);
+}
+
 TYPED_TEST(BtreeTest, RangeUpdate) {
     LOGINFO("RangeUpdate test start");
     // Forward sequential insert
@@ -345,6 +456,344 @@ TYPED_TEST(BtreeTest, CpFlush) {
     LOGINFO("CpFlush test end");
 }
 
+TYPED_TEST(BtreeTest, RemoveRangeDropSubtrees) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+
+    LOGINFO("Step 0: Replace the btree with one configured to drop the subtrees covered by a range remove");
+    hs()->index_service().remove_index_table(this->m_bt);
+    ASSERT_EQ(this->m_bt->destroy(), btree_status_t::success);
+    this->m_cfg.m_drop_subtrees = true;
+    this->m_bt = std::make_shared< typename TypeParam::BtreeType >(
+        boost::uuids::random_generator()(), boost::uuids::random_generator()(), 0, this->m_cfg);
+    hs()->index_service().add_index_table(this->m_bt);
+
+    LOGINFO("Step 1: Do forward sequential insert for {} entries and flush them", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+
+    LOGINFO("Step 2: Remove a range which spans many subtrees, which index tables remove key by key anyway");
+    this->range_remove_existing(num_entries / 10, num_entries * 8 / 10);
+    ASSERT_EQ(this->m_bt->get_metrics_in_json()
+                  .at("Counters")
+                  .at("Total number of subtrees dropped whole by range removes")
+                  .get< uint64_t >(),
+              0u)
+        << "Index table dropped subtrees, whose frees are not journaled";
+    this->do_query(0, num_entries - 1, 75);
+    this->get_all();
+
+    LOGINFO("Step 3: Trigger checkpoint flush, restart homestore and validate the recovered btree");
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->dump_to_file(std::string("before.txt"));
+    this->destroy_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    this->dump_to_file(std::string("after.txt"));
+    this->do_query(0, num_entries - 1, 1000);
+    this->compare_files("before.txt", "after.txt");
+}
+
+TYPED_TEST(BtreeTest, LazyMerge) {
+    LOGINFO("Step 0: Replace the btree with one which merges the underfull nodes lazily");
+    hs()->index_service().remove_index_table(this->m_bt);
+    ASSERT_EQ(this->m_bt->destroy(), btree_status_t::success);
+    this->m_cfg.m_lazy_merge = true;
+    this->m_bt = std::make_shared< typename TypeParam::BtreeType >(
+        boost::uuids::random_generator()(), boost::uuids::random_generator()(), 0, this->m_cfg);
+    hs()->index_service().add_index_table(this->m_bt);
+
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Insert entries till the root has a few leaves under it and flush them");
+    uint32_t n{0};
+    while ((n < num_entries) && (this->m_bt->compute_node_count().second < 4)) {
+        this->put(n++, btree_put_type::INSERT);
+    }
+    ASSERT_EQ(this->m_bt->get_btree_depth(), 1);
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+
+    LOGINFO("Step 2: Remove all but the first entry, which leaves the leaves underfull");
+    for (uint32_t i{1}; i < n; ++i) {
+        this->remove_one(i);
+    }
+
+    LOGINFO("Step 3: Merge all the candidates, the root is collapsed once its leaves are merged into one");
+    while (this->m_bt->num_merge_candidates() != 0) {
+        this->m_bt->merge_underfull_nodes(100);
+    }
+    ASSERT_EQ(this->m_bt->get_btree_depth(), 0) << "Root is not collapsed after all its children are merged";
+    this->get_all();
+    this->query_all();
+
+    LOGINFO("Step 4: Trigger checkpoint flush, restart homestore and validate the recovered btree");
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->restart_homestore();
+    auto const [interior, leaf] = this->m_bt->compute_node_count();
+    ASSERT_EQ(interior, 0) << "Collapsed root is not recovered";
+    ASSERT_EQ(leaf, 1);
+    this->get_all();
+    this->query_all();
+
+    LOGINFO("Step 5: Insert the removed entries again");
+    for (uint32_t i{1}; i < n; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    this->query_all();
+}
+
+TYPED_TEST(BtreeTest, BulkLoad) {
+    using K = typename TestFixture::K;
+    using V = typename TestFixture::V;
+    LOGINFO("BulkLoad test start");
+
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    std::vector< std::pair< K, V > > kvs;
+    kvs.reserve(num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        kvs.emplace_back(K{i}, V::generate_rand());
+        this->m_shadow_map.force_put(kvs.back().first, kvs.back().second);
+    }
+
+    LOGINFO("Step 1: Bulk load of entries which are out of order in the middle should fail and leave the btree empty");
+    std::swap(kvs[num_entries * 3 / 4], kvs[num_entries * 3 / 4 + 1]);
+    ASSERT_EQ(this->m_bt->bulk_load(kvs.begin(), kvs.end(), 80), btree_status_t::not_supported);
+    ASSERT_EQ(this->m_bt->count_keys(this->m_bt->root_node_id()), 0u) << "Failed bulk load left keys in the btree";
+    ASSERT_EQ(this->m_bt->get_btree_depth(), 0u);
+    std::swap(kvs[num_entries * 3 / 4], kvs[num_entries * 3 / 4 + 1]);
+
+    LOGINFO("Step 2: Retry the bulk load of {} sorted entries with 80% fill", num_entries);
+    ASSERT_EQ(this->m_bt->bulk_load(kvs.begin(), kvs.end(), 80), btree_status_t::success);
+
+    LOGINFO("Step 3: Query all entries and validate with pagination of 80 entries");
+    this->query_all_paginate(80);
+    this->get_all();
+
+    LOGINFO("Step 4: Bulk load on a non empty btree should fail");
+    ASSERT_EQ(this->m_bt->bulk_load(kvs.begin(), kvs.end()), btree_status_t::not_supported);
+
+    LOGINFO("Step 5: Remove and reinsert some of the entries on the bulk loaded btree");
+    for (uint32_t i{0}; i < num_entries; i += 7) {
+        this->remove_one(i);
+    }
+    for (uint32_t i{0}; i < num_entries; i += 14) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    this->do_query(0, num_entries - 1, 75);
+
+    LOGINFO("Step 6: Trigger checkpoint flush, restart homestore and validate the recovered btree");
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->dump_to_file(std::string("before.txt"));
+    this->destroy_btree();
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    this->dump_to_file(std::string("after.txt"));
+    this->do_query(0, num_entries - 1, 1000);
+    this->compare_files("before.txt", "after.txt");
+    LOGINFO("BulkLoad test end");
+}
+
+TYPED_TEST(BtreeTest, BulkLoadLarge) {
+    using K = typename TestFixture::K;
+    using V = typename TestFixture::V;
+    LOGINFO("BulkLoadLarge test start");
+
+    // Sparse fill makes the load create a lot more nodes than one txn record can hold, all of which are installed in
+    // the cp the load started in, while the cps triggered in the meantime wait for it
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    std::vector< std::pair< K, V > > kvs;
+    kvs.reserve(num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        kvs.emplace_back(K{i}, V::generate_rand());
+        this->m_shadow_map.force_put(kvs.back().first, kvs.back().second);
+    }
+
+    LOGINFO("Step 1: Bulk load {} sorted entries with 5% fill, while cps are being taken", num_entries);
+    std::atomic< bool > stop_cp{false};
+    std::thread cp_thread([&stop_cp]() {
+        while (!stop_cp.load()) {
+            test_common::HSTestHelper::trigger_cp(true /* wait */);
+            std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        }
+    });
+    auto const ret = this->m_bt->bulk_load(kvs.begin(), kvs.end(), 5);
+    stop_cp = true;
+    cp_thread.join();
+    ASSERT_EQ(ret, btree_status_t::success);
+
+    auto const [interior, leaf] = this->m_bt->compute_node_count();
+    LOGINFO("Bulk loaded btree has interior={} leaf={} nodes, depth={}", interior, leaf, this->m_bt->get_btree_depth());
+    ASSERT_GT(interior + leaf, 255u) << "Bulk load is expected to create more nodes than a txn record can hold";
+
+    LOGINFO("Step 2: Query all entries and validate with pagination of 80 entries");
+    this->get_all();
+    this->query_all_paginate(80);
+
+    LOGINFO("Step 3: Trigger checkpoint flush, restart homestore and validate the recovered btree");
+    test_common::HSTestHelper::trigger_cp(true);
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    this->get_all();
+    LOGINFO("BulkLoadLarge test end");
+}
+
+TYPED_TEST(BtreeTest, BloomFilter) {
+    // Keys of range puts are not added to the filter, so it is not used by the interval btree
+    if constexpr (std::is_same_v< TypeParam, PrefixIntervalBtree >) { return; }
+
+    LOGINFO("Step 1: Replace the btree with one which filters point lookups");
+    hs()->index_service().remove_index_table(this->m_bt);
+    ASSERT_EQ(this->m_bt->destroy(), btree_status_t::success);
+    this->m_bt.reset();
+    this->m_cfg.m_bloom_filter_size = 1024 * 1024;
+    this->m_bt = std::make_shared< typename TypeParam::BtreeType >(
+        boost::uuids::random_generator()(), boost::uuids::random_generator()(), 0, this->m_cfg);
+    hs()->index_service().add_index_table(this->m_bt);
+    ASSERT_EQ(this->m_bt->bloom_filter_size(), 1024 * 1024);
+
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 2: Insert even keys and validate lookups of all the keys");
+    for (uint32_t i{0}; i < num_entries; i += 2) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->get_specific(i);
+    }
+    ASSERT_LT(this->m_bt->bloom_filter_fpr(), 0.01);
+
+    LOGINFO("Step 3: Remove half of the keys, rebuild the filter and validate lookups of all the keys");
+    for (uint32_t i{0}; i < num_entries; i += 4) {
+        this->remove_one(i);
+    }
+    while (!this->m_bt->rebuild_bloom_filter()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->get_specific(i);
+    }
+    ASSERT_LT(this->m_bt->bloom_filter_fpr(), 0.01);
+
+    LOGINFO("Step 4: Restart homestore and validate lookups of all the keys, while and after the filter is rebuilt");
+    test_common::HSTestHelper::trigger_cp(true);
+    this->restart_homestore();
+    ASSERT_EQ(this->m_bt->bloom_filter_size(), 1024 * 1024);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->get_specific(i);
+    }
+    while (!this->m_bt->rebuild_bloom_filter()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->get_specific(i);
+    }
+    ASSERT_LT(this->m_bt->bloom_filter_fpr(), 0.01);
+}
+
+TYPED_TEST(BtreeTest, TrickleFlush) {
+    // Restart homestore with trickle flush of new nodes enabled
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.generic.index_trickle_flush_interval_ms = 10u;
+        HS_SETTINGS_FACTORY().save();
+    });
+    this->restart_homestore();
+
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Insert {} entries in batches, pausing in between for the trickle flush to catch up", num_entries);
+    for (uint32_t i = 0; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+        if ((i % 1000) == 999) { std::this_thread::sleep_for(std::chrono::milliseconds{50}); }
+    }
+
+    LOGINFO("Step 2: Update some of the entries, so that some of the trickle flushed nodes are rewritten by cp");
+    for (uint32_t i = 0; i < num_entries; i += 7) {
+        this->put(i, btree_put_type::UPDATE);
+    }
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    ASSERT_GT(metrics_counter("IndexWBCache", "Index nodes trickle flushed ahead of the CP"), 0)
+        << "No node was trickle flushed";
+    this->do_query(0, num_entries - 1, 1000);
+    this->dump_to_file(std::string("before.txt"));
+
+    LOGINFO("Step 3: Restart and validate the recovered btree");
+    this->restart_homestore();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    this->dump_to_file(std::string("after.txt"));
+    this->do_query(0, num_entries - 1, 1000);
+    this->compare_files("before.txt", "after.txt");
+
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.generic.index_trickle_flush_interval_ms = 0u;
+        HS_SETTINGS_FACTORY().save();
+    });
+}
+
+TYPED_TEST(BtreeTest, AdaptiveFlushQd) {
+    // Queue depth starts at cache_max_throttle_cnt, which this suite otherwise sets way above cache_max_flush_qd
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.generic.cache_max_throttle_cnt = 4u;
+        s.generic.cache_min_throttle_cnt = 4u;
+        s.generic.cache_max_flush_qd = 64u;
+        s.generic.cache_flush_target_latency_us = 10'000'000u;
+        s.generic.cache_flush_threads = 2;
+        HS_SETTINGS_FACTORY().save();
+    });
+    this->restart_homestore();
+    auto& wbc = s_cast< IndexWBCache& >(wb_cache());
+    auto const flush_qd = []() { return metrics_counter("IndexWBCache", "Queue depth of the index cp flush"); };
+    ASSERT_EQ(flush_qd(), 4);
+
+    // Progress is sampled while the cp is being flushed, it can only move forward and ends at 100
+    auto const flush_and_check_progress = [&wbc]() {
+        auto fut = hs()->cp_mgr().trigger_cp_flush(true /* force */);
+        int last_pct{0};
+        while (!fut.isReady()) {
+            // It is 100 until the flush of this cp starts
+            auto const pct = wbc.cp_progress_percent();
+            ASSERT_GE(pct, 0);
+            ASSERT_LE(pct, 100);
+            if (pct != 100) {
+                ASSERT_GE(pct, last_pct) << "cp progress went backwards";
+                last_pct = pct;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds{100});
+        }
+        ASSERT_TRUE(std::move(fut).get());
+        ASSERT_EQ(wbc.cp_progress_percent(), 100);
+    };
+
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Flush with every write under the target latency, queue depth grows up to cache_max_flush_qd");
+    for (uint32_t i = 0; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    flush_and_check_progress();
+    auto const grown_qd = flush_qd();
+    ASSERT_GT(grown_qd, 4);
+    ASSERT_LE(grown_qd, 64);
+
+    LOGINFO("Step 2: Flush with every write over the target latency, queue depth shrinks down to the min");
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.generic.cache_flush_target_latency_us = 1u;
+        HS_SETTINGS_FACTORY().save();
+    });
+    for (uint32_t i = 0; i < num_entries; ++i) {
+        this->put(i, btree_put_type::UPDATE);
+    }
+    flush_and_check_progress();
+    auto const shrunk_qd = flush_qd();
+    ASSERT_LT(shrunk_qd, grown_qd);
+    ASSERT_GE(shrunk_qd, 4);
+    this->get_all();
+
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.generic.cache_max_throttle_cnt = 10000u;
+        s.generic.cache_max_flush_qd = 256u;
+        s.generic.cache_flush_target_latency_us = 0u;
+        s.generic.cache_flush_threads = 1;
+        HS_SETTINGS_FACTORY().save();
+    });
+}
+
 TYPED_TEST(BtreeTest, MultipleCpFlush) {
     LOGINFO("MultipleCpFlush test start");
 
@@ -562,6 +1011,24 @@ TYPED_TEST(BtreeConcurrentTest, ConcurrentAllOps) {
     this->multi_op_execute(ops, !SISL_OPTIONS["init_device"].as< bool >());
 }
 
+TYPED_TEST(BtreeConcurrentTest, ConcurrentGetRemoveMerge) {
+    // Small cache, so that lookups without node locks keep missing the cache while removes merge and free nodes
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.resource_limits.cache_size_percent = 1u;
+        HS_SETTINGS_FACTORY().save();
+    });
+    this->restart_homestore();
+
+    std::vector< std::string > input_ops = {"put:25", "remove:35", "range_remove:5", "get:35"};
+    this->multi_op_execute(this->build_op_list(input_ops));
+    this->get_all();
+
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.resource_limits.cache_size_percent = 65u;
+        HS_SETTINGS_FACTORY().save();
+    });
+}
+
 int main(int argc, char* argv[]) {
     int parsed_argc{argc};
     ::testing::InitGoogleTest(&parsed_argc, argv);
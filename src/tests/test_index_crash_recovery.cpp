@@ -285,6 +285,10 @@ struct IndexCrashTest : public test_common::HSTestHelper, BtreeTestHelper< TestT
             m_test->m_cfg.m_int_node_type = T::interior_node_type;
             m_test->m_cfg.m_max_keys_in_node = SISL_OPTIONS["max_keys_in_node"].as< uint32_t >();
             m_test->m_cfg.m_min_keys_in_node = SISL_OPTIONS["min_keys_in_node"].as< uint32_t >();
+            if (auto it = m_test->m_extra_tables.find(sb->uuid); it != m_test->m_extra_tables.end()) {
+                it->second = std::make_shared< typename T::BtreeType >(std::move(sb), m_test->m_cfg);
+                return it->second;
+            }
             m_test->m_bt = std::make_shared< typename T::BtreeType >(std::move(sb), m_test->m_cfg);
             return m_test->m_bt;
         }
@@ -295,6 +299,9 @@ struct IndexCrashTest : public test_common::HSTestHelper, BtreeTestHelper< TestT
 
     IndexCrashTest() : testing::Test() { this->m_is_multi_threaded = true; }
 
+    // Tables created by a test on top of m_bt, by uuid. They are not tracked by the shadow map.
+    std::map< uuid_t, std::shared_ptr< typename T::BtreeType > > m_extra_tables;
+
     void SetUp() override {
         // Set the cp_timer_us to very high value to avoid any automatic checkpointing.
         HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
@@ -851,6 +858,188 @@ TYPED_TEST(IndexCrashTest, SplitCrash1) {
     }
 }
 
+TYPED_TEST(IndexCrashTest, BulkLoadCrash) {
+    using K = typename TestFixture::K;
+    using V = typename TestFixture::V;
+    auto const num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    this->m_shadow_map.range_erase(0, num_entries - 1);
+    this->m_shadow_map.save(this->m_shadow_filename);
+    test_common::HSTestHelper::trigger_cp(true);
+
+    std::vector< std::pair< K, V > > kvs;
+    kvs.reserve(num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        kvs.emplace_back(K{i}, V::generate_rand());
+    }
+
+    // Iterator over the kvs, which sets the crash flip and triggers the cp half way through the load
+    struct hooked_iterator {
+        typename std::vector< std::pair< K, V > >::iterator it;
+        std::function< void(size_t) > hook;
+        size_t pos{0};
+
+        std::pair< K, V > const* operator->() const { return &*it; }
+        hooked_iterator& operator++() {
+            ++it;
+            hook(++pos);
+            return *this;
+        }
+        bool operator!=(hooked_iterator const& other) const { return it != other.it; }
+    };
+
+    cp_id_t load_cp_id{-1};
+    auto const hook = [this, &load_cp_id, num_entries](size_t pos) {
+        if (pos == num_entries / 2) {
+            load_cp_id = hs()->cp_mgr().cp_guard()->id();
+            this->set_basic_flip("crash_flush_on_root");
+            test_common::HSTestHelper::trigger_cp(false);
+        }
+    };
+
+    LOGINFO("Step 1: Bulk load {} entries, triggering a cp half way through which crashes on flushing the new root",
+            num_entries);
+    ASSERT_EQ(this->m_bt->bulk_load(hooked_iterator{kvs.begin(), hook}, hooked_iterator{kvs.end(), hook}, 50),
+              btree_status_t::success);
+    ASSERT_NE(load_cp_id, -1) << "Bulk load didn't reach half way through the input";
+    ASSERT_TRUE(hs()->crash_simulator().will_crash()) << "Bulk load didn't hit the crash flip";
+
+    LOGINFO("Step 2: Crash and recover, none of the keys of the interrupted load should be there");
+    this->wait_for_crash_recovery(true);
+    ASSERT_EQ(this->tree_key_count(), 0u) << "Partially bulk loaded tree survived the crash";
+
+    LOGINFO("Step 3: Bulk load the entries again and validate the whole tree");
+    ASSERT_EQ(this->m_bt->bulk_load(kvs.begin(), kvs.end(), 50), btree_status_t::success);
+    for (auto const& [k, v] : kvs) {
+        this->m_shadow_map.force_put(k, v);
+    }
+    test_common::HSTestHelper::trigger_cp(true);
+    this->get_all();
+    ASSERT_EQ(this->m_shadow_map.size(), this->tree_key_count()) << "shadow map size and tree size mismatch";
+    this->query_all_paginate(80);
+}
+
+TYPED_TEST(IndexCrashTest, MultiTableRepairCrash) {
+    using K = typename TestFixture::K;
+    using V = typename TestFixture::V;
+    static constexpr uint32_t num_extra_tables{4};
+    auto const num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    auto const half = num_entries / 2;
+
+    // Five tables with pending repairs, repaired by fewer threads than there are tables
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.generic.index_recovery_threads = 4;
+        HS_SETTINGS_FACTORY().save();
+    });
+
+    auto const put_extra = [](auto const& bt, uint64_t k) {
+        K key{k};
+        V value = V::generate_rand();
+        auto sreq = BtreeSinglePutRequest{&key, &value, btree_put_type::UPSERT};
+        ASSERT_EQ(bt->put(sreq), btree_status_t::success) << "Upsert of key=" << k << " failed";
+    };
+    auto const exists_extra = [](auto const& bt, uint64_t k) {
+        K key{k};
+        V value;
+        auto greq = BtreeSingleGetRequest{&key, &value};
+        return bt->get(greq) == btree_status_t::success;
+    };
+
+    LOGINFO("Step 1: Create {} more index tables and flush the first half of the keys of every table", num_extra_tables);
+    for (uint32_t i{0}; i < num_extra_tables; ++i) {
+        auto bt = std::make_shared< typename TestFixture::T::BtreeType >(boost::uuids::random_generator()(),
+                                                                          boost::uuids::random_generator()(), 0,
+                                                                          this->m_cfg);
+        hs()->index_service().add_index_table(bt);
+        this->m_extra_tables[bt->uuid()] = bt;
+    }
+    for (uint32_t k{0}; k < half; ++k) {
+        this->put(k, btree_put_type::INSERT, true /* expect_success */);
+        for (auto const& [_, bt] : this->m_extra_tables) {
+            put_extra(bt, k);
+        }
+    }
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    this->m_shadow_map.save(this->m_shadow_filename);
+
+    LOGINFO("Step 2: Insert the second half into every table and crash the cp flush on a split");
+    OperationList operations;
+    for (uint32_t k{half}; k < num_entries; ++k) {
+        operations.emplace_back(k, OperationType::Put);
+        this->put(k, btree_put_type::INSERT, true /* expect_success */);
+        for (auto const& [_, bt] : this->m_extra_tables) {
+            put_extra(bt, k);
+        }
+    }
+    std::string flip = "crash_flush_on_split_at_parent";
+    this->set_basic_flip(flip);
+    this->crash_and_recover(flip, operations);
+    ASSERT_EQ(hs()->index_service().num_tables(), num_extra_tables + 1);
+
+    LOGINFO("Step 3: Every table has the flushed keys after recovery, reapply the rest and validate all keys");
+    for (auto const& [uuid, bt] : this->m_extra_tables) {
+        for (uint32_t k{0}; k < half; ++k) {
+            ASSERT_TRUE(exists_extra(bt, k)) << "Flushed key=" << k << " missing in table " << uuid;
+        }
+        for (uint32_t k{half}; k < num_entries; ++k) {
+            put_extra(bt, k);
+        }
+    }
+    test_common::HSTestHelper::trigger_cp(true /* wait */);
+    for (auto const& [uuid, bt] : this->m_extra_tables) {
+        ASSERT_EQ(bt->count_keys(bt->root_node_id()), num_entries) << "Key count mismatch in table " << uuid;
+        for (uint32_t k{0}; k < num_entries; ++k) {
+            ASSERT_TRUE(exists_extra(bt, k)) << "Key=" << k << " missing in table " << uuid;
+        }
+    }
+
+    LOGINFO("Step 4: Tables and keys survive a clean restart after the repairs");
+    this->m_shadow_map.save(this->m_shadow_filename);
+    this->restart_homestore();
+    for (auto const& [uuid, bt] : this->m_extra_tables) {
+        ASSERT_EQ(bt->count_keys(bt->root_node_id()), num_entries) << "Key count mismatch in table " << uuid;
+    }
+    this->get_all();
+}
+
+TYPED_TEST(IndexCrashTest, RangeRemoveCrash) {
+    // Index tables are asked to drop subtrees, which they must not do since the relinks and frees below the parent are
+    // not journaled
+    this->m_cfg.m_drop_subtrees = true;
+    this->reset_btree();
+
+    LOGINFO("Step 1: Populate keys and flush them");
+    auto const num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    for (auto k = 0u; k < num_entries; ++k) {
+        this->put(k, btree_put_type::INSERT, true /* expect_success */);
+    }
+    test_common::HSTestHelper::trigger_cp(true);
+    this->m_shadow_map.save(this->m_shadow_filename);
+
+    LOGINFO("Step 2: Remove a range which covers many leaves and crash the cp flush before it completes");
+    std::string flip = "crash_flush_on_merge_at_parent";
+    this->set_basic_flip(flip);
+    auto const l = num_entries / 4;
+    auto const r = num_entries * 3 / 4 - 1;
+    this->range_remove_any(l, r);
+    ASSERT_EQ(this->m_bt->get_metrics_in_json()
+                  .at("Counters")
+                  .at("Total number of subtrees dropped whole by range removes")
+                  .get< uint64_t >(),
+              0u)
+        << "Index table dropped subtrees, whose frees are not journaled";
+    OperationList ops;
+    for (auto k = l; k <= r; ++k) {
+        ops.emplace_back(k, OperationType::Remove);
+    }
+    this->crash_and_recover(flip, ops);
+
+    LOGINFO("Step 3: Keys outside the range survive a clean restart after the recovery");
+    this->m_shadow_map.save(this->m_shadow_filename);
+    this->restart_homestore();
+    this->get_all();
+    ASSERT_EQ(this->m_shadow_map.size(), this->tree_key_count()) << "shadow map size and tree size mismatch";
+}
+
 TYPED_TEST(IndexCrashTest, long_running_put_crash) {
     long_running_crash_options crash_test_options{
         .put_freq = 100,
@@ -88,6 +88,23 @@ struct VarObjSizeBtreeTest {
     static constexpr btree_node_type interior_node_type = btree_node_type::VAR_OBJECT;
 };
 
+struct VarPrefixBtreeTest {
+    using BtreeType = MemBtree< TestVarLenKey, TestVarLenValue >;
+    using KeyType = TestVarLenKey;
+    using ValueType = TestVarLenValue;
+    static constexpr btree_node_type leaf_node_type = btree_node_type::VAR_PREFIX;
+    static constexpr btree_node_type interior_node_type = btree_node_type::VAR_PREFIX;
+};
+
+// Bytewise keys let the VAR_PREFIX interior nodes keep truncated separators
+struct VarPrefixBytewiseBtreeTest {
+    using BtreeType = MemBtree< TestBytewiseKey, TestVarLenValue >;
+    using KeyType = TestBytewiseKey;
+    using ValueType = TestVarLenValue;
+    static constexpr btree_node_type leaf_node_type = btree_node_type::VAR_PREFIX;
+    static constexpr btree_node_type interior_node_type = btree_node_type::VAR_PREFIX;
+};
+
 struct PrefixIntervalBtreeTest {
     using BtreeType = MemBtree< TestIntervalKey, TestIntervalValue >;
     using KeyType = TestIntervalKey;
@@ -116,7 +133,8 @@ struct BtreeTest : public BtreeTestHelper< TestType >, public ::testing::Test {
 };
 
 using BtreeTypes = testing::Types< FixedLenBtreeTest, PrefixIntervalBtreeTest, VarKeySizeBtreeTest,
-                                   VarValueSizeBtreeTest, VarObjSizeBtreeTest >;
+                                   VarValueSizeBtreeTest, VarObjSizeBtreeTest, VarPrefixBtreeTest,
+                                   VarPrefixBytewiseBtreeTest >;
 TYPED_TEST_SUITE(BtreeTest, BtreeTypes);
 
 TYPED_TEST(BtreeTest, SequentialInsert) {
@@ -271,6 +289,98 @@ TYPED_TEST(BtreeTest, RandomRemove) {
     this->get_all();
 }
 
+TYPED_TEST(BtreeTest, MultiPutRemove) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    static constexpr uint32_t batch_size = 128;
+
+    std::vector< uint64_t > vec(num_entries);
+    iota(vec.begin(), vec.end(), 0);
+    std::random_device rd;
+    std::mt19937 g(rd());
+    std::shuffle(vec.begin(), vec.end(), g);
+
+    LOGINFO("Step 1: Do multi put insert of first half of {} entries in batches of {}", num_entries, batch_size);
+    for (uint32_t i{0}; i < num_entries / 2; i += batch_size) {
+        auto const end = std::min(i + batch_size, num_entries / 2);
+        this->multi_put(std::vector< uint64_t >(vec.begin() + i, vec.begin() + end), btree_put_type::INSERT);
+    }
+    this->get_all();
+
+    LOGINFO("Step 2: Do multi put insert of all entries, only the second half should succeed");
+    for (uint32_t i{0}; i < num_entries; i += batch_size) {
+        auto const end = std::min(i + batch_size, num_entries);
+        this->multi_put(std::vector< uint64_t >(vec.begin() + i, vec.begin() + end), btree_put_type::INSERT);
+    }
+    this->get_all();
+
+    LOGINFO("Step 3: Do multi put update of random batches");
+    std::shuffle(vec.begin(), vec.end(), g);
+    for (uint32_t i{0}; i < num_entries; i += batch_size * 4) {
+        auto const end = std::min(i + batch_size, num_entries);
+        this->multi_put(std::vector< uint64_t >(vec.begin() + i, vec.begin() + end), btree_put_type::UPDATE);
+    }
+
+    LOGINFO("Step 4: Do multi remove of all entries along with non existing keys");
+    std::shuffle(vec.begin(), vec.end(), g);
+    for (uint32_t i{0}; i < num_entries; i += batch_size) {
+        auto const end = std::min(i + batch_size, num_entries);
+        std::vector< uint64_t > keys(vec.begin() + i, vec.begin() + end);
+        keys.push_back(num_entries + i);
+        this->multi_remove(keys);
+    }
+    this->get_all();
+}
+
+TYPED_TEST(BtreeTest, CursorScan) {
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+
+    LOGINFO("Step 1: Insert every other key upto {}", num_entries);
+    for (uint32_t i{0}; i < num_entries; i += 2) {
+        this->put(i, btree_put_type::INSERT);
+    }
+
+    LOGINFO("Step 2: Scan the whole tree and few sub ranges forward, backward and with seeks");
+    this->do_cursor_scan(0, num_entries - 1);
+    this->do_cursor_scan(1, num_entries / 3);
+    this->do_cursor_scan(num_entries / 2, num_entries / 2 + 1);
+    this->do_cursor_scan(num_entries + 1, num_entries + 100);
+
+    LOGINFO("Step 3: Remove a contiguous chunk of keys so that some leaves go empty and scan across them");
+    for (uint32_t i{num_entries / 4}; i < num_entries / 2; ++i) {
+        this->remove_one(i, false /* care_success */);
+    }
+    this->do_cursor_scan(0, num_entries - 1);
+    this->do_cursor_scan(num_entries / 4, num_entries / 2);
+}
+
+TYPED_TEST(BtreeTest, SplitPolicy) {
+    this->m_cfg.m_split_policy = btree_split_policy::ADAPTIVE;
+    this->m_bt = std::make_shared< typename TypeParam::BtreeType >(this->m_cfg);
+
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Append {} entries in ascending order", num_entries / 2);
+    for (uint32_t i{num_entries / 2}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+
+    LOGINFO("Step 2: Prepend {} entries in descending order", num_entries / 2);
+    for (uint32_t i{num_entries / 2}; i > 0; --i) {
+        this->put(i - 1, btree_put_type::INSERT);
+    }
+
+    LOGINFO("Step 3: Validate all entries");
+    this->query_all();
+    this->get_all();
+
+    LOGINFO("Step 4: Sequential inserts are expected to leave the leaves nearly full");
+    auto const status = this->m_bt->get_status(2);
+    LOGINFO("Btree status: {}", status.dump());
+    ASSERT_GT(status["leaf_nodes"].template get< uint64_t >(), 4u)
+        << "Too few entries to split the leaves, run with a larger num_entries";
+    ASSERT_GT(status["leaf_fill_factor_pct"].template get< double >(), 70.0)
+        << "Leaves are not filled up beyond even split for sequential inserts";
+}
+
 TYPED_TEST(BtreeTest, RandomRemoveRange) {
     // Forward sequential insert
     const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
@@ -296,6 +406,65 @@ TYPED_TEST(BtreeTest, RandomRemoveRange) {
     this->query_all();
 }
 
+TYPED_TEST(BtreeTest, RemoveRangeDropSubtrees) {
+    this->m_cfg.m_drop_subtrees = true;
+    this->m_bt = std::make_shared< typename TestFixture::T::BtreeType >(this->m_cfg);
+
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+
+    LOGINFO("Step 1: Do forward sequential insert for {} entries", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+
+    LOGINFO("Step 2: Remove ranges which span many subtrees and validate the keys around them");
+    this->range_remove_existing(num_entries / 10, num_entries / 2);
+    this->query_all();
+    this->range_remove_existing(num_entries * 7 / 10, num_entries / 5);
+    this->query_all();
+    this->get_all();
+
+    LOGINFO("Step 3: Insert into the dropped ranges again and remove everything");
+    for (uint32_t i{num_entries / 10}; i < num_entries * 6 / 10; i += 3) {
+        this->put(i, btree_put_type::INSERT);
+    }
+    this->query_all();
+    this->range_remove_any(0, num_entries - 1);
+    this->query_all();
+    ASSERT_EQ(this->m_bt->count_keys(), 0);
+}
+
+TYPED_TEST(BtreeTest, LazyMerge) {
+    if (!this->m_cfg.m_merge_turned_on) { return; }
+    this->m_cfg.m_lazy_merge = true;
+    this->m_bt = std::make_shared< typename TestFixture::T::BtreeType >(this->m_cfg);
+
+    const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
+    LOGINFO("Step 1: Do forward sequential insert for {} entries", num_entries);
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        this->put(i, btree_put_type::INSERT);
+    }
+
+    LOGINFO("Step 2: Remove 3 out of every 4 entries, which leaves the nodes underfull");
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        if (i % 4 != 0) { this->remove_one(i); }
+    }
+    this->query_all();
+    LOGINFO("{} merge candidates recorded", this->m_bt->num_merge_candidates());
+
+    LOGINFO("Step 3: Merge all the candidates and validate");
+    while (this->m_bt->merge_next_candidate(nullptr) != btree_status_t::not_found) {}
+    ASSERT_EQ(this->m_bt->num_merge_candidates(), 0);
+    this->query_all();
+    this->get_all();
+
+    LOGINFO("Step 4: Insert the removed entries again");
+    for (uint32_t i{0}; i < num_entries; ++i) {
+        if (i % 4 != 0) { this->put(i, btree_put_type::INSERT); }
+    }
+    this->query_all();
+}
+
 TYPED_TEST(BtreeTest, SimpleTombstone) {
     const auto num_entries = SISL_OPTIONS["num_entries"].as< uint32_t >();
     LOGINFO("Step 1: Do forward sequential insert for {} entries", num_entries);
@@ -456,7 +625,8 @@ TYPED_TEST_SUITE(BtreeConcurrentTest, BtreeTypes);
 
 TYPED_TEST(BtreeConcurrentTest, ConcurrentAllOps) {
     // range put is not supported for non-extent keys
-    std::vector< std::string > input_ops = {"put:20", "remove:20", "range_put:20", "range_remove:20", "query:20"};
+    std::vector< std::string > input_ops = {"put:20",          "remove:20", "range_put:20",
+                                            "range_remove:20", "query:20",  "get:20"};
     if (SISL_OPTIONS.count("operation_list")) {
         input_ops = SISL_OPTIONS["operation_list"].as< std::vector< std::string > >();
     }
@@ -145,6 +145,69 @@ TEST_F(RaftReplDevTest, Write_With_Handling_No_Space_Left) {
     g_helper->remove_flip("simulate_no_space_left");
 }
 
+// Sum of a counter across all the RaftReplDev instances of this replica, looked up by its description
+static int64_t repl_dev_counter(std::string const& desc) {
+    auto const j = sisl::MetricsFarm::getInstance().get_result_in_json();
+    int64_t total{0};
+    if (!j.contains("RaftReplDev")) { return total; }
+    for (auto const& [inst, group] : j["RaftReplDev"].items()) {
+        if (!group.contains("Counters")) { continue; }
+        for (auto const& [name, val] : group["Counters"].items()) {
+            if (name.find(desc) != std::string::npos) { total += val.get< int64_t >(); }
+        }
+    }
+    return total;
+}
+
+TEST_F(RaftReplDevTest, Write_With_Data_Channel_Compression) {
+    LOGINFO("Homestore replica={} setup completed, enabling lz4 compression on data channel", g_helper->replica_num());
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.consensus.data_channel_compression = 1; // lz4
+        s.consensus.data_channel_compress_min_size = 0;
+    });
+    HS_SETTINGS_FACTORY().save();
+    auto const compressed_before = repl_dev_counter("data channel payloads sent compressed");
+    auto const decompress_err_before = repl_dev_counter("data channel payloads failed to decompress");
+    auto const fetch_err_before = repl_dev_counter("total fetch data error count");
+    g_helper->sync_for_test_start();
+
+    // step-1: Pushed data is compressed, test data is a repeated pattern which always compresses
+    this->write_on_leader(20, true /* wait_for_commit */);
+    auto const pushed_compressed = repl_dev_counter("data channel payloads sent compressed");
+    if (g_helper->replica_num() == 0) {
+        ASSERT_GT(pushed_compressed, compressed_before) << "Leader was expected to push compressed data";
+        ASSERT_LT(repl_dev_counter("data channel bytes after compression"),
+                  repl_dev_counter("data channel bytes before compression"))
+            << "Compressed bytes were expected to be less than the original bytes";
+    }
+
+    // step-2: Switch to zstd and drop all pushes, so that followers get compressed data through fetch
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) { s.consensus.data_channel_compression = 2; /* zstd */ });
+    HS_SETTINGS_FACTORY().save();
+    if (g_helper->replica_num() != 0) { g_helper->set_basic_flip("drop_push_data_request"); }
+    this->write_on_leader(20, true /* wait_for_commit */);
+
+    g_helper->sync_for_verify_start();
+
+    LOGINFO("Validate all data written so far by reading them");
+    this->validate_data();
+    if (g_helper->replica_num() == 0) {
+        ASSERT_GT(repl_dev_counter("data channel payloads sent compressed"), pushed_compressed)
+            << "Leader was expected to compress the fetched data as well";
+    } else {
+        ASSERT_EQ(repl_dev_counter("data channel payloads failed to decompress"), decompress_err_before);
+        ASSERT_EQ(repl_dev_counter("total fetch data error count"), fetch_err_before);
+    }
+
+    g_helper->sync_for_cleanup_start();
+    if (g_helper->replica_num() != 0) { g_helper->remove_flip("drop_push_data_request"); }
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) {
+        s.consensus.data_channel_compression = 0;
+        s.consensus.data_channel_compress_min_size = 8192;
+    });
+    HS_SETTINGS_FACTORY().save();
+}
+
 #endif
 
 // do some io before restart;
@@ -478,6 +541,55 @@ TEST_F(RaftReplDevTest, BaselineTest) {
     LOGINFO("BaselineTest done");
 }
 
+TEST_F(RaftReplDevTest, BaselineTest_With_Pipelined_Snapshot_Writes) {
+    // Same as BaselineTest, but the lagging follower writes the snapshot objects asynchronously, so the baseline resync
+    // goes through the pipelined apply path with several objects in flight.
+    LOGINFO("Homestore replica={} setup completed", g_helper->replica_num());
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) { s.consensus.snapshot_io_max_inflight_objs = 4; });
+    HS_SETTINGS_FACTORY().save();
+    if (g_helper->replica_num() == 1) { dbs_[0]->set_async_snapshot_write(true); }
+    g_helper->sync_for_test_start();
+
+    uint64_t entries_per_attempt = 50;
+    LOGINFO("Write on leader num_entries={}", entries_per_attempt);
+    this->write_on_leader(entries_per_attempt, true /* wait_for_commit */);
+
+    LOGINFO("Shutdown replica 1");
+    this->shutdown_replica(1);
+
+    // Enough entries for the baseline to span many snapshot objects (10 entries per object)
+    entries_per_attempt = std::max(SISL_OPTIONS["num_io"].as< uint64_t >(), uint64_t{200});
+    LOGINFO("Write on leader num_entries={}", entries_per_attempt);
+    if (g_helper->replica_num() == 0 || g_helper->replica_num() == 2) {
+        this->write_on_leader(entries_per_attempt, true /* wait_for_commit */);
+        this->wait_for_all_commits();
+        if (g_helper->replica_num() == 0) {
+            LOGINFO("Leader create snapshot");
+            this->create_snapshot();
+        }
+    }
+    g_helper->sync_for_verify_start();
+
+    LOGINFO("Start replica 1");
+    this->start_replica(1);
+    g_helper->sync_for_test_start();
+
+    entries_per_attempt = 50;
+    LOGINFO("Write on leader num_entries={}", entries_per_attempt);
+    this->write_on_leader(entries_per_attempt, true /* wait_for_commit */);
+    g_helper->sync_for_verify_start();
+
+    LOGINFO("Validate all data written so far by reading them");
+    this->validate_data();
+    if (g_helper->replica_num() == 1) {
+        ASSERT_GT(dbs_[0]->async_snapshot_write_count(), 0)
+            << "Baseline resync was expected to write snapshot objects asynchronously";
+        dbs_[0]->set_async_snapshot_write(false);
+    }
+    g_helper->sync_for_cleanup_start();
+    LOGINFO("BaselineTest_With_Pipelined_Snapshot_Writes done");
+}
+
 TEST_F(RaftReplDevTest, LargeDataWrite) {
     LOGINFO("Homestore replica={} setup completed", g_helper->replica_num());
     g_helper->sync_for_test_start();
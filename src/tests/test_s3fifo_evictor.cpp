@@ -0,0 +1,193 @@
+/*********************************************************************************
+ * Modifications Copyright 2017-2019 eBay Inc.
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *    https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed
+ * under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ *
+ *********************************************************************************/
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <sisl/cache/simple_cache.hpp>
+#include <sisl/logging/logging.h>
+#include <sisl/metrics/metrics.hpp>
+#include <sisl/options/options.h>
+
+#include <homestore/homestore_decl.hpp>
+#include "common/s3fifo_evictor.hpp"
+
+using namespace homestore;
+
+SISL_LOGGING_INIT(HOMESTORE_LOG_MODS)
+SISL_OPTIONS_ENABLE(logging)
+
+namespace {
+struct TestEntry {
+    uint64_t key;
+    bool dirty{false};
+};
+using TestEntryPtr = std::shared_ptr< TestEntry >;
+
+// Single partition of 10 records, of which the small queue is 2 records
+static constexpr uint32_t rec_size{4096};
+static constexpr uint32_t max_records{10};
+static constexpr uint32_t small_queue_pct{20};
+} // namespace
+
+class S3FifoEvictorTest : public ::testing::Test {
+protected:
+    std::shared_ptr< S3FifoEvictor > m_evictor;
+    std::unique_ptr< sisl::SimpleCache< uint64_t, TestEntryPtr > > m_cache;
+
+    void SetUp() override {
+        m_evictor = std::make_shared< S3FifoEvictor >(max_records * rec_size, 1u, small_queue_pct);
+        m_cache = std::make_unique< sisl::SimpleCache< uint64_t, TestEntryPtr > >(
+            m_evictor, 64, rec_size, [](const TestEntryPtr& e) -> uint64_t { return e->key; },
+            [](const sisl::CacheRecord& rec) -> bool {
+                const auto& hnode = (sisl::SingleEntryHashNode< TestEntryPtr >&)rec;
+                return !hnode.m_value->dirty;
+            });
+    }
+
+    void TearDown() override {
+        m_cache.reset();
+        m_evictor.reset();
+    }
+
+    TestEntryPtr insert(uint64_t key, bool dirty = false) {
+        auto e = std::make_shared< TestEntry >(TestEntry{key, dirty});
+        EXPECT_TRUE(m_cache->insert(e)) << "Insert of key=" << key << " failed";
+        return e;
+    }
+
+    bool exists(uint64_t key) {
+        TestEntryPtr e;
+        return m_cache->get(key, e);
+    }
+
+    // Counter of the evictor, looked up by its description
+    static int64_t evictor_counter(std::string const& desc) {
+        auto const j = sisl::MetricsFarm::getInstance().get_result_in_json();
+        int64_t total{0};
+        if (!j.contains("S3FifoEvictor")) { return total; }
+        for (auto const& [inst, group] : j["S3FifoEvictor"].items()) {
+            if (!group.contains("Counters")) { continue; }
+            for (auto const& [name, val] : group["Counters"].items()) {
+                if (name.find(desc) != std::string::npos) { total += val.get< int64_t >(); }
+            }
+        }
+        return total;
+    }
+};
+
+TEST_F(S3FifoEvictorTest, ScanResistance) {
+    LOGINFO("Step 1: Insert the hot records and access them once while in the small queue");
+    for (uint64_t k{0}; k < 8; ++k) {
+        insert(k);
+    }
+    for (uint64_t k{0}; k < 8; ++k) {
+        ASSERT_TRUE(exists(k));
+    }
+
+    LOGINFO("Step 2: Scan over many more records than the cache holds, each accessed only on insert");
+    for (uint64_t k{100}; k < 200; ++k) {
+        insert(k);
+    }
+
+    LOGINFO("Step 3: Hot records are promoted to the main queue and only the small queue is churned");
+    EXPECT_EQ(evictor_counter("promoted from the small to the main queue"), 8);
+    EXPECT_EQ(evictor_counter("evicted from the main queue"), 0);
+    EXPECT_GT(evictor_counter("evicted from the small queue"), 90);
+    for (uint64_t k{0}; k < 8; ++k) {
+        ASSERT_TRUE(exists(k)) << "Hot key=" << k << " was evicted by the scan";
+    }
+    for (uint64_t k{100}; k < 190; ++k) {
+        ASSERT_FALSE(exists(k)) << "Scanned key=" << k << " was not evicted";
+    }
+}
+
+TEST_F(S3FifoEvictorTest, GhostReadmit) {
+    LOGINFO("Step 1: Fill the cache and evict the oldest record from the small queue");
+    for (uint64_t k{0}; k <= max_records; ++k) {
+        insert(k);
+    }
+    ASSERT_FALSE(exists(0));
+    ASSERT_EQ(evictor_counter("evicted from the small queue"), 1);
+
+    LOGINFO("Step 2: Record inserted again while in the ghost queue is admitted directly into the main queue");
+    insert(0);
+    ASSERT_EQ(evictor_counter("readmitted directly into main queue through ghost queue"), 1);
+
+    LOGINFO("Step 3: It survives a scan which evicts everything else in the small queue");
+    for (uint64_t k{100}; k < 150; ++k) {
+        insert(k);
+    }
+    ASSERT_TRUE(exists(0));
+    ASSERT_EQ(evictor_counter("evicted from the main queue"), 0);
+
+    LOGINFO("Step 4: Ghost queue is bounded, a record evicted before the scan is not readmitted into main queue");
+    insert(1);
+    ASSERT_EQ(evictor_counter("readmitted directly into main queue through ghost queue"), 1);
+}
+
+TEST_F(S3FifoEvictorTest, NonEvictableRecords) {
+    LOGINFO("Step 1: Fill the cache with dirty and clean records, none of them accessed");
+    std::vector< TestEntryPtr > dirty_entries;
+    for (uint64_t k{0}; k < max_records; ++k) {
+        auto e = insert(k, k < 5 /* dirty */);
+        if (e->dirty) { dirty_entries.push_back(e); }
+    }
+
+    LOGINFO("Step 2: Make room for more, dirty records are moved to the main queue instead of evicted");
+    for (uint64_t k{10}; k < 15; ++k) {
+        insert(k);
+    }
+    for (uint64_t k{0}; k < 5; ++k) {
+        ASSERT_TRUE(exists(k)) << "Dirty key=" << k << " was evicted";
+    }
+    for (uint64_t k{5}; k < 9; ++k) {
+        ASSERT_FALSE(exists(k)) << "Clean key=" << k << " was not evicted";
+    }
+    ASSERT_EQ(evictor_counter("evicted from the main queue"), 0);
+
+    LOGINFO("Step 3: Cache full of dirty records still admits new ones, but counts the failure to make room");
+    for (uint64_t k{20}; k < 40; ++k) {
+        dirty_entries.push_back(insert(k, true /* dirty */));
+    }
+    ASSERT_GT(evictor_counter("Records added after failing to make room for them"), 0);
+    for (uint64_t k{0}; k < 5; ++k) {
+        ASSERT_TRUE(exists(k));
+    }
+
+    LOGINFO("Step 4: Once clean, records are evicted from the main queue again");
+    for (auto& e : dirty_entries) {
+        e->dirty = false;
+    }
+    for (uint64_t k{100}; k < 200; ++k) {
+        insert(k);
+    }
+    ASSERT_GT(evictor_counter("evicted from the main queue"), 0);
+    for (uint64_t k{25}; k < 40; ++k) {
+        ASSERT_FALSE(exists(k)) << "Cleaned key=" << k << " in the small queue was not evicted";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int parsed_argc{argc};
+    ::testing::InitGoogleTest(&parsed_argc, argv);
+    SISL_OPTIONS_LOAD(parsed_argc, argv, logging);
+    sisl::logging::SetLogger("test_s3fifo_evictor");
+    spdlog::set_pattern("[%D %T%z] [%^%l%$] [%n] [%t] %v");
+
+    return RUN_ALL_TESTS();
+}
@@ -14,6 +14,8 @@
  *
  *********************************************************************************/
 #include <vector>
+#include <map>
+#include <mutex>
 #include <iostream>
 #include <filesystem>
 
@@ -95,6 +97,7 @@ public:
         void on_commit(int64_t lsn, sisl::blob const& header, sisl::blob const& key,
                        std::vector< MultiBlkId > const& blkids, cintrusive< repl_req_ctx >& ctx) override {
             LOGINFO("Received on_commit lsn={}", lsn);
+            m_test.record_commit(repl_dev()->group_id(), lsn, ctx == nullptr /* replay */);
             if (ctx == nullptr) {
                 m_test.validate_replay(*repl_dev(), lsn, header, key, blkids);
             } else {
@@ -175,6 +178,11 @@ protected:
     uuid_t m_uuid2;
     test_common::HSTestHelper m_helper;
 
+    // lsns in the order on_commit was called for them, per repl_dev, for new writes and for replay after restart
+    std::mutex m_commit_mtx;
+    std::map< group_id_t, std::vector< int64_t > > m_committed_lsns;
+    std::map< group_id_t, std::vector< int64_t > > m_replayed_lsns;
+
 public:
     virtual void SetUp() override {
         m_helper.start_homestore(
@@ -367,6 +375,19 @@ public:
         }
     }
 
+    void record_commit(group_id_t const& gid, int64_t lsn, bool replay) {
+        std::unique_lock lg{m_commit_mtx};
+        (replay ? m_replayed_lsns : m_committed_lsns)[gid].push_back(lsn);
+    }
+
+    void validate_commit_order(std::map< group_id_t, std::vector< int64_t > > const& lsns_map) {
+        for (auto const& [gid, lsns] : lsns_map) {
+            for (size_t i{1}; i < lsns.size(); ++i) {
+                ASSERT_LT(lsns[i - 1], lsns[i]) << "Commit out of lsn order on dev=" << boost::uuids::to_string(gid);
+            }
+        }
+    }
+
     void trigger_cp_flush() { homestore::hs()->cp_mgr().trigger_cp_flush(true /* force */).get(); }
     void truncate_and_verify(shared< ReplDev > repl_dev) {
         auto solo_dev = std::dynamic_pointer_cast< SoloReplDev >(repl_dev);
@@ -441,6 +462,41 @@ TEST_F(SoloReplDevTest, TestAsyncWriteJournal) {
     this->m_task_waiter.start([this]() { this->restart(); }).get();
 }
 
+TEST_F(SoloReplDevTest, TestGroupCommit) {
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) { s.generic.solo_repl_dev_max_batch_size = 16; });
+    HS_SETTINGS_FACTORY().save();
+
+    LOGINFO("Step 1: run on worker threads to schedule writes through group commit");
+    this->m_io_runner.set_task([this]() {
+        uint32_t nblks = rand() % ((128 * Ki) / g_block_size) + 1;
+        uint32_t key_size = rand() % 512 + 8;
+        this->write_io(key_size, nblks * g_block_size, g_block_size);
+    });
+    this->m_io_runner.execute().get();
+
+    LOGINFO("Step 2: Validate that every write got committed in lsn order");
+    {
+        std::unique_lock lg{m_commit_mtx};
+        validate_commit_order(m_committed_lsns);
+        size_t num_committed{0};
+        for (auto const& [_, lsns] : m_committed_lsns) {
+            num_committed += lsns.size();
+        }
+        ASSERT_EQ(num_committed, SISL_OPTIONS["num_io"].as< uint64_t >());
+    }
+
+    LOGINFO("Step 3: Restart homestore and validate that every committed write is replayed in order");
+    this->m_task_waiter.start([this]() { this->restart(); }).get();
+    {
+        std::unique_lock lg{m_commit_mtx};
+        validate_commit_order(m_replayed_lsns);
+        ASSERT_EQ(m_replayed_lsns, m_committed_lsns) << "Committed writes missing after restart";
+    }
+
+    HS_SETTINGS_FACTORY().modifiable_settings([](auto& s) { s.generic.solo_repl_dev_max_batch_size = 0; });
+    HS_SETTINGS_FACTORY().save();
+}
+
 #ifdef _PRERELEASE
 TEST_F(SoloReplDevTest, TestTruncate) {
     // Write and truncate on repl dev.